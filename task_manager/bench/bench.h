@@ -0,0 +1,145 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <string>
+#include <cstddef>
+#include <chrono>
+#include <functional>
+#include <vector>
+#include "task.h"
+
+// --- Shared helpers for the task_manager benchmarks ---
+// Every benchmark reports one JSON object per line on stdout so results can be
+// diffed or loaded into a spreadsheet between releases
+
+/**
+ * \@brief Runs a callable repeatedly and returns the best wall time of a single run
+ * Taking the minimum filters out noise from other processes on the machine
+ * \@param iterations How many times to run the callable
+ * \@param fn The work to measure
+ * \@return The fastest run, in seconds
+ */
+double timeBest(int iterations, const std::function<void()>& fn);
+
+/**
+ * \@brief Prints one benchmark result as a single JSON line
+ * \@param name Identifier of the benchmark (stable between releases)
+ * \@param tasks Size of the task list the benchmark ran against
+ * \@param operations Number of operations in one run (tasks parsed, lookups, ...)
+ * \@param iterations Number of runs the timing was taken over
+ * \@param seconds Best wall time of one run
+ */
+void reportResult(const std::string& name, size_t tasks, size_t operations, int iterations, double seconds);
+
+/**
+ * \@brief Writes a synthetic tasks.json with realistic descriptions
+ * The content is deterministic for a given count so runs are comparable
+ * \@param path Where to write the file
+ * \@param count Number of tasks to generate
+ */
+void writeSyntheticTasksFile(const std::string& path, size_t count);
+
+/**
+ * \@brief Builds synthetic tasks in memory (ids 1..count, same content as the file generator)
+ * \@param count Number of tasks to generate
+ * \@return The tasks, in id order
+ */
+std::vector<Task> makeSyntheticTasks(size_t count);
+
+/**
+ * \@brief Creates a fresh scratch directory and makes it the working directory
+ * task-cli always operates on ./tasks.json, so benchmarks run from inside it
+ * \@return The path of the directory
+ */
+std::string enterScratchDirectory();
+
+/**
+ * \@brief Deletes the files in a scratch directory and the directory itself
+ * \@param path The directory returned by enterScratchDirectory
+ */
+void removeScratchDirectory(const std::string& path);
+
+/**
+ * \@brief Silences std::cout/std::cerr for the lifetime of the object
+ * loadTasks and friends print progress messages that would drown the results
+ */
+class QuietOutput {
+public:
+    QuietOutput();
+    ~QuietOutput();
+private:
+    std::streambuf* savedOut;
+    std::streambuf* savedErr;
+};
+
+// --- Benchmark suites ---
+
+/**
+ * \@brief Compares the single-pass loader with the original stringstream-based loader
+ * \@param count Number of tasks in the generated file
+ */
+void runParseBenchmarks(size_t count);
+
+/**
+ * \@brief Measures per-command lookup cost: id index vs the original linear scan
+ * \@param count Number of tasks in the list
+ */
+void runIndexBenchmarks(size_t count);
+
+/**
+ * \@brief Measures full-text search: inverted index vs a linear substring scan
+ * \@param count Number of tasks in the list
+ */
+void runSearchBenchmarks(size_t count);
+
+/**
+ * \@brief Measures list output: per-line flushes vs the buffered writer, the first page of a sorted list,
+ * and a --where query driven by an index vs one that has to scan
+ * \@param count Number of tasks in the list
+ */
+void runListBenchmarks(size_t count);
+
+/**
+ * \@brief Compares full scans over TaskList (records) and TaskTable (columns + arena)
+ * \@param count Number of tasks in the list
+ */
+void runTableBenchmarks(size_t count);
+
+/**
+ * \@brief Measures snapshot saves, binary loads, single-change commits, generateNextId, deleteTask and deleteTasks
+ * \@param count Number of tasks in the list
+ */
+void runStorageBenchmarks(size_t count);
+
+/**
+ * \@brief Measures the LSM store: single-task inserts against rewriting tasks.json, point reads and loads
+ * \@param count Number of tasks in the list
+ */
+void runLsmBenchmarks(size_t count);
+
+/**
+ * \@brief Measures recovery time against the amount of log written since the last checkpoint,
+ * and checks that a damaged checkpoint is rebuilt with every committed change
+ * \@param count Number of tasks in the list
+ */
+void runRecoveryBenchmarks(size_t count);
+
+/**
+ * \@brief Measures export to NDJSON and CSV, and importing the exported files back
+ * \@param count Number of tasks in the list
+ */
+void runTransferBenchmarks(size_t count);
+
+/**
+ * \@brief Compares the hand-rolled timestamp codec with the original iostream path
+ * \@param count Number of timestamps to format and parse
+ */
+void runTimestampBenchmarks(size_t count);
+
+/**
+ * \@brief Compares the vectorized JSON escaper/decoder with the original code
+ * \@param count Number of short descriptions (a sixty-fourth as many long ones)
+ */
+void runJsonBenchmarks(size_t count);
+
+#endif // BENCH_H
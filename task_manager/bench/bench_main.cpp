@@ -0,0 +1,62 @@
+#include "bench.h"
+#include <iostream>
+#include <string>
+#include <vector>
+#include <stdexcept>
+
+// Entry point for the task_manager benchmarks
+// Usage: task-bench [task counts...]             (default: 1000 100000 1000000)
+//        task-bench --generate <count> [path]    (write a synthetic tasks.json and exit)
+// Results go to stdout as one JSON object per line; see reportResult in bench.h
+int main(int argc, char* argv[]) {
+    std::vector<size_t> counts;
+    try {
+        if (argc >= 2 && std::string(argv[1]) == "--generate") {
+            if (argc < 3 || argc > 4) {
+                throw std::invalid_argument("--generate");
+            }
+            size_t count = static_cast<size_t>(std::stoul(argv[2]));
+            writeSyntheticTasksFile(argc == 4 ? argv[3] : "tasks.json", count);
+            return 0;
+        }
+        for (int i = 1; i < argc; ++i) {
+            counts.push_back(static_cast<size_t>(std::stoul(argv[i])));
+        }
+    } catch (const std::invalid_argument&) {
+        std::cerr << "Usage: " << argv[0] << " [task counts...]" << std::endl;
+        std::cerr << "       " << argv[0] << " --generate <count> [path]" << std::endl;
+        return 1;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    if (counts.empty()) {
+        counts = { 1000, 100000, 1000000 };
+    }
+
+    std::string scratch;
+    int status = 0;
+    try {
+        scratch = enterScratchDirectory();
+        for (size_t count : counts) {
+            runParseBenchmarks(count);
+            runStorageBenchmarks(count);
+            runLsmBenchmarks(count);
+            runRecoveryBenchmarks(count);
+            runIndexBenchmarks(count);
+            runSearchBenchmarks(count);
+            runListBenchmarks(count);
+            runTableBenchmarks(count);
+            runTransferBenchmarks(count);
+        }
+        runTimestampBenchmarks(1000000);
+        runJsonBenchmarks(1000000);
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        status = 1;
+    }
+    if (!scratch.empty()) {
+        removeScratchDirectory(scratch);
+    }
+    return status;
+}
@@ -0,0 +1,175 @@
+#include "bench.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <random>
+#include <stdexcept>
+#include <cstdio> // For std::snprintf
+#include <cstdlib> // For mkdtemp
+#include <unistd.h> // For chdir, rmdir
+#include <dirent.h> // For opendir, readdir
+
+/**
+ * \@brief Runs a callable repeatedly and returns the best wall time of a single run
+ * \@param iterations How many times to run the callable
+ * \@param fn The work to measure
+ * \@return The fastest run, in seconds
+ */
+double timeBest(int iterations, const std::function<void()>& fn) {
+    double best = 0.0;
+    for (int i = 0; i < iterations; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        fn();
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        if (i == 0 || elapsed.count() < best) {
+            best = elapsed.count();
+        }
+    }
+    return best;
+}
+
+/**
+ * \@brief Prints one benchmark result as a single JSON line
+ * \@param name Identifier of the benchmark (stable between releases)
+ * \@param tasks Size of the task list the benchmark ran against
+ * \@param operations Number of operations in one run
+ * \@param iterations Number of runs the timing was taken over
+ * \@param seconds Best wall time of one run
+ */
+void reportResult(const std::string& name, size_t tasks, size_t operations, int iterations, double seconds) {
+    char line[320];
+    std::snprintf(line, sizeof(line),
+                  "{\"benchmark\": \"%s\", \"tasks\": %zu, \"operations\": %zu, \"iterations\": %d, \"seconds\": %.6f, \"ns_per_op\": %.1f}",
+                  name.c_str(), tasks, operations, iterations, seconds,
+                  operations > 0 ? seconds * 1e9 / static_cast<double>(operations) : 0.0);
+    std::cout << line << std::endl;
+}
+
+/**
+ * \@brief Writes a synthetic tasks.json with realistic descriptions
+ * Descriptions are 3-30 words drawn from a small vocabulary, which gives
+ * lengths between roughly 15 and 250 characters like hand-written tasks
+ * \@param path Where to write the file
+ * \@param count Number of tasks to generate
+ */
+void writeSyntheticTasksFile(const std::string& path, size_t count) {
+    static const char* const words[] = {
+        "fix", "deploy", "review", "the", "login", "page", "update", "docs", "for", "release",
+        "investigate", "flaky", "test", "in", "ci", "pipeline", "refactor", "storage", "layer", "and",
+        "write", "migration", "script", "customer", "report", "\"urgent\"", "backlog", "cleanup", "api", "timeout"
+    };
+    const size_t wordCount = sizeof(words) / sizeof(words[0]);
+    static const char* const statuses[] = { "todo", "in-progress", "done" };
+
+    std::mt19937 rng(42); // Fixed seed: identical files for identical counts
+    std::uniform_int_distribution<int> lengthDist(3, 30);
+    std::uniform_int_distribution<size_t> wordDist(0, wordCount - 1);
+    std::uniform_int_distribution<int> statusDist(0, 2);
+
+    std::ofstream out(path, std::ios::binary);
+    if (!out.is_open()) {
+        throw std::runtime_error("cannot write " + path);
+    }
+    std::string buffer;
+    buffer.reserve(1 << 20);
+    buffer += "[\n";
+    char stamp[32];
+    for (size_t i = 0; i < count; ++i) {
+        // Spread creation times over about a year, one task every few minutes
+        long long offset = static_cast<long long>(i) * 300;
+        int day = static_cast<int>(offset / 86400) % 28 + 1;
+        int month = static_cast<int>(offset / (86400 * 28)) % 12 + 1;
+        int hour = static_cast<int>(offset / 3600) % 24;
+        int minute = static_cast<int>(offset / 60) % 60;
+        std::snprintf(stamp, sizeof(stamp), "2025-%02d-%02d %02d:%02d:00", month, day, hour, minute);
+
+        buffer += " {\n   \"id\": ";
+        buffer += std::to_string(i + 1);
+        buffer += ",\n   \"description\": \"";
+        int length = lengthDist(rng);
+        for (int w = 0; w < length; ++w) {
+            if (w > 0) {
+                buffer += ' ';
+            }
+            for (const char* c = words[wordDist(rng)]; *c; ++c) {
+                if (*c == '"') {
+                    buffer += '\\';
+                }
+                buffer += *c;
+            }
+        }
+        buffer += "\",\n   \"status\": \"";
+        buffer += statuses[statusDist(rng)];
+        buffer += "\",\n   \"createdAt\": \"";
+        buffer += stamp;
+        buffer += "\",\n   \"updatedAt\": \"";
+        buffer += stamp;
+        buffer += "\"\n }";
+        buffer += (i + 1 < count) ? ",\n" : "\n";
+        if (buffer.size() > (1 << 20) - 4096) {
+            out.write(buffer.data(), buffer.size());
+            buffer.clear();
+        }
+    }
+    buffer += "]\n";
+    out.write(buffer.data(), buffer.size());
+}
+
+/**
+ * \@brief Builds synthetic tasks in memory (ids 1..count)
+ * \@param count Number of tasks to generate
+ * \@return The tasks, in id order
+ */
+std::vector<Task> makeSyntheticTasks(size_t count) {
+    std::vector<Task> tasks;
+    tasks.reserve(count);
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> lengthDist(15, 250);
+    std::uniform_int_distribution<int> statusDist(0, 2);
+    auto start = std::chrono::system_clock::from_time_t(1735689600); // 2025-01-01
+    for (size_t i = 0; i < count; ++i) {
+        auto created = start + std::chrono::seconds(300 * static_cast<long long>(i));
+        std::string description(static_cast<size_t>(lengthDist(rng)), 'x');
+        tasks.emplace_back(static_cast<int>(i + 1), std::move(description),
+                           static_cast<TaskStatus>(statusDist(rng)), created, created);
+    }
+    return tasks;
+}
+
+/**
+ * \@brief Creates a fresh scratch directory and makes it the working directory
+ * \@return The path of the directory
+ */
+std::string enterScratchDirectory() {
+    char pattern[] = "/tmp/task-bench-XXXXXX";
+    if (mkdtemp(pattern) == nullptr || chdir(pattern) != 0) {
+        throw std::runtime_error("cannot create scratch directory");
+    }
+    return pattern;
+}
+
+/**
+ * \@brief Deletes the files in a scratch directory and the directory itself
+ * \@param path The directory returned by enterScratchDirectory
+ */
+void removeScratchDirectory(const std::string& path) {
+    if (DIR* dir = opendir(path.c_str())) {
+        while (dirent* entry = readdir(dir)) {
+            std::string name = entry->d_name;
+            if (name != "." && name != "..") {
+                std::remove((path + "/" + name).c_str());
+            }
+        }
+        closedir(dir);
+    }
+    rmdir(path.c_str());
+}
+
+QuietOutput::QuietOutput()
+    : savedOut(std::cout.rdbuf(nullptr)), savedErr(std::cerr.rdbuf(nullptr)) {}
+
+QuietOutput::~QuietOutput() {
+    std::cout.rdbuf(savedOut);
+    std::cerr.rdbuf(savedErr);
+}
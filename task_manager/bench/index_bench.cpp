@@ -0,0 +1,72 @@
+#include "bench.h"
+#include "commands.h"
+#include "task_list.h"
+#include <algorithm> // For std::find_if
+#include <random>
+#include <vector>
+
+/**
+ * \@brief Measures per-command lookup cost: id index vs the original linear scan
+ * Each run performs the same number of operations on random ids, so with the
+ * index the reported ns_per_op should stay flat as the task count grows
+ * \@param count Number of tasks in the list
+ */
+void runIndexBenchmarks(size_t count) {
+    const size_t operations = 2000;
+    const int iterations = 3;
+    std::vector<Task> vector = makeSyntheticTasks(count);
+    TaskList tasks(vector);
+
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<int> idDist(1, static_cast<int>(count));
+    std::vector<int> ids(operations);
+    for (auto& id : ids) {
+        id = idDist(rng);
+    }
+
+    // Original findTaskById: std::find_if over the whole vector
+    long long checksum = 0;
+    double seconds = timeBest(iterations, [&]() {
+        for (int id : ids) {
+            auto it = std::find_if(vector.begin(), vector.end(), [id](const Task& task) { return task.id == id; });
+            checksum += it->id;
+        }
+    });
+    reportResult("find_task_by_id_linear", count, operations, iterations, seconds);
+
+    seconds = timeBest(iterations, [&]() {
+        for (int id : ids) {
+            checksum += findTaskById(tasks, id)->id;
+        }
+    });
+    reportResult("find_task_by_id", count, operations, iterations, seconds);
+
+    seconds = timeBest(iterations, [&]() {
+        QuietOutput quiet;
+        for (int id : ids) {
+            markTaskStatus(tasks, id, TaskStatus::DONE);
+        }
+    });
+    reportResult("mark_task_status", count, operations, iterations, seconds);
+
+    // Status filter: the original per-task comparison vs the status bitmap
+    seconds = timeBest(iterations, [&]() {
+        for (const auto& task : tasks) {
+            if (task.status == TaskStatus::IN_PROGRESS) {
+                checksum += task.id;
+            }
+        }
+    });
+    reportResult("status_filter_linear", count, count, iterations, seconds);
+
+    seconds = timeBest(iterations, [&]() {
+        for (size_t row : tasks.rowsWithStatus(TaskStatus::IN_PROGRESS)) {
+            checksum += tasks.idAt(row);
+        }
+    });
+    reportResult("status_filter_bitmap", count, count, iterations, seconds);
+
+    if (checksum == 42) {
+        reportResult("unreachable", 0, 0, 0, 0.0); // Keeps the lookups from being optimized away
+    }
+}
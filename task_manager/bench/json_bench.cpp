@@ -0,0 +1,151 @@
+#include "bench.h"
+#include "json_text.h"
+#include <algorithm> // For std::max
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// --- Reference copies of the original escaping code ---
+
+/**
+ * \@brief Original escaper: every character goes through an ostringstream switch
+ */
+static std::string legacyEscapeJsonString(const std::string& input) {
+    std::ostringstream ss;
+    for (char c : input) {
+        switch (c) {
+            case '"': ss << "\\\""; break;
+            case '\\': ss << "\\\\"; break;
+            case '\b': ss << "\\b"; break;
+            case '\f': ss << "\\f"; break;
+            case '\n': ss << "\\n"; break;
+            case '\r': ss << "\\r"; break;
+            case '\t': ss << "\\t"; break;
+            default: ss << c; break;
+        }
+    }
+    return ss.str();
+}
+
+/**
+ * \@brief Original decoder (std::quoted rules): a backslash makes the next character literal,
+ * so \n came back as 'n'. Byte-at-a-time scan for the quote
+ */
+static bool legacyReadStringBody(const char*& pos, const char* end, std::string& out) {
+    const char* p = pos;
+    while (p < end) {
+        const char* runStart = p;
+        while (p < end && *p != '"' && *p != '\\') {
+            ++p;
+        }
+        out.append(runStart, p - runStart);
+        if (p >= end) {
+            break;
+        }
+        if (*p == '"') {
+            pos = p + 1;
+            return true;
+        }
+        if (++p < end) {
+            out.push_back(*p++);
+        }
+    }
+    return false;
+}
+
+/**
+ * \@brief Builds description-like text: words, with the occasional quote, tab or newline
+ */
+static std::vector<std::string> makeDescriptions(size_t count, size_t minLength, size_t maxLength) {
+    static const char* const WORDS[] = { "fix", "deploy", "review", "the", "api", "timeout", "write",
+                                         "docs", "release", "migration", "\"urgent\"", "line\nbreak", "a\tb" };
+    const size_t wordCount = sizeof(WORDS) / sizeof(WORDS[0]);
+    std::mt19937 rng(17);
+    std::uniform_int_distribution<size_t> lengthDist(minLength, maxLength);
+    std::vector<std::string> descriptions(count);
+    for (auto& description : descriptions) {
+        size_t length = lengthDist(rng);
+        while (description.size() < length) {
+            size_t word = rng() % wordCount;
+            // Keep special characters rare, as in real descriptions
+            if (word >= wordCount - 3 && rng() % 8 != 0) {
+                word = rng() % (wordCount - 3);
+            }
+            description += WORDS[word];
+            description += ' ';
+        }
+    }
+    return descriptions;
+}
+
+/**
+ * \@brief Times escaping and decoding of one set of descriptions, old code vs new
+ */
+static void runJsonSet(const std::string& label, const std::vector<std::string>& descriptions, int iterations) {
+    size_t count = descriptions.size();
+    size_t checksum = 0;
+    double seconds = timeBest(iterations, [&]() {
+        checksum = 0;
+        for (const auto& description : descriptions) {
+            checksum += legacyEscapeJsonString(description).size();
+        }
+    });
+    reportResult("escape_json_legacy" + label, count, count, iterations, seconds);
+
+    size_t newChecksum = 0;
+    std::string buffer;
+    seconds = timeBest(iterations, [&]() {
+        newChecksum = 0;
+        for (const auto& description : descriptions) {
+            buffer.clear();
+            appendJsonEscaped(buffer, description.data(), description.size());
+            newChecksum += buffer.size();
+        }
+    });
+    reportResult("escape_json" + label, count, count, iterations, seconds);
+
+    // The escaped forms, each followed by its closing quote, as they sit in a file
+    std::vector<std::string> escaped;
+    escaped.reserve(count);
+    for (const auto& description : descriptions) {
+        escaped.push_back(escapeJsonString(description) + '"');
+    }
+
+    seconds = timeBest(iterations, [&]() {
+        for (const auto& text : escaped) {
+            const char* p = text.data();
+            buffer.clear();
+            legacyReadStringBody(p, text.data() + text.size(), buffer);
+        }
+    });
+    reportResult("unescape_json_legacy" + label, count, count, iterations, seconds);
+
+    size_t mismatches = 0;
+    seconds = timeBest(iterations, [&]() {
+        mismatches = 0;
+        for (size_t i = 0; i < count; ++i) {
+            const char* p = escaped[i].data();
+            buffer.clear();
+            if (!readJsonStringBody(p, escaped[i].data() + escaped[i].size(), buffer) || buffer.size() != descriptions[i].size()) {
+                ++mismatches;
+            }
+        }
+    });
+    if (mismatches != 0) {
+        throw std::runtime_error("readJsonStringBody did not round-trip escapeJsonString");
+    }
+    reportResult("unescape_json" + label, count, count, iterations, seconds);
+}
+
+/**
+ * \@brief Compares the vectorized JSON escaper/decoder with the original code
+ * Short strings (typical descriptions, 15-250 bytes) and long ones (4 KiB), to
+ * separate per-call overhead from scanning throughput
+ * \@param count Number of short descriptions (a sixty-fourth as many long ones)
+ */
+void runJsonBenchmarks(size_t count) {
+    runJsonSet("", makeDescriptions(count, 15, 250), 5);
+    runJsonSet("_4k", makeDescriptions(std::max<size_t>(count / 64, 1), 4096, 4096), 5);
+}
@@ -0,0 +1,124 @@
+#include "bench.h"
+#include "commands.h"
+#include "query.h"
+#include "task_list.h"
+#include "utils.h"
+#include <iostream>
+#include <cstdio>
+#include <stdexcept>
+#include <fcntl.h> // For open
+#include <unistd.h> // For dup, dup2, close
+
+/**
+ * \@brief Points stdout at /dev/null for the lifetime of the object
+ * Unlike QuietOutput, the output still goes through every stream layer and
+ * system call, which is exactly what the list benchmarks measure
+ */
+class NullStdout {
+public:
+    NullStdout() {
+        std::cout.flush();
+        std::fflush(stdout);
+        saved = dup(STDOUT_FILENO);
+        int devNull = open("/dev/null", O_WRONLY);
+        if (saved < 0 || devNull < 0 || dup2(devNull, STDOUT_FILENO) < 0) {
+            throw std::runtime_error("cannot redirect stdout");
+        }
+        close(devNull);
+    }
+    ~NullStdout() {
+        std::cout.flush();
+        std::fflush(stdout);
+        dup2(saved, STDOUT_FILENO);
+        close(saved);
+    }
+private:
+    int saved;
+};
+
+/**
+ * \@brief The original listTasks: several insertions and a std::endl flush per line
+ */
+static void legacyListTasks(const TaskList& tasks) {
+    std::cout << "\n--- Task List ---" << std::endl;
+    for (const auto& task : tasks) {
+        std::cout << "ID: " << task.id
+                  << " | Status: " << statusToString(task.status)
+                  << " | Created: " << formatTimestamp(task.createdAt)
+                  << " | Updated: " << formatTimestamp(task.updatedAt) << std::endl;
+        std::cout << "Description: " << task.description << std::endl;
+        std::cout << "------------------------" << std::endl;
+    }
+    std::cout << "Total tasks: " << tasks.size() << std::endl;
+    std::cout << "------------------------" << std::endl;
+}
+
+/**
+ * \@brief Measures list output: per-line flushes vs the buffered writer, the first page of a sorted list,
+ * a --where query driven by an index vs one that has to scan, and the same for a --since window
+ * \@param count Number of tasks in the list
+ */
+void runListBenchmarks(size_t count) {
+    const int iterations = 3;
+    TaskList tasks(makeSyntheticTasks(count));
+
+    double seconds = timeBest(iterations, [&]() {
+        NullStdout null;
+        legacyListTasks(tasks);
+    });
+    reportResult("list_all_unbuffered", count, count, iterations, seconds);
+
+    seconds = timeBest(iterations, [&]() {
+        NullStdout null;
+        listTasks(tasks, ListOptions());
+    });
+    reportResult("list_all_buffered", count, count, iterations, seconds);
+
+    ListOptions page;
+    page.limit = 20;
+    page.sortKey = ListSortKey::UPDATED;
+    seconds = timeBest(iterations, [&]() {
+        NullStdout null;
+        listTasks(tasks, page);
+    });
+    reportResult("list_first_page_sorted", count, count, iterations, seconds);
+
+    // --- list --where: a narrow id range drives the query; the same filter with no index scans ---
+    TaskQuery narrow;
+    TaskQuery scanned;
+    std::string error;
+    if (!TaskQuery::compile("created>=2000-01-01 and status!=done and id>=100 and id<300", narrow, error) ||
+        !TaskQuery::compile("created>=2000-01-01 and not (status=done or id>=300 or id<100)", scanned, error)) {
+        throw std::runtime_error(error);
+    }
+    size_t matched = 0;
+    seconds = timeBest(iterations, [&]() {
+        matched = narrow.select(tasks).size();
+    });
+    reportResult("query_indexed", count, matched, iterations, seconds);
+
+    seconds = timeBest(iterations, [&]() {
+        matched = scanned.select(tasks).size();
+    });
+    reportResult("query_scan", count, matched, iterations, seconds);
+
+    // --- list --since: the newest 200 tasks through the created-time index, and the
+    // same window negated (not created < since), which only a scan can answer ---
+    auto newest = tasks.createdAtRow(count > 200 ? count - 200 : 0);
+    std::string since = formatTimestamp(newest);
+    TaskQuery recent;
+    TaskQuery recentScanned;
+    if (!recent.addTimeBound(TimeField::CREATED, true, since, error) ||
+        !TaskQuery::compile("not created<\"" + since + "\"", recentScanned, error)) {
+        throw std::runtime_error(error);
+    }
+    seconds = timeBest(iterations, [&]() {
+        matched = recent.select(tasks).size();
+    });
+    reportResult("since_indexed", count, matched, iterations, seconds);
+
+    seconds = timeBest(iterations, [&]() {
+        matched = recentScanned.select(tasks).size();
+    });
+    reportResult("since_scan", count, matched, iterations, seconds);
+}
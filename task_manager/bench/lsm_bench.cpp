@@ -0,0 +1,121 @@
+#include "bench.h"
+#include "storage.h"
+#include "lsm_store.h"
+#include "task_list.h"
+#include <cstdio> // For std::remove
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <utility> // For std::move
+#include <vector>
+#include <dirent.h> // For opendir, readdir
+
+/**
+ * \@brief Deletes the manifest, runs and logs of the LSM store in the working directory
+ */
+static void removeLsmFiles() {
+    closeLsmStore();
+    if (DIR* dir = opendir(".")) {
+        while (dirent* entry = readdir(dir)) {
+            std::string name = entry->d_name;
+            if (name.compare(0, 9, "tasks.lsm") == 0) {
+                std::remove(name.c_str());
+            }
+        }
+        closedir(dir);
+    }
+}
+
+/**
+ * \@brief Measures the LSM store: single-task inserts (log appends, flushes and background
+ * merges) against rewriting tasks.json per insert, point reads that hit and miss, and
+ * loading the store back once it holds several runs and a memtable
+ * \@param count Number of tasks in the list
+ */
+void runLsmBenchmarks(size_t count) {
+    const int iterations = count > 100000 ? 2 : 5;
+    TaskList tasks(makeSyntheticTasks(count));
+    std::vector<const Task*> live;
+    for (const Task& task : tasks) {
+        live.push_back(&task);
+    }
+
+    double seconds = timeBest(iterations, [&]() {
+        if (!saveLsmTasks(live, tasks.nextId())) {
+            throw std::runtime_error("saveLsmTasks failed");
+        }
+    });
+    reportResult("save_tasks_lsm", count, count, iterations, seconds);
+
+    // --- Inserts, one commit each: what an automation adding tasks one by one costs ---
+    // Enough of them to fill the memtable several times over, so flushes and merges are included
+    const size_t inserts = 20000;
+    Task added = tasks.taskAt(0);
+    int nextId = tasks.nextId();
+    seconds = timeBest(iterations, [&]() {
+        for (size_t i = 0; i < inserts; ++i) {
+            TaskChange change;
+            change.task = added;
+            change.task.id = nextId++;
+            change.id = change.task.id;
+            change.deleted = false;
+            if (!applyLsmChanges(std::vector<TaskChange>(1, change), nextId)) {
+                throw std::runtime_error("applyLsmChanges failed");
+            }
+        }
+    });
+    reportResult("insert_task_lsm", count, inserts, iterations, seconds);
+
+    // The same insert when every one rewrites the whole snapshot
+    const size_t rewrites = count > 100000 ? 2 : 10;
+    seconds = timeBest(iterations, [&]() {
+        QuietOutput quiet;
+        for (size_t i = 0; i < rewrites; ++i) {
+            Task task = added;
+            task.id = tasks.nextId();
+            tasks.add(std::move(task));
+            saveTasks(tasks);
+        }
+    });
+    reportResult("insert_task_json_rewrite", count, rewrites, iterations, seconds);
+    std::remove("tasks.json");
+
+    // --- Point reads across the memtable and every run; misses are mostly turned away by the bloom filters ---
+    const size_t lookups = 10000;
+    std::mt19937 lsmRng(11);
+    std::uniform_int_distribution<int> hitDist(1, nextId - 1);
+    std::uniform_int_distribution<int> missDist(nextId, nextId * 2);
+    seconds = timeBest(iterations, [&]() {
+        Task found;
+        for (size_t i = 0; i < lookups; ++i) {
+            if (!findLsmTask(hitDist(lsmRng), found)) {
+                throw std::runtime_error("findLsmTask missed a stored task");
+            }
+        }
+    });
+    reportResult("find_task_lsm", count, lookups, iterations, seconds);
+
+    seconds = timeBest(iterations, [&]() {
+        Task found;
+        for (size_t i = 0; i < lookups; ++i) {
+            if (findLsmTask(missDist(lsmRng), found)) {
+                throw std::runtime_error("findLsmTask found a task that was never stored");
+            }
+        }
+    });
+    reportResult("find_task_lsm_missing", count, lookups, iterations, seconds);
+
+    // --- Loading everything: the runs merged with the memtable, from a freshly opened store ---
+    size_t loaded = 0;
+    size_t expected = count + inserts * static_cast<size_t>(iterations);
+    seconds = timeBest(iterations, [&]() {
+        closeLsmStore();
+        int storedId = 0;
+        loaded = loadLsmTasks(storedId).size();
+    });
+    if (loaded != expected) {
+        throw std::runtime_error("loadLsmTasks returned the wrong number of tasks");
+    }
+    reportResult("load_tasks_lsm", count, loaded, iterations, seconds);
+    removeLsmFiles();
+}
@@ -0,0 +1,154 @@
+#include "bench.h"
+#include "storage.h"
+#include "task.h"
+#include <fstream>
+#include <sstream>
+#include <iomanip> // For std::quoted, std::get_time
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <ctime>
+#include <thread> // For std::thread::hardware_concurrency
+#include <algorithm> // For std::max
+
+// --- Reference copy of the original multi-copy loader ---
+// Kept only as a baseline for comparison; diagnostics are dropped because
+// the benchmark input is always well formed
+
+/**
+ * \@brief Original timestamp parser: stringstream + std::get_time + mktime
+ */
+static std::chrono::system_clock::time_point legacyParseTimestamp(const std::string& timestampStr) {
+    std::tm tm = {};
+    std::stringstream ss(timestampStr);
+    ss >> std::get_time(&tm, "%Y-%m-%d %H:%M:%S");
+    if (ss.fail()) {
+        return std::chrono::system_clock::from_time_t(0);
+    }
+    return std::chrono::system_clock::from_time_t(std::mktime(&tm));
+}
+
+/**
+ * \@brief Original object parser: one stringstream per object, std::quoted per field
+ */
+static bool legacyParseTaskObject(const std::string& objStr, Task& task) {
+    std::stringstream ss(objStr);
+    std::string key;
+    std::string valueStr;
+    int numericValue = -1;
+    char ch;
+    ss >> ch >> std::ws;
+    while (ss.peek() != EOF && ss.peek() != '}') {
+        ss >> std::quoted(key);
+        ss >> std::ws >> ch >> std::ws;
+        bool isNumeric = false;
+        if (ss.peek() == '"') {
+            ss >> std::quoted(valueStr);
+        } else {
+            if (!(ss >> numericValue)) {
+                return false;
+            }
+            isNumeric = true;
+        }
+        if (ss.fail() || ch != ':') {
+            return false;
+        }
+        if (key == "id" && isNumeric) {
+            task.id = numericValue;
+        } else if (key == "description") {
+            task.description = valueStr;
+        } else if (key == "status") {
+            task.status = stringToStatus(valueStr);
+        } else if (key == "createdAt") {
+            task.createdAt = legacyParseTimestamp(valueStr);
+        } else if (key == "updatedAt") {
+            task.updatedAt = legacyParseTimestamp(valueStr);
+        }
+        ss >> std::ws;
+        if (ss.peek() == ',') {
+            ss.ignore(1);
+            ss >> std::ws;
+        }
+    }
+    return true;
+}
+
+/**
+ * \@brief Original loader: file -> stringstream -> string -> substr per object
+ */
+static std::vector<Task> legacyLoadTasks(const std::string& filename) {
+    std::vector<Task> tasks;
+    std::ifstream inputFile(filename);
+    std::stringstream buffer;
+    buffer << inputFile.rdbuf();
+    std::string content = buffer.str();
+    content.erase(0, content.find_first_not_of(" \t\n\r"));
+    content.erase(content.find_last_not_of(" \t\n\r") + 1);
+
+    size_t startPos = 1;
+    while (startPos < content.length() - 1) {
+        size_t objStartPos = content.find('{', startPos);
+        if (objStartPos == std::string::npos) {
+            break;
+        }
+        int braceLevel = 0;
+        size_t objEndPos = objStartPos;
+        while (objEndPos < content.length() - 1) {
+            if (content[objEndPos] == '{') {
+                braceLevel++;
+            } else if (content[objEndPos] == '}' && --braceLevel == 0) {
+                break;
+            }
+            objEndPos++;
+        }
+        std::string taskStr = content.substr(objStartPos, objEndPos - objStartPos + 1);
+        Task task;
+        if (legacyParseTaskObject(taskStr, task)) {
+            tasks.push_back(task);
+        }
+        startPos = objEndPos + 1;
+    }
+    return tasks;
+}
+
+/**
+ * \@brief Compares the single-pass loader with the original stringstream-based loader
+ * \@param count Number of tasks in the generated file
+ */
+void runParseBenchmarks(size_t count) {
+    writeSyntheticTasksFile("tasks.json", count);
+    const int iterations = count > 100000 ? 1 : 5;
+
+    size_t loaded = 0;
+    double legacySeconds = timeBest(iterations, [&]() {
+        loaded = legacyLoadTasks("tasks.json").size();
+    });
+    if (loaded != count) {
+        throw std::runtime_error("legacy loader returned the wrong number of tasks");
+    }
+    reportResult("load_tasks_legacy", count, count, iterations, legacySeconds);
+
+    double seconds = timeBest(iterations, [&]() {
+        QuietOutput quiet;
+        loaded = loadTasks().size();
+    });
+    if (loaded != count) {
+        throw std::runtime_error("loadTasks returned the wrong number of tasks");
+    }
+    reportResult("load_tasks", count, count, iterations, seconds);
+
+    // Parse scaling: the same load with the parse thread count capped
+    size_t hardwareThreads = std::max(1u, std::thread::hardware_concurrency());
+    for (size_t threads = 1; threads <= hardwareThreads; threads *= 2) {
+        setParseThreadLimit(threads);
+        seconds = timeBest(iterations, [&]() {
+            QuietOutput quiet;
+            loaded = loadTasks().size();
+        });
+        if (loaded != count) {
+            throw std::runtime_error("loadTasks returned the wrong number of tasks");
+        }
+        reportResult("load_tasks_threads_" + std::to_string(threads), count, count, iterations, seconds);
+    }
+    setParseThreadLimit(0);
+}
@@ -0,0 +1,181 @@
+#include "bench.h"
+#include "storage.h"
+#include "cli.h" // For runBatch
+#include "task_list.h"
+#include <cstdio> // For std::remove, std::fopen
+#include <algorithm> // For std::min
+#include <chrono>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <unistd.h> // For truncate
+
+/**
+ * \@brief Appends records to tasks.log until it holds target of them since the last checkpoint
+ * Each record marks one task done, round-robin, in commits of bounded size
+ * \@param tasks The checkpointed list (changed in place, like a command would)
+ * \@param logged In/out: records in the log so far
+ * \@param target Records the log should hold
+ */
+static void growLog(TaskList& tasks, size_t& logged, size_t target) {
+    const size_t commitSize = 65536;
+    QuietOutput quiet;
+    while (logged < target) {
+        size_t batch = std::min(commitSize, target - logged);
+        for (size_t i = 0; i < batch; ++i) {
+            size_t row = (logged + i) % tasks.slotCount();
+            TaskStatus status = (logged + i) / tasks.slotCount() % 2 == 0 ? TaskStatus::DONE : TaskStatus::TODO;
+            tasks.updateStatus(tasks.idAt(row), status, std::chrono::system_clock::now());
+            recordTaskChange(tasks.taskAt(row));
+        }
+        commitTasks(tasks);
+        logged += batch;
+    }
+}
+
+/**
+ * \@brief Overwrites one byte in the middle of a file, as a torn or corrupted write would
+ */
+static void damageFile(const std::string& path) {
+    FILE* file = std::fopen(path.c_str(), "r+b");
+    if (file == nullptr || std::fseek(file, 0, SEEK_END) != 0) {
+        throw std::runtime_error("cannot open " + path);
+    }
+    long middle = std::ftell(file) / 2;
+    std::fseek(file, middle, SEEK_SET);
+    int byte = std::fgetc(file);
+    std::fseek(file, middle, SEEK_SET);
+    std::fputc(byte == 'x' ? 'y' : 'x', file);
+    std::fclose(file);
+}
+
+/**
+ * \@brief Checks that a recovered list holds exactly the expected tasks and next-id counter
+ * \@param what The scenario, for the error message
+ */
+static void expectRecovered(const TaskList& expected, const TaskList& recovered, const std::string& what) {
+    bool same = recovered.size() == expected.size() && recovered.nextId() == expected.nextId();
+    for (size_t row : expected.liveRows()) {
+        if (!same) {
+            break;
+        }
+        const Task& task = expected.taskAt(row);
+        size_t found = 0;
+        same = recovered.findRow(task.id, found) && recovered.taskAt(found).description == task.description &&
+               recovered.taskAt(found).status == task.status;
+    }
+    if (!same) {
+        throw std::runtime_error("loadTasks recovered the wrong tasks " + what);
+    }
+}
+
+/**
+ * \@brief Measures recovery (loadTasks on the JSON store) against the log written since the
+ * last checkpoint: none, and a sixteenth, a quarter and all of the task count in records
+ * (the default checkpoint threshold is about a quarter of the snapshot). Then the same
+ * with the newest checkpoint damaged, so recovery falls back to the previous one, and once
+ * more after a batch that ends in compact and after a large import (checking that every
+ * change is recovered)
+ * \@param count Number of tasks in the list
+ */
+void runRecoveryBenchmarks(size_t count) {
+    const int iterations = count > 100000 ? 2 : 5;
+    TaskList tasks(makeSyntheticTasks(count));
+    setCheckpointLogLimit(std::numeric_limits<long long>::max()); // The benchmark decides when to checkpoint
+    {
+        QuietOutput quiet;
+        saveTasks(tasks);
+    }
+
+    const size_t fractions[] = { 0, 16, 4, 1 }; // Log records = count / fraction (0: none)
+    const char* const names[] = { "recover_log_0pct", "recover_log_6pct", "recover_log_25pct", "recover_log_100pct" };
+    size_t logged = 0;
+    for (size_t i = 0; i < 4; ++i) {
+        growLog(tasks, logged, fractions[i] == 0 ? 0 : count / fractions[i]);
+        size_t loaded = 0;
+        double seconds = timeBest(iterations, [&]() {
+            QuietOutput quiet;
+            loaded = loadTasks().size();
+        });
+        if (loaded != count) {
+            throw std::runtime_error("loadTasks recovered the wrong number of tasks");
+        }
+        reportResult(names[i], count, logged, iterations, seconds);
+    }
+
+    // --- A damaged newest checkpoint: the previous one plus both logs ---
+    // The checkpoint keeps the one above (with its full log) as the previous one
+    {
+        QuietOutput quiet;
+        saveTasks(tasks);
+    }
+    size_t newLog = 0;
+    growLog(tasks, newLog, count / 16);
+    damageFile("tasks.json");
+    size_t loaded = 0;
+    double seconds = timeBest(iterations, [&]() {
+        QuietOutput quiet;
+        loaded = loadTasks().size();
+    });
+    if (loaded != count) {
+        throw std::runtime_error("loadTasks recovered the wrong number of tasks from the previous checkpoint");
+    }
+    reportResult("recover_previous_checkpoint", count, logged + newLog, iterations, seconds);
+
+    // --- A checkpoint taken by compact at the end of a batch, then cut short ---
+    // The batch's changes are only in the log that leads from the previous checkpoint
+    {
+        QuietOutput quiet;
+        saveTasks(tasks); // Clears the damaged state
+        std::istringstream script("delete 2\nadd recovered after compact\ncompact\n");
+        runBatch(tasks, script, "task-bench");
+    }
+    if (truncate("tasks.json", 100) != 0) {
+        throw std::runtime_error("cannot truncate tasks.json");
+    }
+    TaskList recovered;
+    seconds = timeBest(iterations, [&]() {
+        QuietOutput quiet;
+        recovered = loadTasks();
+    });
+    expectRecovered(tasks, recovered, "after a batch ending in compact");
+    reportResult("recover_after_compact", count, count, iterations, seconds);
+
+    // --- The same after an import large enough to be logged from the list, not change by change ---
+    const size_t imported = 6000;
+    {
+        std::ofstream records("bench_import.ndjson", std::ios::binary);
+        for (size_t i = 0; i < imported; ++i) {
+            records << "{\"description\": \"imported task " << i << "\"}\n";
+        }
+    }
+    {
+        QuietOutput quiet;
+        saveTasks(tasks);
+        std::istringstream script("import bench_import.ndjson\nmark-done " + std::to_string(tasks.nextId() + 5000) + "\n");
+        runBatch(tasks, script, "task-bench");
+    }
+    std::remove("bench_import.ndjson");
+    if (truncate("tasks.json", 100) != 0) {
+        throw std::runtime_error("cannot truncate tasks.json");
+    }
+    seconds = timeBest(iterations, [&]() {
+        QuietOutput quiet;
+        recovered = loadTasks();
+    });
+    expectRecovered(tasks, recovered, "after a large import");
+    reportResult("recover_after_import", count, imported, iterations, seconds);
+
+    // A fresh checkpoint clears the damaged state; then leave no files behind
+    {
+        QuietOutput quiet;
+        saveTasks(tasks);
+    }
+    setCheckpointLogLimit(0);
+    std::remove("tasks.json");
+    std::remove("tasks.json.prev");
+    std::remove("tasks.log");
+    std::remove("tasks.log.prev");
+}
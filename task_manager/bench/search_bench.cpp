@@ -0,0 +1,84 @@
+#include "bench.h"
+#include "task_list.h"
+#include <random>
+#include <string>
+#include <vector>
+
+/**
+ * \@brief Lowercases ASCII letters, matching the search index's case folding
+ */
+static std::string lowercase(std::string text) {
+    for (char& c : text) {
+        if (c >= 'A' && c <= 'Z') {
+            c = static_cast<char>(c - 'A' + 'a');
+        }
+    }
+    return text;
+}
+
+/**
+ * \@brief Measures full-text search: inverted index vs a linear substring scan
+ * Every description carries a few common words and one "ref<N>" tag out of
+ * 10000, so queries pair a frequent term with a rare one like real searches do
+ * \@param count Number of tasks in the list
+ */
+void runSearchBenchmarks(size_t count) {
+    static const char* const words[] = {
+        "fix", "deploy", "review", "login", "page", "update", "docs", "release", "flaky", "test",
+        "pipeline", "refactor", "storage", "migration", "customer", "report", "backlog", "api", "timeout", "cleanup"
+    };
+    const size_t wordCount = sizeof(words) / sizeof(words[0]);
+    const size_t operations = 200;
+    const int iterations = 3;
+    // The scan touches every description per query, so fewer queries keep large runs short
+    const size_t scanOperations = count > 100000 ? 20 : operations;
+
+    std::mt19937 rng(11);
+    std::uniform_int_distribution<size_t> wordDist(0, wordCount - 1);
+    std::uniform_int_distribution<int> tagDist(0, 9999);
+    std::vector<Task> vector = makeSyntheticTasks(count);
+    for (auto& task : vector) {
+        task.description = std::string(words[wordDist(rng)]) + " " + words[wordDist(rng)] + " " +
+                           words[wordDist(rng)] + " REF" + std::to_string(tagDist(rng));
+    }
+    std::vector<std::string> queries(operations);
+    for (auto& query : queries) {
+        query = std::string(words[wordDist(rng)]) + " ref" + std::to_string(tagDist(rng));
+    }
+
+    // Baseline: case-insensitive substring scan of every description for every term
+    size_t matches = 0;
+    double seconds = timeBest(iterations, [&]() {
+        for (size_t q = 0; q < scanOperations; ++q) {
+            const std::string& query = queries[q];
+            size_t space = query.find(' ');
+            std::string first = query.substr(0, space);
+            std::string second = query.substr(space + 1);
+            for (const auto& task : vector) {
+                std::string text = lowercase(task.description);
+                if (text.find(first) != std::string::npos && text.find(second) != std::string::npos) {
+                    ++matches;
+                }
+            }
+        }
+    });
+    reportResult("search_linear_scan", count, scanOperations, iterations, seconds);
+
+    TaskList tasks;
+    seconds = timeBest(1, [&]() {
+        tasks = TaskList(vector);
+        matches += tasks.search("warmup").size(); // The first search builds the index
+    });
+    reportResult("search_index_build", count, count, 1, seconds);
+
+    seconds = timeBest(iterations, [&]() {
+        for (const auto& query : queries) {
+            matches += tasks.search(query).size();
+        }
+    });
+    reportResult("search_indexed", count, operations, iterations, seconds);
+
+    if (matches == 42) {
+        reportResult("unreachable", 0, 0, 0, 0.0); // Keeps the searches from being optimized away
+    }
+}
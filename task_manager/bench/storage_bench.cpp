@@ -0,0 +1,181 @@
+#include "bench.h"
+#include "storage.h"
+#include "binary_store.h"
+#include "btree_store.h"
+#include "commands.h"
+#include "task_list.h"
+#include "utils.h"
+#include <cstdio> // For std::remove
+#include <algorithm> // For std::shuffle, std::min
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+/**
+ * \@brief Measures the persistence path and the remaining per-command costs
+ * Full snapshot saves (JSON, binary and btree), binary and btree loads, btree
+ * point reads, committing a single change (JSON log and btree pages),
+ * generateNextId, deleteTask, the bulk deleteTasks and compaction
+ * \@param count Number of tasks in the list
+ */
+void runStorageBenchmarks(size_t count) {
+    const int iterations = count > 100000 ? 2 : 5;
+    std::vector<Task> vector = makeSyntheticTasks(count);
+    TaskList tasks(vector);
+
+    std::vector<const Task*> live;
+    for (const Task& task : tasks) {
+        live.push_back(&task);
+    }
+
+    // --- Full snapshots ---
+    double seconds = timeBest(iterations, [&]() {
+        QuietOutput quiet;
+        saveTasks(tasks);
+    });
+    reportResult("save_tasks_json", count, count, iterations, seconds);
+
+    seconds = timeBest(iterations, [&]() {
+        if (!saveBinaryTasks(live, tasks.nextId())) {
+            throw std::runtime_error("saveBinaryTasks failed");
+        }
+    });
+    reportResult("save_tasks_binary", count, count, iterations, seconds);
+
+    size_t loaded = 0;
+    seconds = timeBest(iterations, [&]() {
+        int nextId = 0;
+        loaded = loadBinaryTasks(nextId).size();
+    });
+    if (loaded != count) {
+        throw std::runtime_error("loadBinaryTasks returned the wrong number of tasks");
+    }
+    reportResult("load_tasks_binary", count, count, iterations, seconds);
+    std::remove("tasks.bin");
+    std::remove("tasks.bin.idx");
+
+    // --- Paged B+tree store: full build, full load, point reads and single-change commits ---
+    seconds = timeBest(iterations, [&]() {
+        if (!savePagedTasks(live, tasks.nextId())) {
+            throw std::runtime_error("savePagedTasks failed");
+        }
+    });
+    reportResult("save_tasks_btree", count, count, iterations, seconds);
+
+    seconds = timeBest(iterations, [&]() {
+        int nextId = 0;
+        loaded = loadPagedTasks(nextId).size();
+    });
+    if (loaded != count) {
+        throw std::runtime_error("loadPagedTasks returned the wrong number of tasks");
+    }
+    reportResult("load_tasks_btree", count, count, iterations, seconds);
+
+    // Each lookup opens the store and walks root to leaf with a cold page cache
+    const size_t lookups = 1000;
+    std::mt19937 pageRng(7);
+    std::uniform_int_distribution<int> idDist(1, static_cast<int>(count));
+    seconds = timeBest(iterations, [&]() {
+        Task found;
+        for (size_t i = 0; i < lookups; ++i) {
+            if (!findPagedTask(idDist(pageRng), found)) {
+                throw std::runtime_error("findPagedTask missed a stored task");
+            }
+        }
+    });
+    reportResult("find_task_btree", count, lookups, iterations, seconds);
+
+    // A status change on a random task: a leaf and the header, journaled and fsynced
+    const size_t pagedCommits = 20;
+    seconds = timeBest(iterations, [&]() {
+        for (size_t i = 0; i < pagedCommits; ++i) {
+            TaskChange change;
+            change.task = tasks.taskAt(static_cast<size_t>(idDist(pageRng) - 1));
+            change.id = change.task.id;
+            change.deleted = false;
+            change.task.status = TaskStatus::DONE;
+            if (!applyPagedChanges(std::vector<TaskChange>(1, change), tasks.nextId())) {
+                throw std::runtime_error("applyPagedChanges failed");
+            }
+        }
+    });
+    reportResult("commit_one_change_btree", count, pagedCommits, iterations, seconds);
+    std::remove("tasks.db");
+
+    // --- One command's worth of persistence: a single change appended to tasks.log ---
+    const size_t commits = 200;
+    Task changed = tasks.taskAt(0);
+    seconds = timeBest(iterations, [&]() {
+        QuietOutput quiet;
+        for (size_t i = 0; i < commits; ++i) {
+            recordTaskChange(changed);
+            commitTasks(tasks);
+        }
+    });
+    reportResult("commit_one_change_json", count, commits, iterations, seconds);
+    std::remove("tasks.log");
+
+    // --- generateNextId ---
+    const size_t idCalls = 1000000;
+    long long checksum = 0;
+    seconds = timeBest(iterations, [&]() {
+        for (size_t i = 0; i < idCalls; ++i) {
+            checksum += generateNextId(tasks);
+        }
+    });
+    reportResult("generate_next_id", count, idCalls, iterations, seconds);
+
+    // --- deleteTask on random ids (each run deletes from a fresh copy) ---
+    const size_t deletes = std::min<size_t>(count, 500);
+    std::mt19937 rng(5);
+    std::vector<int> ids;
+    for (const auto& task : vector) {
+        ids.push_back(task.id);
+    }
+    std::shuffle(ids.begin(), ids.end(), rng);
+    ids.resize(deletes);
+    double best = 0.0;
+    for (int i = 0; i < iterations; ++i) {
+        TaskList copy(vector);
+        double elapsed = timeBest(1, [&]() {
+            QuietOutput quiet;
+            for (int id : ids) {
+                deleteTask(copy, id);
+            }
+        });
+        best = (i == 0 || elapsed < best) ? elapsed : best;
+    }
+    reportResult("delete_task", count, deletes, iterations, best);
+
+    // --- The same ids as one bulk delete (delete 3,7,9,...) ---
+    TaskSelection selection;
+    selection.ids = ids;
+    for (int i = 0; i < iterations; ++i) {
+        TaskList copy(vector);
+        double elapsed = timeBest(1, [&]() {
+            QuietOutput quiet;
+            deleteTasks(copy, selection);
+        });
+        best = (i == 0 || elapsed < best) ? elapsed : best;
+    }
+    reportResult("delete_tasks_bulk", count, deletes, iterations, best);
+
+    // --- compact() squeezing out the tombstones of every fifth task (below the automatic threshold) ---
+    std::vector<size_t> deadRows;
+    for (size_t row = 0; row < count; row += 5) {
+        deadRows.push_back(row);
+    }
+    for (int i = 0; i < iterations; ++i) {
+        TaskList copy(vector);
+        copy.removeRows(deadRows);
+        double elapsed = timeBest(1, [&]() {
+            checksum += static_cast<long long>(copy.compact());
+        });
+        best = (i == 0 || elapsed < best) ? elapsed : best;
+    }
+    reportResult("compact_tasks", count, count, iterations, best);
+
+    if (checksum == 42) {
+        reportResult("unreachable", 0, 0, 0, 0.0); // Keeps the calls from being optimized away
+    }
+}
@@ -0,0 +1,67 @@
+#include "bench.h"
+#include "task_list.h"
+#include "task_table.h"
+#include <chrono>
+#include <vector>
+
+/**
+ * \@brief Compares full scans over the two in-memory representations
+ * TaskList stores whole Task records (AoS); TaskTable stores columns and an
+ * arena (SoA), so a scan over one field touches far less memory
+ * \@param count Number of tasks in the list
+ */
+void runTableBenchmarks(size_t count) {
+    const int iterations = 5;
+    std::vector<Task> vector = makeSyntheticTasks(count);
+    TaskList list(vector);
+    TaskTable table(vector);
+    auto cutoff = vector[vector.size() / 2].createdAt;
+    long long checksum = 0;
+
+    // Field scan: tasks updated since a cutoff
+    double seconds = timeBest(iterations, [&]() {
+        for (const auto& task : list) {
+            checksum += task.updatedAt >= cutoff;
+        }
+    });
+    reportResult("scan_updated_since_list", count, count, iterations, seconds);
+
+    seconds = timeBest(iterations, [&]() {
+        for (size_t row = 0; row < table.size(); ++row) {
+            checksum += table.updatedAtRow(row) >= cutoff;
+        }
+    });
+    reportResult("scan_updated_since_table", count, count, iterations, seconds);
+
+    // Status filter: bitmap (list) vs one-byte status column (table)
+    seconds = timeBest(iterations, [&]() {
+        checksum += static_cast<long long>(list.rowsWithStatus(TaskStatus::DONE).size());
+    });
+    reportResult("status_filter_list", count, count, iterations, seconds);
+
+    seconds = timeBest(iterations, [&]() {
+        checksum += static_cast<long long>(table.rowsWithStatus(TaskStatus::DONE).size());
+    });
+    reportResult("status_filter_table", count, count, iterations, seconds);
+
+    // Description scan: total text length (strings scattered on the heap vs one arena)
+    seconds = timeBest(iterations, [&]() {
+        for (size_t row = 0; row < list.size(); ++row) {
+            TextRef text = list.descriptionAt(row);
+            checksum += text.size + static_cast<unsigned char>(text.data[0]);
+        }
+    });
+    reportResult("scan_descriptions_list", count, count, iterations, seconds);
+
+    seconds = timeBest(iterations, [&]() {
+        for (size_t row = 0; row < table.size(); ++row) {
+            TextRef text = table.descriptionAt(row);
+            checksum += text.size + static_cast<unsigned char>(text.data[0]);
+        }
+    });
+    reportResult("scan_descriptions_table", count, count, iterations, seconds);
+
+    if (checksum == 42) {
+        reportResult("unreachable", 0, 0, 0, 0.0); // Keeps the scans from being optimized away
+    }
+}
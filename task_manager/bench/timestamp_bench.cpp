@@ -0,0 +1,87 @@
+#include "bench.h"
+#include "utils.h"
+#include <chrono>
+#include <ctime>
+#include <iomanip> // For std::put_time, std::get_time
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// --- Reference copies of the original iostream-based timestamp code ---
+
+static std::string legacyFormatTimestamp(const std::chrono::system_clock::time_point& tp) {
+    std::time_t time = std::chrono::system_clock::to_time_t(tp);
+    std::tm local_tm = *std::localtime(&time);
+    std::stringstream ss;
+    ss << std::put_time(&local_tm, "%Y-%m-%d %H:%M:%S");
+    return ss.str();
+}
+
+static std::chrono::system_clock::time_point legacyParseTimestamp(const std::string& timestampStr) {
+    std::tm tm = {};
+    std::stringstream ss(timestampStr);
+    ss >> std::get_time(&tm, "%Y-%m-%d %H:%M:%S");
+    return std::chrono::system_clock::from_time_t(std::mktime(&tm));
+}
+
+/**
+ * \@brief Compares the hand-rolled timestamp codec with the iostream path
+ * Formats and parses the same set of timestamps (spread over two years, so
+ * both sides of any DST transition in the local timezone are covered) and
+ * checks that the new formatter agrees with localtime/put_time on every one
+ * \@param count Number of timestamps
+ */
+void runTimestampBenchmarks(size_t count) {
+    std::mt19937 rng(11);
+    std::uniform_int_distribution<long long> secondDist(0, 2LL * 365 * 24 * 3600);
+    std::vector<std::chrono::system_clock::time_point> points(count);
+    for (auto& point : points) {
+        point = std::chrono::system_clock::from_time_t(static_cast<std::time_t>(1704067200 + secondDist(rng)));
+    }
+    std::vector<std::string> texts(count);
+    const int iterations = 3;
+
+    double seconds = timeBest(iterations, [&]() {
+        for (size_t i = 0; i < count; ++i) {
+            texts[i] = legacyFormatTimestamp(points[i]);
+        }
+    });
+    reportResult("format_timestamp_legacy", count, count, iterations, seconds);
+
+    char buffer[TIMESTAMP_BUFFER_SIZE];
+    size_t mismatches = 0;
+    seconds = timeBest(iterations, [&]() {
+        mismatches = 0;
+        for (size_t i = 0; i < count; ++i) {
+            formatTimestamp(points[i], buffer);
+            mismatches += texts[i].compare(0, TIMESTAMP_LENGTH, buffer, TIMESTAMP_LENGTH) != 0;
+        }
+    });
+    if (mismatches != 0) {
+        throw std::runtime_error("formatTimestamp disagrees with localtime/put_time");
+    }
+    reportResult("format_timestamp", count, count, iterations, seconds);
+
+    long long checksum = 0;
+    seconds = timeBest(iterations, [&]() {
+        for (size_t i = 0; i < count; ++i) {
+            checksum += legacyParseTimestamp(texts[i]).time_since_epoch().count();
+        }
+    });
+    reportResult("parse_timestamp_legacy", count, count, iterations, seconds);
+
+    std::chrono::system_clock::time_point parsed;
+    seconds = timeBest(iterations, [&]() {
+        for (size_t i = 0; i < count; ++i) {
+            parseTimestamp(texts[i].data(), texts[i].size(), parsed);
+            checksum += parsed.time_since_epoch().count();
+        }
+    });
+    reportResult("parse_timestamp", count, count, iterations, seconds);
+
+    if (checksum == 42) {
+        reportResult("unreachable", 0, 0, 0, 0.0); // Keeps the loops from being optimized away
+    }
+}
@@ -0,0 +1,53 @@
+#include "bench.h"
+#include "transfer.h"
+#include "storage.h"
+#include "task_list.h"
+#include <cstdio> // For std::remove
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+/**
+ * \@brief Measures export and import of every task, as NDJSON and as CSV
+ * Exports go to a file in the scratch directory; imports read that file back
+ * into an empty list
+ * \@param count Number of tasks in the list
+ */
+void runTransferBenchmarks(size_t count) {
+    const int iterations = count > 100000 ? 2 : 5;
+    TaskList tasks(makeSyntheticTasks(count));
+    const TransferFormat formats[] = { TransferFormat::NDJSON, TransferFormat::CSV };
+    const char* const names[] = { "ndjson", "csv" };
+
+    for (size_t i = 0; i < 2; ++i) {
+        const std::string path = std::string("transfer.") + names[i];
+        size_t exported = 0;
+        double seconds = timeBest(iterations, [&]() {
+            std::ofstream output(path, std::ios::binary);
+            exported = exportTasks(tasks, formats[i], output);
+            output.close();
+            if (!output) {
+                throw std::runtime_error("export to " + path + " failed");
+            }
+        });
+        reportResult(std::string("export_") + names[i], count, exported, iterations, seconds);
+
+        TaskList imported;
+        seconds = timeBest(iterations, [&]() {
+            QuietOutput quiet;
+            imported = TaskList();
+            ImportResult result;
+            if (!importTasks(imported, path, formats[i], result) || result.imported != count) {
+                throw std::runtime_error("import of " + path + " failed");
+            }
+        });
+        reportResult(std::string("import_") + names[i], count, imported.size(), iterations, seconds);
+
+        // Settle the changes the imports recorded, so later benchmarks start clean
+        {
+            QuietOutput quiet;
+            commitTasks(imported);
+        }
+        std::remove(path.c_str());
+    }
+}
@@ -0,0 +1,98 @@
+#ifndef BINARY_STORE_H
+#define BINARY_STORE_H
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include "task.h"
+#include "storage.h" // For TaskChange
+
+// --- Binary task store (tasks.bin) ---
+// Layout: [header][record slots x capacity][string heap]
+// Each slot has a fixed width, so a status or timestamp change rewrites one slot in place
+// Descriptions live in the heap and are addressed by offset/length from their slot
+// Slots are kept in ascending id order; deleted slots are flagged, not removed (a tombstone),
+// until a full rewrite compacts them away: on `task-cli compact`, or once they pass the
+// TOMBSTONE_COMPACT_* threshold of task.h
+// Integers are stored in native byte order (the file is not meant to move between machines)
+// A sidecar tasks.bin.idx maps each id straight to its slot, so in-place updates
+// reach their slot in O(1) without searching
+
+// Header at the start of tasks.bin (128 bytes)
+struct BinaryStoreHeader {
+    char magic[8]; // "TASKBIN1"
+    uint32_t version; // Format version (currently 1)
+    uint32_t recordSize; // sizeof(TaskRecordSlot), to detect layout mismatches
+    uint64_t recordCount; // Slots in use, including deleted ones
+    uint64_t recordCapacity; // Slots reserved before the heap starts
+    uint64_t liveCount; // Slots in use that are not deleted
+    uint64_t heapOffset; // File offset of the string heap
+    uint64_t heapSize; // Bytes of the heap in use
+    uint64_t heapGarbage; // Heap bytes no longer referenced by any slot
+    int32_t nextId; // Next task id to hand out (0 in files written before it existed)
+    uint32_t reserved1;
+    uint8_t reserved[56]; // Room for future header fields
+};
+
+// Fixed-width record slot (40 bytes)
+struct TaskRecordSlot {
+    int32_t id;
+    uint8_t status; // TaskStatus value
+    uint8_t flags; // SLOT_DELETED
+    uint16_t reserved;
+    uint32_t descriptionLength; // Bytes of the description in the heap
+    uint32_t reserved2;
+    uint64_t descriptionOffset; // Offset of the description, relative to the heap start
+    int64_t createdAt; // Nanoseconds since the epoch
+    int64_t updatedAt; // Nanoseconds since the epoch
+};
+
+// Slot flag: the task was deleted and the slot is waiting for the next rewrite
+const uint8_t SLOT_DELETED = 0x01;
+
+/**
+ * \@brief Checks whether a binary task store exists in the working directory
+ * \@return True if tasks.bin exists
+ */
+bool binaryStoreExists();
+
+/**
+ * \@brief Loads all live tasks from tasks.bin by memory-mapping it
+ * No JSON is parsed; each slot is copied straight into a Task
+ * \@param nextId Output parameter: the stored next-id counter (0 if the file predates it)
+ * \@return The tasks in id order. Returns empty vector if the file is missing or invalid
+ */
+std::vector<Task> loadBinaryTasks(int& nextId);
+
+/**
+ * \@brief Writes a complete, compacted tasks.bin (via a temporary file and rename)
+ * \@param tasks The tasks to store
+ * \@param nextId The next-id counter to store in the header
+ * \@return True on success, false otherwise
+ */
+bool saveBinaryTasks(const std::vector<Task>& tasks, int nextId);
+
+/**
+ * \@brief Writes a complete, compacted tasks.bin from tasks held elsewhere
+ * (such as the live rows of a TaskList with tombstones)
+ * \@param ordered The tasks to store, in any order
+ * \@param nextId The next-id counter to store in the header
+ * \@return True on success, false otherwise
+ */
+bool saveBinaryTasks(std::vector<const Task*> ordered, int nextId);
+
+/**
+ * \@brief Applies individual changes to tasks.bin in place
+ * Updates rewrite one slot, new tasks append a slot, deletes flag their slot,
+ * and new descriptions are appended to the heap
+ * The heap, the slots and then the header are each made durable (fsync) before the
+ * next step, so a crash leaves every slot readable, though possibly only part of
+ * the changes applied
+ * \@param changes The changes to apply, in order
+ * \@param nextId The current next-id counter, stored in the header
+ * \@return False if the changes cannot be applied in place (the caller should
+ * rewrite the whole file with saveBinaryTasks), true otherwise
+ */
+bool applyBinaryChanges(const std::vector<TaskChange>& changes, int nextId);
+
+#endif // BINARY_STORE_H
@@ -0,0 +1,107 @@
+#ifndef BTREE_STORE_H
+#define BTREE_STORE_H
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+#include "task.h"
+#include "storage.h" // For TaskChange
+
+// --- Paged B+tree task store (tasks.db) ---
+// The file is an array of 4 KiB pages. Page 0 holds the header; every other page
+// is a tree node, part of an overflow chain, or free (chained into a free list
+// that allocation draws from before growing the file)
+// Leaves hold whole task records in id order; internal pages hold separator ids
+// and child page numbers, so reading, adding, changing or deleting one task
+// touches one page per tree level (three levels cover tens of millions of tasks)
+// Descriptions longer than PAGED_INLINE_DESCRIPTION_LIMIT move to overflow pages
+// Pages are read through an LRU cache of PAGED_CACHE_PAGES pages. Changed pages stay
+// cached until the commit, which makes them durable through a redo journal
+// (tasks.db-journal): their new images are written, checksummed and fsynced there
+// first, then copied into tasks.db. A crash before the journal is complete leaves
+// tasks.db untouched; a complete journal is replayed when the store is next opened
+// Pages that shrink are not merged; an emptied page is freed, and the full rewrite
+// (saveTasks, e.g. from `compact`) packs every page again
+// Integers are stored in native byte order (like tasks.bin)
+
+// Size of every page in tasks.db
+const size_t PAGED_PAGE_SIZE = 4096;
+// Pages the cache keeps (2 MiB); a commit may hold more until its changed pages are written
+const size_t PAGED_CACHE_PAGES = 512;
+// Descriptions up to this many bytes are stored inside their leaf record
+const size_t PAGED_INLINE_DESCRIPTION_LIMIT = 1024;
+
+// Header at the start of page 0
+struct PagedStoreHeader {
+    char magic[8]; // "TASKDB01"
+    uint32_t version; // Format version (currently 1)
+    uint32_t pageSize; // PAGED_PAGE_SIZE, to detect layout mismatches
+    uint32_t pageCount; // Pages in the file, header included
+    uint32_t rootPage; // Root of the tree (a leaf while treeHeight is 1)
+    uint32_t treeHeight; // Levels in the tree, leaves included
+    uint32_t freeListHead; // First free page, 0 if there is none
+    uint32_t freePageCount; // Pages on the free list
+    int32_t nextId; // Next task id to hand out
+    uint64_t taskCount; // Tasks in the tree
+    uint8_t reserved[80]; // Room for future header fields
+};
+
+// Leaf record header (32 bytes), followed by the description unless it overflowed
+struct PagedTaskCell {
+    int32_t id;
+    uint8_t status; // TaskStatus value
+    uint8_t flags; // CELL_OVERFLOW
+    uint16_t reserved;
+    uint32_t descriptionLength; // Bytes of the description
+    uint32_t overflowPage; // First page of the description's overflow chain (CELL_OVERFLOW)
+    int64_t createdAt; // Nanoseconds since the epoch
+    int64_t updatedAt; // Nanoseconds since the epoch
+};
+
+// Cell flag: the description lives in an overflow chain, not after the cell
+const uint8_t CELL_OVERFLOW = 0x01;
+
+/**
+ * \@brief Checks whether a paged task store exists in the working directory
+ * \@return True if tasks.db exists
+ */
+bool pagedStoreExists();
+
+/**
+ * \@brief Loads every task from tasks.db by walking the tree's leaves in id order
+ * Replays a complete journal left by an interrupted commit first
+ * \@param nextId Output parameter: the stored next-id counter
+ * \@return The tasks in id order. Returns empty vector if the file is missing or invalid
+ */
+std::vector<Task> loadPagedTasks(int& nextId);
+
+/**
+ * \@brief Reads one task from tasks.db through the tree, without loading the others
+ * \@param id The ID of the task to find
+ * \@param task Output parameter: the task, if found
+ * \@return True if the store holds a task with this id
+ */
+bool findPagedTask(int id, Task& task);
+
+/**
+ * \@brief Writes a complete, tightly packed tasks.db (via a temporary file and rename)
+ * Leaves are filled in id order and the internal levels built on top of them
+ * \@param ordered The tasks to store, in any order
+ * \@param nextId The next-id counter to store in the header
+ * \@return True on success, false otherwise
+ */
+bool savePagedTasks(std::vector<const Task*> ordered, int nextId);
+
+/**
+ * \@brief Applies individual changes to tasks.db, touching only the pages on their paths
+ * Additions and updates go through a B+tree insert, deletions through a B+tree erase;
+ * all of the changed pages are committed together through the journal
+ * \@param changes The changes to apply, in order
+ * \@param nextId The current next-id counter, stored in the header
+ * \@return False if tasks.db is missing or cannot be updated (the caller should
+ * rewrite the whole file with savePagedTasks), true otherwise
+ */
+bool applyPagedChanges(const std::vector<TaskChange>& changes, int nextId);
+
+#endif // BTREE_STORE_H
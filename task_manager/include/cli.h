@@ -0,0 +1,58 @@
+#ifndef CLI_H
+#define CLI_H
+
+#include <vector>
+#include <string>
+#include <istream>
+#include "task_list.h"
+
+// Outcome of running one task-cli command
+struct CommandResult {
+    int exitCode; // Exit code the command maps to when run on its own
+    bool succeeded; // False if the command failed, including "task not found"
+    bool modified; // True if the tasks changed and need to be committed
+
+    CommandResult() : exitCode(0), succeeded(true), modified(false) {}
+};
+
+/**
+ * \@brief Prints usage instructions to stderr
+ * \@param progName The program name to show
+ */
+void printUsage(const char* progName);
+
+/**
+ * \@brief Runs one command (e.g. {"add", "Buy milk"}) against the in-memory tasks
+ * Does not load or persist anything; the caller commits if result.modified is set
+ * \@param tasks The list of tasks (may be modified)
+ * \@param args The command and its arguments, without the program name
+ * \@param progName The program name, for usage messages
+ * \@return The outcome of the command
+ */
+CommandResult executeCommand(TaskList& tasks, const std::vector<std::string>& args, const char* progName);
+
+/**
+ * \@brief Splits a command line into arguments the way a POSIX shell would for simple input
+ * Whitespace separates arguments; single quotes keep text literally; double quotes
+ * group text and allow \" and \\ escapes; a backslash outside quotes escapes the next character
+ * \@param line The line to split
+ * \@param args Output parameter: the arguments
+ * \@param error Output parameter: a description of the problem if splitting fails
+ * \@return True on success, false on unbalanced quotes
+ */
+bool splitCommandLine(const std::string& line, std::vector<std::string>& args, std::string& error);
+
+/**
+ * \@brief Runs newline-delimited commands against one in-memory task list
+ * Blank lines and lines starting with '#' are skipped. Each command reports
+ * "Line N: ok" or "Line N: failed"; all changes are committed once at the end
+ * \@param tasks The list of tasks (may be modified)
+ * \@param input Where to read the commands from
+ * \@param progName The program name, for usage messages
+ * \@param saveFailed Output parameter, if not null: set if the commit failed (the
+ * changes are still recorded; see discardTaskChanges)
+ * \@return 0 if every command succeeded and the changes were saved, 1 otherwise
+ */
+int runBatch(TaskList& tasks, std::istream& input, const char* progName, bool* saveFailed = nullptr);
+
+#endif // CLI_H
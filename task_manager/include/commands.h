@@ -1,52 +1,162 @@
-#ifndef COMMANDS_H
-#define COMMANDS_H
-
-#include <vector>
-#include <string>
-#include "task.h" // Include the Task struct definition
-
-// --- Function prototypes for task commands ---
-// These functions operate directly on the provided vector of tasks
-
-
-/**
- * \@brief Adds a new task to the task list 
- * \@param tasks The vector of tasks (will be modified)
- * \@param definition The description for the new task
- */
-void addTask(std::vector<Task>& tasks, const std::string& description);
-
-/**
- * \@brief Updates the description of an existing task
- * \@param tasks The vector of tasks (will be modified)
- * \@param id The ID of the task to update 
- * \@param newDescription The new description for the task
- * \@return True if the task was found and updated, false otherwise
- */
-bool updateTask(std::vector<Task>& tasks, int id, const std::string& newDescription);
-
-/**
- * \@brief Deletes a task from the list by its ID
- * \@param tasks The vector of tasks (will be modified)
- * \@param id The ID of the task to delete 
- * \@return True if the task was found and deleted, false otherwise 
- */
-bool deleteTask(std::vector<Task>& tasks, int id);
-
-/**
- * \@brief Marks the status of an existing task
- * \@param tasks The vector of tasks (will be modified)
- * \@param id The ID of the task to mark
- * \@param status The new status for the task
- * \@return True if the task was found and its status updated, false otherwise 
- */
-bool markTaskStatus(std::vector<Task>& tasks, int id, TaskStatus status);
-
-/**
- * \@brief Lists tasks, optionally filtering by status
- * \@param tasks The vector of tasks to list 
- * \@param filterStatus The status to filter by ("todo", "in progress", "done", or empty string for all)
- */
-void listTasks(const std::vector<Task>& tasks, const std::string& filterStatus);
-
+#ifndef COMMANDS_H
+#define COMMANDS_H
+
+#include <vector>
+#include <string>
+#include <utility> // For std::pair
+#include "task.h" // Include the Task struct definition
+#include "task_list.h" // Include the TaskList container
+#include "task_table.h" // Include the TaskTable container
+#include "query.h" // For TaskQuery (list --where)
+
+// Orders the list command can sort by
+enum class ListSortKey {
+    NONE, // Insertion order (the default)
+    ID,
+    CREATED,
+    UPDATED
+};
+
+// Options of the list command
+struct ListOptions {
+    std::string filterStatus; // "todo", "in-progress", "done", or empty for all
+    TaskQuery where; // Compiled --where expression (empty: every task)
+    size_t offset; // Matching tasks to skip
+    size_t limit; // Most tasks to show (0 = no limit)
+    ListSortKey sortKey; // Ascending; ties are broken by id
+
+    ListOptions() : offset(0), limit(0), sortKey(ListSortKey::NONE) {}
+};
+
+// Tasks a bulk command applies to: ids (mark-done 3,7,9), id ranges
+// (mark-done 10-500), both mixed, or every task with a status (delete --status done)
+struct TaskSelection {
+    std::vector<int> ids; // Listed one by one; reported if there is no such task
+    std::vector<std::pair<int, int>> ranges; // Inclusive; ids without a task are skipped silently
+    bool byStatus; // Select by status instead of by id
+    TaskStatus status; // The status to select (if byStatus)
+
+    TaskSelection() : byStatus(false), status(TaskStatus::TODO) {}
+};
+
+// Outcome of a bulk command
+struct BulkResult {
+    size_t affected; // Tasks deleted or changed
+    size_t unchanged; // Selected tasks that already had the requested status
+    size_t missing; // Listed ids with no task
+
+    BulkResult() : affected(0), unchanged(0), missing(0) {}
+};
+
+// --- Function prototypes for task commands ---
+// These functions operate directly on the provided list of tasks
+// They are templates over the container: Tasks is TaskList (the default,
+// array of Task records) or TaskTable (struct of arrays); both are
+// instantiated in commands.cpp
+
+
+/**
+ * \@brief Adds a new task to the task list 
+ * \@param tasks The list of tasks (will be modified)
+ * \@param definition The description for the new task
+ */
+template <typename Tasks>
+void addTask(Tasks& tasks, const std::string& description);
+
+/**
+ * \@brief Finds a task by ID using the list's id index (O(1))
+ * \@param tasks The list of tasks to search within
+ * \@param id The ID of the task to find
+ * \@return A pointer to the found task, or nullptr if not found
+ */
+Task* findTaskById(TaskList& tasks, int id);
+
+/**
+ * \@brief Updates the description of an existing task
+ * \@param tasks The list of tasks (will be modified)
+ * \@param id The ID of the task to update 
+ * \@param newDescription The new description for the task
+ * \@return True if the task was found and updated, false otherwise
+ */
+template <typename Tasks>
+bool updateTask(Tasks& tasks, int id, const std::string& newDescription);
+
+/**
+ * \@brief Deletes a task from the list by its ID
+ * \@param tasks The list of tasks (will be modified)
+ * \@param id The ID of the task to delete 
+ * \@return True if the task was found and deleted, false otherwise 
+ */
+template <typename Tasks>
+bool deleteTask(Tasks& tasks, int id);
+
+/**
+ * \@brief Marks the status of an existing task
+ * \@param tasks The list of tasks (will be modified)
+ * \@param id The ID of the task to mark
+ * \@param status The new status for the task
+ * \@return True if the task was found and its status updated, false otherwise 
+ */
+template <typename Tasks>
+bool markTaskStatus(Tasks& tasks, int id, TaskStatus status);
+
+/**
+ * \@brief Deletes every selected task in one pass over the list
+ * \@param tasks The list of tasks (will be modified)
+ * \@param selection Which tasks to delete
+ * \@return How many tasks were deleted, and how many listed ids had no task
+ */
+template <typename Tasks>
+BulkResult deleteTasks(Tasks& tasks, const TaskSelection& selection);
+
+/**
+ * \@brief Sets the status of every selected task
+ * Tasks that already have the status are left alone (and not rewritten)
+ * \@param tasks The list of tasks (will be modified)
+ * \@param selection Which tasks to mark
+ * \@param status The new status
+ * \@return How many tasks changed, were already marked, or were missing
+ */
+template <typename Tasks>
+BulkResult markTasksStatus(Tasks& tasks, const TaskSelection& selection, TaskStatus status);
+
+/**
+ * \@brief Drops the tombstones deleted tasks left behind in memory
+ * Deletes only mark their row; compaction moves the live tasks down so the
+ * dead rows stop costing scans and memory (it also runs on its own past a threshold)
+ * \@param tasks The list of tasks (will be modified; rows are renumbered)
+ * \@return The number of tombstones removed
+ */
+template <typename Tasks>
+size_t compactTasks(Tasks& tasks);
+
+/**
+ * \@brief Lists tasks, optionally filtering by status
+ * \@param tasks The list of tasks to list 
+ * \@param filterStatus The status to filter by ("todo", "in progress", "done", or empty string for all)
+ */
+template <typename Tasks>
+void listTasks(Tasks& tasks, const std::string& filterStatus);
+
+/**
+ * \@brief Lists one page of tasks, optionally filtered and sorted
+ * A --where query picks its rows through the most selective index (see TaskQuery).
+ * Only the first offset + limit tasks in sort order are ordered (partial sort),
+ * and rows are formatted into one buffer that is written in large chunks
+ * \@param tasks The list of tasks to list (a desc~ query may build its search index)
+ * \@param options Status filter, --where query, sort key and page
+ */
+template <typename Tasks>
+void listTasks(Tasks& tasks, const ListOptions& options);
+
+/**
+ * \@brief Lists the tasks whose descriptions contain every word of the query
+ * Uses the list's inverted index instead of scanning every description
+ * \@param tasks The list of tasks to search (its search index may be built on first use)
+ * \@param query The words to look for; matched whole and case-insensitively
+ * \@return The number of matching tasks
+ */
+template <typename Tasks>
+size_t searchTasks(Tasks& tasks, const std::string& query);
+
 #endif // COMMANDS_H
\ No newline at end of file
@@ -0,0 +1,44 @@
+#ifndef DAEMON_H
+#define DAEMON_H
+
+#include <vector>
+#include <string>
+#include "task_list.h"
+
+// --- task-cli daemon (task-cli serve) ---
+// Keeps the task list resident and serves commands over the Unix socket tasks.sock
+// in the working directory, so clients skip loading and parsing the store entirely.
+// Writes are group-committed: every request that arrives in the same poll round is
+// executed, the changes are committed once, and only then are the replies sent.
+//
+// Wire format (native byte order, the socket never leaves the machine):
+//   request:  u32 argCount, argCount x (u32 length, bytes), u32 inputLength, input bytes
+//   response: i32 exitCode, u32 stdoutLength, stdout bytes, u32 stderrLength, stderr bytes
+// The input is the command script for 'batch' and empty otherwise.
+
+/**
+ * \@brief Runs the daemon until SIGINT or SIGTERM
+ * \@param tasks The loaded task list; it stays resident for the daemon's lifetime
+ * \@param progName The program name, for usage messages
+ * \@return Exit code for the process
+ */
+int runDaemon(TaskList& tasks, const char* progName);
+
+/**
+ * \@brief Checks whether a daemon is listening on tasks.sock in the working directory
+ * A running daemon holds the store lock, so serve checks this before waiting for it
+ * \@return True if a daemon accepted a connection
+ */
+bool daemonRunning();
+
+/**
+ * \@brief Sends a command to a running daemon and relays its output
+ * \@param args The command and its arguments, without the program name
+ * \@param input The batch script for 'batch', empty otherwise
+ * \@param exitCode Output parameter: the command's exit code, if it was forwarded
+ * \@return True if a daemon handled the command, false if none is running
+ * (the caller should run the command itself)
+ */
+bool forwardToDaemon(const std::vector<std::string>& args, const std::string& input, int& exitCode);
+
+#endif // DAEMON_H
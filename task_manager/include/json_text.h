@@ -0,0 +1,42 @@
+#ifndef JSON_TEXT_H
+#define JSON_TEXT_H
+
+#include <string>
+#include <cstddef>
+
+// --- JSON string escaping ---
+// Both directions scan 16 bytes at a time (SSE2, or 32 with AVX2 when the CPU
+// has it) for the few bytes that need attention and copy the clean runs between
+// them in bulk, so plain text costs little more than a memcpy
+
+/**
+ * \@brief Escapes a string for embedding in a JSON string value
+ * Uses the short escapes (\" \\ \b \f \n \r \t) where JSON has them and \u00XX
+ * for the other control characters; everything else, including UTF-8, is copied as is
+ * \@param input The string to escape
+ * \@return The escaped string (without surrounding quotes)
+ */
+std::string escapeJsonString(const std::string& input);
+
+/**
+ * \@brief Appends the escaped form of some text to a buffer
+ * \@param out The buffer to append to
+ * \@param data The text to escape
+ * \@param size Length of the text in bytes
+ */
+void appendJsonEscaped(std::string& out, const char* data, size_t size);
+
+/**
+ * \@brief Decodes the contents of a JSON string up to its closing quote
+ * Understands the full escape set, including \uXXXX (surrogate pairs are joined
+ * and written as UTF-8; an unpaired surrogate becomes U+FFFD). As in earlier
+ * versions of the loader, a backslash before any other character, or before a
+ * malformed \u escape, makes that character literal
+ * \@param pos The cursor, just past the opening quote (advanced past the closing quote on success)
+ * \@param end One past the last character of the buffer
+ * \@param out Output parameter: the decoded text is appended to it
+ * \@return True if the closing quote was found, false if the input ended first
+ */
+bool readJsonStringBody(const char*& pos, const char* end, std::string& out);
+
+#endif // JSON_TEXT_H
@@ -0,0 +1,140 @@
+#ifndef LSM_STORE_H
+#define LSM_STORE_H
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+#include "task.h"
+#include "storage.h" // For TaskChange
+
+// --- Log-structured task store (tasks.lsm) ---
+// Stored tasks are never rewritten in place. A commit appends its changes to a
+// write-ahead log (tasks.lsm-NNNNNN.wal) and applies them to the memtable: an
+// in-memory map, sorted by id, from each changed task to its newest state or a
+// deletion marker. Once the log passes LSM_MEMTABLE_FLUSH_BYTES, the memtable is
+// written out in id order as a new immutable run (tasks.lsm-NNNNNN.run) and a
+// fresh, empty log is started
+// A run is a sequence of blocks of about LSM_BLOCK_BYTES, followed by a sparse
+// index (the first and last id of every block) and a bloom filter over its ids.
+// Both stay in memory while the store is open, so a point read skips every run
+// that cannot hold the id and reads at most one block of each one that may
+// The manifest (tasks.lsm) names the live runs, newest first, the current log and
+// the next-id counter; it is replaced by rename, which is what makes a flush or a
+// merge take effect. A read checks the memtable, then the runs from newest to
+// oldest, and the first state it finds for an id wins
+// Once there are more than LSM_MAX_RUNS runs, a background thread merges them into
+// one, dropping overwritten states and deletion markers, while commits go on;
+// closeLsmStore (called when the store lock is released) waits for it to finish
+// Integers are stored in native byte order (like tasks.bin)
+
+// Target size of a block in a run; a block ends at the first record past it
+const size_t LSM_BLOCK_BYTES = 4096;
+// The memtable is flushed to a run once its log grows past this many bytes
+const uint64_t LSM_MEMTABLE_FLUSH_BYTES = 256 * 1024;
+// More runs than this are merged into one in the background
+const size_t LSM_MAX_RUNS = 4;
+// Bloom filter bits per id in a run (about 1% false positives)
+const size_t LSM_BLOOM_BITS_PER_KEY = 10;
+
+// The manifest (tasks.lsm): this header, then runCount run numbers, newest first
+struct LsmManifestHeader {
+    char magic[8]; // "TASKLSM1"
+    uint32_t version; // Format version (currently 1)
+    uint32_t runCount; // Run numbers that follow
+    int32_t nextId; // Next task id to hand out, as of the last flush
+    uint32_t nextFileNumber; // Number the next run or log file gets
+    uint32_t walNumber; // Number of the current log file
+    uint32_t crc; // CRC-32 of the header (this field zeroed) and the run numbers
+};
+
+// Record header in a run block or a log frame, followed by the description
+struct LsmRecordHeader {
+    int32_t id;
+    uint8_t kind; // LSM_RECORD_PUT or LSM_RECORD_DELETE
+    uint8_t status; // TaskStatus value
+    uint16_t reserved;
+    uint32_t descriptionLength; // Bytes of the description (0 for a deletion)
+    uint32_t reserved2;
+    int64_t createdAt; // Nanoseconds since the epoch
+    int64_t updatedAt; // Nanoseconds since the epoch
+};
+
+// Record kinds: the task's new state, or a marker that it was deleted
+const uint8_t LSM_RECORD_PUT = 1;
+const uint8_t LSM_RECORD_DELETE = 2;
+
+// Sparse index entry of a run: one per block
+struct LsmIndexEntry {
+    int32_t firstId; // Lowest id in the block
+    int32_t lastId; // Highest id in the block
+    uint64_t offset; // Where the block starts (it ends where the next one, or the index, starts)
+};
+
+// Footer at the end of a run file
+struct LsmRunFooter {
+    char magic[8]; // "TASKRUN1"
+    uint64_t indexOffset; // Where the blocks end and the index starts
+    uint64_t recordCount; // Records in the run, deletion markers included
+    uint32_t blockCount; // Index entries
+    uint32_t bloomBytes; // Bytes of the bloom filter, which follows the index
+    uint32_t bloomHashes; // Bits set per id
+    uint32_t crc; // CRC-32 of the index and the bloom filter
+};
+
+// Header of one commit's frame in the log, followed by its records
+struct LsmWalFrame {
+    uint32_t length; // Bytes of records after the header
+    uint32_t crc; // CRC-32 of nextId, recordCount and the records
+    int32_t nextId; // The next-id counter after this commit
+    uint32_t recordCount; // Records that follow
+};
+
+/**
+ * \@brief Checks whether an LSM task store exists in the working directory
+ * \@return True if tasks.lsm exists
+ */
+bool lsmStoreExists();
+
+/**
+ * \@brief Loads every task by merging the runs and the memtable, newest state first
+ * Opens the store and keeps it open for the commits and reads that follow
+ * \@param nextId Output parameter: the stored next-id counter
+ * \@return The live tasks in id order. Returns empty vector if the store is missing or invalid
+ */
+std::vector<Task> loadLsmTasks(int& nextId);
+
+/**
+ * \@brief Reads one task through the memtable, bloom filters and sparse indexes
+ * \@param id The ID of the task to find
+ * \@param task Output parameter: the task, if found
+ * \@return True if the store holds a live task with this id
+ */
+bool findLsmTask(int id, Task& task);
+
+/**
+ * \@brief Replaces the whole store with a single run of the given tasks and an empty log
+ * Waits for a background merge first; the old runs and log are deleted afterwards
+ * \@param ordered The tasks to store, in any order
+ * \@param nextId The next-id counter to store in the manifest
+ * \@return True on success, false otherwise
+ */
+bool saveLsmTasks(std::vector<const Task*> ordered, int nextId);
+
+/**
+ * \@brief Appends changes to the log and the memtable, flushing it to a run when it is full
+ * May start a background merge of the runs
+ * \@param changes The changes to apply, in order
+ * \@param nextId The current next-id counter
+ * \@return False if the store is missing or cannot be updated (the caller should
+ * rewrite it with saveLsmTasks), true otherwise
+ */
+bool applyLsmChanges(const std::vector<TaskChange>& changes, int nextId);
+
+/**
+ * \@brief Waits for a background merge and closes the store
+ * The next call opens it from disk again
+ */
+void closeLsmStore();
+
+#endif // LSM_STORE_H
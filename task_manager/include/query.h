@@ -0,0 +1,112 @@
+#ifndef QUERY_H
+#define QUERY_H
+
+#include <vector>
+#include <string>
+#include <cstddef>
+#include "task_list.h" // For TaskList
+#include "task_table.h" // For TaskTable
+#include "time_index.h" // For TimeField
+
+/**
+ * \@brief A compiled `list --where` expression
+ * Grammar (keywords are case-insensitive):
+ *   expr       := term ("or" term)*
+ *   term       := factor ("and" factor)*
+ *   factor     := "not" factor | "(" expr ")" | comparison
+ *   comparison := field op value
+ *   field      := status | id | created | updated | desc
+ *   op         := = != < <= > >=   (desc takes ~: contains every word)
+ * Values are bare words or "quoted strings". Times are "YYYY-MM-DD HH:MM:SS",
+ * a date, which stands for the whole day (created=2025-01-01 matches that day,
+ * created>2025-01-01 starts the day after), or an age counted back from now:
+ * a number and s, m, h, d or w (updated>=24h is "updated in the last day")
+ *
+ * The text is parsed once into a predicate tree. select() then asks each index
+ * that applies (status bitmaps, the id index, the search index, the time indexes)
+ * how many rows it would yield, takes the candidates from the smallest and checks
+ * only those against the whole tree, so the cost follows the matches rather than
+ * the list. The search and time indexes are only asked once they exist (in the
+ * daemon, or after an earlier query); building one just for an estimate would cost
+ * more than the scan it may save, so it is built only for the operand the plan picks
+ * when nothing cheaper applies
+ */
+class TaskQuery {
+public:
+    /**
+     * \@brief Parses an expression
+     * \@param text The expression
+     * \@param query Output parameter: the compiled query
+     * \@param error Output parameter: what was wrong, if parsing fails
+     * \@return True on success
+     */
+    static bool compile(const std::string& text, TaskQuery& query, std::string& error);
+
+    /**
+     * \@brief Narrows the query to tasks with a timestamp at or after (or at or before) a time
+     * Backs list --since/--until; the bound is ANDed with the rest of the query
+     * \@param field The timestamp to bound
+     * \@param lower True for "at or after value", false for "at or before value"
+     * \@param value The time, in any form a comparison accepts
+     * \@param error Output parameter: what was wrong, if the time is invalid
+     * \@return True on success
+     */
+    bool addTimeBound(TimeField field, bool lower, const std::string& value, std::string& error);
+
+    /**
+     * \@brief Whether the query is empty (matches every task)
+     */
+    bool empty() const { return nodes.empty(); }
+
+    /**
+     * \@brief Finds the rows of the live tasks the query matches
+     * \@param tasks The tasks to query (the search index may be built on first use)
+     * \@return Row numbers, in insertion order
+     */
+    template <typename Tasks>
+    std::vector<size_t> select(Tasks& tasks) const;
+
+private:
+    enum class NodeKind {
+        AND, OR, NOT, // Operators over children
+        STATUS, ID, CREATED, UPDATED, // Key in [low, high), or outside it if negated
+        TEXT // Description contains every term
+    };
+
+    struct Node {
+        NodeKind kind;
+        std::vector<size_t> children; // Indexes into nodes
+        long long low; // Inclusive
+        long long high; // Exclusive
+        bool negated;
+        std::string text; // TEXT: the words as written, for the search index
+        std::vector<std::string> terms; // TEXT: tokenized, for checking one row
+
+        explicit Node(NodeKind kind) : kind(kind), low(0), high(0), negated(false) {}
+    };
+
+    // How a node can produce candidate rows without a scan
+    struct Access {
+        bool indexed; // False: only a scan can find its rows
+        bool estimated; // False: an index it needs is not built yet, so the estimate is unknown
+        size_t estimate; // Upper bound on the rows it yields (if indexed and estimated)
+        size_t child; // AND: the child whose index is used
+    };
+
+    class Parser;
+
+    static TimeField timeField(NodeKind kind);
+
+    template <typename Tasks>
+    Access plan(Tasks& tasks, size_t node) const;
+    template <typename Tasks>
+    void buildIndexes(Tasks& tasks, size_t node) const;
+    template <typename Tasks>
+    void indexRows(Tasks& tasks, size_t node, std::vector<size_t>& rows) const;
+    template <typename Tasks>
+    bool matches(const Tasks& tasks, size_t node, size_t row) const;
+
+    std::vector<Node> nodes; // Children before parents; the root is last
+};
+
+#endif // QUERY_H
@@ -0,0 +1,72 @@
+#ifndef SEARCH_INDEX_H
+#define SEARCH_INDEX_H
+
+#include <vector>
+#include <string>
+#include <unordered_map>
+
+/**
+ * \@brief Inverted index over task descriptions: term -> sorted list of task ids
+ * Terms are runs of letters and digits, lowercased (ASCII); bytes outside ASCII
+ * count as letters so UTF-8 words stay whole. A query matches the tasks that
+ * contain every one of its terms as a whole word, found by intersecting the
+ * posting lists from the shortest up, so lookups cost time proportional to the
+ * postings involved rather than to the number of tasks
+ */
+class SearchIndex {
+public:
+    /**
+     * \@brief Splits text into its distinct, lowercased terms
+     * \@param text The text to split
+     * \@param terms Output parameter: the terms, sorted and without duplicates
+     */
+    static void tokenize(const std::string& text, std::vector<std::string>& terms);
+
+    /**
+     * \@brief Indexes a task's description
+     * \@param id The task's ID (must not be indexed yet)
+     * \@param description The description to index
+     */
+    void add(int id, const std::string& description);
+
+    /**
+     * \@brief Removes a task's postings
+     * \@param id The task's ID
+     * \@param description The description it was indexed with
+     */
+    void remove(int id, const std::string& description);
+
+    /**
+     * \@brief Finds the tasks containing all of the given terms
+     * \@param query The search text (tokenized the same way as descriptions)
+     * \@return Matching task ids in ascending order (empty if the query has no terms)
+     */
+    std::vector<int> search(const std::string& query) const;
+
+    /**
+     * \@brief Upper bound on the number of matches of a query, in O(terms)
+     * \@param query The search text
+     * \@return Length of the shortest posting list among the query's terms (0 if one is absent)
+     */
+    size_t estimate(const std::string& query) const;
+
+    /**
+     * \@brief Checks one text for every term without the index (same word rules as search)
+     * \@param data The text to check
+     * \@param size Length of the text
+     * \@param terms Tokenized query terms (as produced by tokenize)
+     * \@return True if the text contains each term as a whole word
+     */
+    static bool containsAll(const char* data, size_t size, const std::vector<std::string>& terms);
+
+    /**
+     * \@brief Number of distinct terms in the index
+     */
+    size_t termCount() const { return postings.size(); }
+
+private:
+    std::unordered_map<std::string, std::vector<int>> postings; // Term -> ascending task ids
+    std::vector<std::string> scratchTerms; // Reused by add/remove to avoid reallocating
+};
+
+#endif // SEARCH_INDEX_H
@@ -0,0 +1,81 @@
+#ifndef STATS_H
+#define STATS_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+// --- Per-invocation instrumentation (task-cli --stats) ---
+// Phases are timed wherever the work happens (storage.cpp, binary_store.cpp,
+// main.cpp) and summed per phase; heap allocations are counted by the
+// replacement operator new in stats.cpp, for every allocation in the process
+
+// Phases of one invocation; each timed region belongs to exactly one
+enum class StatsPhase {
+    LOCK, // Waiting for the store lock
+    READ, // Reading files into memory
+    PARSE, // Turning file contents into tasks
+    COMMAND, // Running the command(s) against the in-memory tasks
+    SERIALIZE, // Turning tasks or changes into file contents
+    WRITE, // Writing files (including rename)
+    PHASE_COUNT
+};
+
+/**
+ * \@brief Times a region and adds it to a phase when the object goes out of scope
+ */
+class PhaseTimer {
+public:
+    explicit PhaseTimer(StatsPhase phase) : phase(phase), start(std::chrono::steady_clock::now()) {}
+    ~PhaseTimer();
+    PhaseTimer(const PhaseTimer&) = delete;
+    PhaseTimer& operator=(const PhaseTimer&) = delete;
+
+private:
+    StatsPhase phase;
+    std::chrono::steady_clock::time_point start;
+};
+
+/**
+ * \@brief Adds time to a phase (for regions not covered by a PhaseTimer)
+ */
+void addPhaseTime(StatsPhase phase, std::chrono::steady_clock::duration elapsed);
+
+/**
+ * \@brief Counts bytes read from or written to the task files
+ */
+void addBytesRead(size_t bytes);
+void addBytesWritten(size_t bytes);
+
+/**
+ * \@brief Records the number of tasks the invocation ended with
+ */
+void setStatsTaskCount(size_t count);
+
+/**
+ * \@brief Starts counting heap allocations (off by default: the shared counters
+ * would be contended when several threads allocate, e.g. while parsing)
+ * Call before any other threads start
+ */
+void enableAllocationCounting();
+
+// Heap allocations made through operator new since counting was enabled
+struct AllocationStats {
+    uint64_t count; // Calls to operator new / new[]
+    uint64_t bytes; // Bytes requested by those calls
+};
+
+/**
+ * \@brief Reads the allocation counters
+ */
+AllocationStats currentAllocations();
+
+/**
+ * \@brief Prints the phase times, byte counts, task count and allocations
+ * \@param out Where to print (task-cli uses stderr so stdout stays parseable)
+ * \@param total Wall time of the whole invocation
+ */
+void printStats(std::ostream& out, std::chrono::steady_clock::duration total);
+
+#endif // STATS_H
@@ -1,17 +1,125 @@
-#ifndef STORAGE_H
-#define STORAGE_H
-
-#include <vector>
-#include <string> 
-#include "task.h"
-
-// Function to load tasks from the JSON file 
-// Returns a vector of tasks
-std::vector<Task> loadTasks();
-
-// Function to save tasks to the JSON file 
-// Takes a constant reference to a vector of tasks
-void saveTasks(const std::vector<Task>& tasks);
-
-
+#ifndef STORAGE_H
+#define STORAGE_H
+
+#include <vector>
+#include <string> 
+#include <iosfwd> // For std::ostream
+#include "task.h"
+#include "task_list.h"
+
+// Storage backends that can hold the task list
+enum class StorageBackend {
+    JSON, // tasks.json snapshot + tasks.log mutation log (default)
+    BINARY, // tasks.bin: memory-mapped fixed-width records + string heap
+    PAGED, // tasks.db: B+tree of 4 KiB pages keyed by id, changed page by page through a journal
+    LSM // tasks.lsm: write-ahead log + memtable, flushed to immutable sorted runs that merge in the background
+};
+
+// A single recorded change, waiting to be persisted by commitTasks
+struct TaskChange {
+    int id; // ID of the affected task
+    bool deleted; // True if the task was deleted, false if added or changed
+    Task task; // The task's new state (unused for deletions)
+};
+
+// How a process holds the store lock (tasks.lock)
+enum class StoreLockMode {
+    SHARED, // Read-only commands; any number of readers at once
+    EXCLUSIVE // Commands that change tasks; held from load through commit
+};
+
+// Function to determine the backend in use
+// Selected by the TASK_STORE environment variable ("json", "binary", "btree" or "lsm"),
+// otherwise lsm if tasks.lsm exists, btree if tasks.db exists, binary if tasks.bin
+// exists, and JSON if none does
+StorageBackend activeStorageBackend();
+
+// Function to load tasks from the JSON file 
+// Replays the mutation log (tasks.log) on top of it. If tasks.json fails its checksum,
+// rebuilds from the previous checkpoint (tasks.json.prev) and the logs written since
+// (or maps tasks.bin, walks the tree in tasks.db, or merges the runs of tasks.lsm,
+// for the other backends)
+// Returns the tasks together with their persisted next-id counter
+TaskList loadTasks();
+
+// Function to turn the "Loaded N task(s)" message of loadTasks off (or back on)
+// Commands whose stdout is data, such as export, load quietly
+void setLoadMessages(bool enabled);
+
+// Function to parse one flat JSON task object (as written by saveTasks) out of a buffer
+// pos must point at the '{' and is advanced past the '}' on success; keys that
+// are not Task fields are skipped, with a warning unless warnUnknownKeys is false
+// Warnings (unknown keys, unreadable timestamps) go to warnings, errors to error
+bool parseTaskObject(const char*& pos, const char* end, Task& task, std::string& error, std::ostream& warnings,
+                     bool warnUnknownKeys = true);
+
+// Function to limit how many threads parse a large tasks.json
+// 0 (the default) uses one per hardware thread; 1 parses on the calling thread
+void setParseThreadLimit(size_t threads);
+
+// Function to save tasks to the JSON file (or tasks.bin, tasks.db or tasks.lsm)
+// Writes a full, checksummed snapshot (a checkpoint) and starts a new mutation log;
+// the checkpoint it replaces is kept, with its log, for recovery
+// Takes a constant reference to the list of tasks
+// Returns true if the snapshot was written
+bool saveTasks(const TaskList& tasks);
+
+// Function to record that a task was added or changed
+// Buffered until commitTasks is called
+void recordTaskChange(const Task& task);
+
+// Function to record that a task was deleted
+// Buffered until commitTasks is called, which persists it as an O(1) tombstone: a
+// "D" record in tasks.log, a flagged slot in tasks.bin, or a deletion marker in the
+// lsm log; checkpoints, binary rewrites and merges drop them (see recordFullRewrite)
+void recordTaskDeletion(int id);
+
+// Function to record that the next commit should write a full snapshot
+// Keeps the changes recorded so far: a JSON checkpoint logs them first, so the
+// previous checkpoint and its log still lead to the new one (used by compact,
+// so the store drops its tombstones along with the list)
+void recordFullRewrite();
+
+// Function to record that every task with an id at or above firstId was added in bulk
+// Those tasks need not be recorded one by one: the next commit takes a checkpoint that
+// logs them from the list, so a large import holds no second copy of them
+void recordTasksAddedFrom(int firstId);
+
+// Function to persist the recorded changes
+// Appends them to the mutation log as checksummed records, or takes a checkpoint
+// (a fresh snapshot) once the log passes its size threshold
+// With the binary backend, rewrites the affected record slots in place;
+// with the btree backend, inserts into and erases from the tree page by page;
+// with the lsm backend, appends them to its log and memtable
+// Returns true once they are persisted; on failure they stay recorded
+bool commitTasks(const TaskList& tasks);
+
+// Function to drop the recorded changes without persisting them
+// For callers that keep running after a failed commit: the in-memory list no longer
+// matches the store, so they discard the changes and load the tasks again
+void discardTaskChanges();
+
+// Function to set the mutation log size at which commitTasks takes a checkpoint
+// 0 (the default) uses the larger of 64 KiB and a quarter of the snapshot; the
+// limit bounds how much log loadTasks replays after loading the checkpoint
+void setCheckpointLogLimit(long long bytes);
+
+// Function to take the advisory store lock (flock on tasks.lock)
+// Hold it exclusively from loadTasks through commitTasks, so concurrent
+// writers cannot hand out the same id or overwrite each other's changes
+// Retries with backoff while contended, reports the wait on stderr, and
+// gives up after a timeout. Returns true once the lock is held
+bool lockTaskStore(StoreLockMode mode);
+
+// Function to check whether loading may repair the store files, such as cutting a
+// torn record off the end of a log
+// False while only the shared lock is held: other readers may be loading the same
+// files, so a reader skips the damage in memory and leaves the repair to the next writer
+bool storeRepairAllowed();
+
+// Function to release the store lock (a no-op if it is not held)
+// Waits for a background merge of the lsm store first, so none outlives the lock
+void unlockTaskStore();
+
+
 #endif // STORAGE_H
\ No newline at end of file
@@ -0,0 +1,261 @@
+#ifndef TASK_LIST_H
+#define TASK_LIST_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <iterator>
+#include <unordered_map>
+#include <string>
+#include "task.h"
+#include "search_index.h"
+#include "time_index.h"
+
+/**
+ * \@brief In-memory task collection with an id -> position hash index
+ * Keeps tasks in insertion order (the order they are listed and saved in)
+ * while letting commands reach a task by id in O(1) instead of scanning
+ * Descriptions are also covered by a full-text index, built on the first search
+ * and kept current from then on, so a long-lived list (the daemon) pays for it once;
+ * the created and updated times get ordered indexes the same way, on the first
+ * time-range lookup
+ * A bitmap per status (bit i set if the task at position i has that status)
+ * lets status filters skip non-matching tasks 64 at a time and keeps O(1) counts
+ * Change descriptions and statuses through updateDescription and updateStatus
+ * so the indexes stay in sync
+ *
+ * Rows: the commands reach tasks through row numbers (0..slotCount()-1, in insertion
+ * order) and per-field accessors, an interface TaskTable shares, so they run
+ * against either representation
+ *
+ * Deletes leave a tombstone: the row keeps its slot but drops out of the id index,
+ * the status bitmaps and the search index, so nothing after it moves. Rows past a
+ * tombstone keep their numbers until compact() squeezes the tombstones out, which
+ * happens on its own once they pass the TOMBSTONE_COMPACT_* threshold
+ */
+class TaskList {
+public:
+    TaskList() = default;
+
+    /**
+     * \@brief Takes ownership of loaded tasks and builds the id index
+     * \@param tasks The tasks, in the order they were loaded
+     * \@param nextId The persisted next-id counter; it is raised past the highest
+     * loaded id if needed, so files without a counter migrate transparently
+     */
+    explicit TaskList(std::vector<Task> tasks, int nextId = 0);
+
+    /**
+     * \@brief The id the next added task should get
+     * Only ever grows, so the id of a deleted task is never handed out again
+     */
+    int nextId() const { return nextIdCounter; }
+
+    /**
+     * \@brief Number of live tasks (tombstones excluded)
+     */
+    size_t size() const { return items.size() - tombstones; }
+    bool empty() const { return size() == 0; }
+
+    /**
+     * \@brief Number of rows, live or tombstoned; rows are numbered 0..slotCount()-1
+     */
+    size_t slotCount() const { return items.size(); }
+
+    /**
+     * \@brief Number of deleted rows not yet compacted away
+     */
+    size_t tombstoneCount() const { return tombstones; }
+
+    /**
+     * \@brief Whether a row still holds a task (false for tombstones)
+     * A tombstone keeps its status field but has its status bit cleared
+     */
+    bool isLive(size_t row) const {
+        return (statusBits[static_cast<size_t>(items[row].status)][row / 64] >> (row % 64)) & 1;
+    }
+
+    /**
+     * \@brief The rows of every live task, in insertion order
+     * \@return Row numbers (valid until the list is next modified)
+     */
+    std::vector<size_t> liveRows() const;
+
+    /**
+     * \@brief Drops the tombstones, moving the live tasks down and renumbering their rows
+     * \@return Number of tombstones removed
+     */
+    size_t compact();
+
+    /**
+     * \@brief Iterates the live tasks in insertion order, stepping over tombstones
+     */
+    class const_iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Task;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Task*;
+        using reference = const Task&;
+
+        const_iterator(const TaskList* list, size_t row) : list(list), row(row) { skipTombstones(); }
+        reference operator*() const { return list->items[row]; }
+        pointer operator->() const { return &list->items[row]; }
+        const_iterator& operator++() { ++row; skipTombstones(); return *this; }
+        const_iterator operator++(int) { const_iterator old = *this; ++*this; return old; }
+        bool operator==(const const_iterator& other) const { return row == other.row; }
+        bool operator!=(const const_iterator& other) const { return row != other.row; }
+
+    private:
+        void skipTombstones() {
+            while (row < list->items.size() && !list->isLive(row)) {
+                ++row;
+            }
+        }
+
+        const TaskList* list;
+        size_t row;
+    };
+
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, items.size()); }
+
+    /**
+     * \@brief Looks up a task by id
+     * \@param id The ID of the task to find
+     * \@return Pointer to the task, or nullptr if there is none with this id
+     */
+    Task* find(int id);
+    const Task* find(int id) const;
+
+    /**
+     * \@brief Appends a task and indexes it, advancing the next-id counter past its id
+     * \@param task The task to add (its id must not be in the list yet)
+     * \@return Reference to the stored task
+     */
+    Task& add(Task task);
+
+    /**
+     * \@brief Removes a task by id, leaving a tombstone in its row
+     * \@param id The ID of the task to remove
+     * \@return True if the task was found and removed, false otherwise
+     */
+    bool remove(int id);
+
+    /**
+     * \@brief Removes many tasks, leaving a tombstone in each of their rows
+     * \@param rows The rows to remove (live), ascending and without duplicates
+     */
+    void removeRows(const std::vector<size_t>& rows);
+
+    /**
+     * \@brief Replaces a task's description, keeping the search index in sync
+     * \@param id The ID of the task to change
+     * \@param description The new description
+     * \@param updatedAt The new last-update time
+     * \@return True if the task was found and changed, false otherwise
+     */
+    bool updateDescription(int id, const std::string& description, std::chrono::system_clock::time_point updatedAt);
+
+    /**
+     * \@brief Changes a task's status, keeping the status bitmaps and counts in sync
+     * \@param id The ID of the task to change
+     * \@param status The new status
+     * \@param updatedAt The new last-update time
+     * \@return True if the task was found and changed, false otherwise
+     */
+    bool updateStatus(int id, TaskStatus status, std::chrono::system_clock::time_point updatedAt);
+
+    /**
+     * \@brief Number of tasks with the given status, in O(1)
+     */
+    size_t countWithStatus(TaskStatus status) const { return statusCounts[static_cast<size_t>(status)]; }
+
+    /**
+     * \@brief The rows of the tasks with the given status, in insertion order
+     * Walks the status bitmap, so the cost is the result size plus one word per 64 tasks
+     * \@param status The status to select
+     * \@return Row numbers (valid until the list is next modified)
+     */
+    std::vector<size_t> rowsWithStatus(TaskStatus status) const;
+
+    /**
+     * \@brief Looks up the row of a task by id
+     * \@param id The ID of the task to find
+     * \@param row Output parameter: the task's row, if found
+     * \@return True if there is a task with this id
+     */
+    bool findRow(int id, size_t& row) const;
+
+    // --- Per-row field access (row < slotCount(), live rows only) ---
+    int idAt(size_t row) const { return items[row].id; }
+    TaskStatus statusAt(size_t row) const { return items[row].status; }
+    std::chrono::system_clock::time_point createdAtRow(size_t row) const { return items[row].createdAt; }
+    std::chrono::system_clock::time_point updatedAtRow(size_t row) const { return items[row].updatedAt; }
+    TextRef descriptionAt(size_t row) const { return TextRef{ items[row].description.data(), items[row].description.size() }; }
+    const Task& taskAt(size_t row) const { return items[row]; }
+
+    /**
+     * \@brief Finds the tasks whose descriptions contain every term of the query
+     * \@param query The search text; words are matched whole and case-insensitively
+     * \@return Matching task ids in ascending order
+     */
+    std::vector<int> search(const std::string& query);
+
+    /**
+     * \@brief Upper bound on the number of tasks search(query) returns, without running it
+     * Builds the search index on first use, like search
+     */
+    size_t searchEstimate(const std::string& query);
+
+    /**
+     * \@brief Whether the search index exists, so searchEstimate costs O(terms) rather than a build
+     */
+    bool hasSearchIndex() const { return searchIndexBuilt; }
+
+    /**
+     * \@brief The rows of the live tasks whose created or updated time is in [low, high)
+     * Builds the time indexes on first use, like search; later lookups cost O(log N + k)
+     * \@param field The timestamp to range over
+     * \@param low Inclusive lower bound (a TimeIndex::keyOf key)
+     * \@param high Exclusive upper bound
+     * \@return Row numbers in time order (valid until the list is next modified)
+     */
+    std::vector<size_t> rowsInTimeRange(TimeField field, long long low, long long high);
+
+    /**
+     * \@brief Upper bound on the number of rows rowsInTimeRange returns, in O(log N)
+     * Builds the time indexes on first use, like rowsInTimeRange
+     */
+    size_t timeRangeEstimate(TimeField field, long long low, long long high);
+
+    /**
+     * \@brief Whether the time indexes exist, so timeRangeEstimate costs O(log N) rather than a build
+     */
+    bool hasTimeIndexes() const { return timeIndexesBuilt; }
+
+private:
+    void buildSearchIndex();
+    TimeIndex& timeIndex(TimeField field);
+    void rebuildTimeIndex(TimeField field);
+    void retireTimeEntries();
+    void noteUpdated(const Task& task, std::chrono::system_clock::time_point updatedAt);
+    void addStatusBit(size_t position, TaskStatus status);
+    void rebuildStatusBits();
+    void markDeleted(size_t position);
+    void compactIfWorthIt();
+
+    std::vector<Task> items;
+    std::unordered_map<int, size_t> positions; // Task id -> index into items
+    int nextIdCounter = 1; // High-water mark for task ids
+    SearchIndex searchIndex; // Description terms -> task ids
+    bool searchIndexBuilt = false; // The index is only built once something searches
+    TimeIndex createdIndex; // createdAt -> task ids
+    TimeIndex updatedIndex; // updatedAt -> task ids
+    bool timeIndexesBuilt = false; // Built on the first time-range lookup
+    std::vector<uint64_t> statusBits[TASK_STATUS_COUNT]; // Per status: bit i = items[i] is live and has it
+    size_t statusCounts[TASK_STATUS_COUNT] = {}; // Per status: number of tasks
+    size_t tombstones = 0; // Deleted rows still in items
+};
+
+#endif // TASK_LIST_H
@@ -0,0 +1,226 @@
+#ifndef TASK_TABLE_H
+#define TASK_TABLE_H
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <chrono>
+#include <unordered_map>
+#include "task.h"
+#include "search_index.h"
+#include "time_index.h"
+
+/**
+ * \@brief Struct-of-arrays task collection with an arena for descriptions
+ * Ids, statuses and timestamps live in parallel contiguous arrays, and every
+ * description is a slice of one string arena, so scans, status filters and
+ * counts touch only the columns they need instead of whole Task records with
+ * their separately allocated strings. Rows stay in insertion order
+ *
+ * Offers the same row interface as TaskList (size, nextId, findRow, idAt, ...),
+ * so the commands in commands.cpp run against either representation
+ *
+ * Deletes leave a tombstone: the row's status byte becomes DELETED_STATUS, which
+ * no status filter matches, and the row keeps its slot until compact()
+ */
+class TaskTable {
+public:
+    TaskTable() = default;
+
+    /**
+     * \@brief Copies tasks into the table's columns and arena
+     * \@param tasks The tasks, in the order they were loaded
+     * \@param nextId The persisted next-id counter; raised past the highest id if needed
+     */
+    explicit TaskTable(const std::vector<Task>& tasks, int nextId = 0);
+
+    /**
+     * \@brief Rebuilds the live tasks as Task records (for saving)
+     * \@return The tasks, in insertion order
+     */
+    std::vector<Task> toTasks() const;
+
+    /**
+     * \@brief The id the next added task should get (only ever grows)
+     */
+    int nextId() const { return nextIdCounter; }
+
+    /**
+     * \@brief Number of live tasks (tombstones excluded)
+     */
+    size_t size() const { return ids.size() - tombstones; }
+    bool empty() const { return size() == 0; }
+
+    /**
+     * \@brief Number of rows, live or tombstoned; rows are numbered 0..slotCount()-1
+     */
+    size_t slotCount() const { return ids.size(); }
+
+    /**
+     * \@brief Number of deleted rows not yet compacted away
+     */
+    size_t tombstoneCount() const { return tombstones; }
+
+    /**
+     * \@brief Whether a row still holds a task (false for tombstones)
+     */
+    bool isLive(size_t row) const { return statuses[row] != DELETED_STATUS; }
+
+    /**
+     * \@brief The rows of every live task, in insertion order
+     * \@return Row numbers (valid until the table is next modified)
+     */
+    std::vector<size_t> liveRows() const;
+
+    /**
+     * \@brief Drops the tombstones, moving the live rows down and renumbering them
+     * \@return Number of tombstones removed
+     */
+    size_t compact();
+
+    /**
+     * \@brief Appends a task, advancing the next-id counter past its id
+     * \@param task The task to add (its id must not be in the table yet)
+     */
+    void add(const Task& task);
+
+    /**
+     * \@brief Removes a task by id, leaving a tombstone in its row
+     * \@param id The ID of the task to remove
+     * \@return True if the task was found and removed, false otherwise
+     */
+    bool remove(int id);
+
+    /**
+     * \@brief Removes many tasks, leaving a tombstone in each of their rows
+     * \@param rows The rows to remove (live), ascending and without duplicates
+     */
+    void removeRows(const std::vector<size_t>& rows);
+
+    /**
+     * \@brief Replaces a task's description; the new text is appended to the arena
+     * \@param id The ID of the task to change
+     * \@param description The new description
+     * \@param updatedAt The new last-update time
+     * \@return True if the task was found and changed, false otherwise
+     */
+    bool updateDescription(int id, const std::string& description, std::chrono::system_clock::time_point updatedAt);
+
+    /**
+     * \@brief Changes a task's status, keeping the status counts in sync
+     * \@param id The ID of the task to change
+     * \@param status The new status
+     * \@param updatedAt The new last-update time
+     * \@return True if the task was found and changed, false otherwise
+     */
+    bool updateStatus(int id, TaskStatus status, std::chrono::system_clock::time_point updatedAt);
+
+    /**
+     * \@brief Number of tasks with the given status, in O(1)
+     */
+    size_t countWithStatus(TaskStatus status) const { return statusCounts[static_cast<size_t>(status)]; }
+
+    /**
+     * \@brief The rows of the tasks with the given status, in insertion order
+     * Scans only the one-byte status column
+     * \@param status The status to select
+     * \@return Row numbers (valid until the table is next modified)
+     */
+    std::vector<size_t> rowsWithStatus(TaskStatus status) const;
+
+    /**
+     * \@brief Looks up the row of a task by id
+     * \@param id The ID of the task to find
+     * \@param row Output parameter: the task's row, if found
+     * \@return True if there is a task with this id
+     */
+    bool findRow(int id, size_t& row) const;
+
+    /**
+     * \@brief Finds the tasks whose descriptions contain every term of the query
+     * The index is built on the first search and kept current afterwards
+     * \@param query The search text; words are matched whole and case-insensitively
+     * \@return Matching task ids in ascending order
+     */
+    std::vector<int> search(const std::string& query);
+
+    /**
+     * \@brief Upper bound on the number of tasks search(query) returns, without running it
+     * Builds the search index on first use, like search
+     */
+    size_t searchEstimate(const std::string& query);
+
+    /**
+     * \@brief Whether the search index exists, so searchEstimate costs O(terms) rather than a build
+     */
+    bool hasSearchIndex() const { return searchIndexBuilt; }
+
+    /**
+     * \@brief The rows of the live tasks whose created or updated time is in [low, high)
+     * Builds the time indexes on first use, like search; later lookups cost O(log N + k)
+     * \@param field The timestamp to range over
+     * \@param low Inclusive lower bound (a TimeIndex::keyOf key)
+     * \@param high Exclusive upper bound
+     * \@return Row numbers in time order (valid until the table is next modified)
+     */
+    std::vector<size_t> rowsInTimeRange(TimeField field, long long low, long long high);
+
+    /**
+     * \@brief Upper bound on the number of rows rowsInTimeRange returns, in O(log N)
+     */
+    size_t timeRangeEstimate(TimeField field, long long low, long long high);
+
+    /**
+     * \@brief Whether the time indexes exist, so timeRangeEstimate costs O(log N) rather than a build
+     */
+    bool hasTimeIndexes() const { return timeIndexesBuilt; }
+
+    // --- Per-row field access (row < slotCount(), live rows only) ---
+    int idAt(size_t row) const { return ids[row]; }
+    TaskStatus statusAt(size_t row) const { return static_cast<TaskStatus>(statuses[row]); }
+    std::chrono::system_clock::time_point createdAtRow(size_t row) const { return createdTimes[row]; }
+    std::chrono::system_clock::time_point updatedAtRow(size_t row) const { return updatedTimes[row]; }
+    // Points into the arena: valid until the table is next modified
+    TextRef descriptionAt(size_t row) const { return TextRef{ arena.data() + descriptionOffsets[row], descriptionLengths[row] }; }
+    Task taskAt(size_t row) const;
+
+    /**
+     * \@brief Bytes of the arena in use, including text no row refers to any more
+     */
+    size_t arenaSize() const { return arena.size(); }
+
+private:
+    static const uint8_t DELETED_STATUS = 0xFF; // Status byte of a tombstone
+
+    void buildSearchIndex();
+    TimeIndex& timeIndex(TimeField field);
+    void rebuildTimeIndex(TimeField field);
+    void retireTimeEntries();
+    void noteUpdated(size_t row, std::chrono::system_clock::time_point updatedAt);
+    void appendDescription(const std::string& description);
+    void compactArena();
+    void markDeleted(size_t row);
+    void compactIfWorthIt();
+
+    // Columns, one entry per row
+    std::vector<int32_t> ids;
+    std::vector<uint8_t> statuses; // TaskStatus values, or DELETED_STATUS
+    std::vector<std::chrono::system_clock::time_point> createdTimes;
+    std::vector<std::chrono::system_clock::time_point> updatedTimes;
+    std::vector<uint64_t> descriptionOffsets; // Into the arena
+    std::vector<uint32_t> descriptionLengths;
+
+    std::string arena; // Every description, back to back
+    size_t arenaGarbage = 0; // Arena bytes left behind by updates and deletes
+    std::unordered_map<int, size_t> rowsById; // Task id -> row
+    size_t statusCounts[TASK_STATUS_COUNT] = {}; // Per status: number of tasks
+    size_t tombstones = 0; // Deleted rows still in the columns
+    int nextIdCounter = 1; // High-water mark for task ids
+    SearchIndex searchIndex; // Description terms -> task ids
+    bool searchIndexBuilt = false; // The index is only built once something searches
+    TimeIndex createdIndex; // createdAt -> task ids
+    TimeIndex updatedIndex; // updatedAt -> task ids
+    bool timeIndexesBuilt = false; // Built on the first time-range lookup
+};
+
+#endif // TASK_TABLE_H
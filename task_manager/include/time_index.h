@@ -0,0 +1,76 @@
+#ifndef TIME_INDEX_H
+#define TIME_INDEX_H
+
+#include <vector>
+#include <cstddef>
+#include <chrono>
+
+// Timestamps a TimeIndex can be kept on
+enum class TimeField {
+    CREATED,
+    UPDATED
+};
+
+// One indexed timestamp: a task id and its time in system clock ticks
+struct TimeEntry {
+    long long key;
+    int id;
+};
+
+/**
+ * \@brief Ordered index of one timestamp field: (time, task id) pairs in time order
+ * A sorted array rather than a tree: new and updated tasks carry the current
+ * time, so nearly every insertion is an append. Entries are never removed one
+ * by one; a task that is updated or deleted leaves its old entry behind as a
+ * stale one, which the owning container recognizes (the task's time no longer
+ * matches) and skips. Once stale entries outnumber live ones, the container
+ * rebuilds the index, so a range lookup costs O(log N + k) amortized
+ */
+class TimeIndex {
+public:
+    /**
+     * \@brief The key of a time point (ticks since the epoch)
+     */
+    static long long keyOf(std::chrono::system_clock::time_point tp) {
+        return static_cast<long long>(tp.time_since_epoch().count());
+    }
+
+    /**
+     * \@brief Adds an entry; out-of-order entries are sorted in before the next lookup
+     */
+    void add(long long key, int id);
+
+    /**
+     * \@brief Notes that one entry no longer matches its task (updated or deleted)
+     */
+    void markStale() { ++stale; }
+
+    /**
+     * \@brief Whether stale entries have come to outnumber the live ones
+     */
+    bool needsRebuild() const { return stale > entries.size() / 2; }
+
+    /**
+     * \@brief Drops every entry (before a rebuild)
+     * \@param capacity Entries to reserve room for
+     */
+    void reset(size_t capacity);
+
+    /**
+     * \@brief The entries with low <= key < high, in time order, stale ones included
+     * \@param low Inclusive lower bound
+     * \@param high Exclusive upper bound
+     * \@param first Output parameter: the first entry in range
+     * \@param last Output parameter: one past the last entry in range
+     */
+    void range(long long low, long long high, const TimeEntry*& first, const TimeEntry*& last);
+
+private:
+    void sortPending();
+
+    std::vector<TimeEntry> entries; // Sorted by (key, id) up to sortedCount
+    size_t sortedCount = 0; // Entries appended out of order sit after this point until sorted
+    size_t stale = 0; // Entries that no longer match their task
+};
+
+#endif // TIME_INDEX_H
@@ -0,0 +1,65 @@
+#ifndef TRANSFER_H
+#define TRANSFER_H
+
+#include <string>
+#include <ostream>
+#include <cstddef>
+#include "task_list.h" // For TaskList
+#include "task_table.h" // For TaskTable
+
+// --- Bulk import and export (task-cli import / export) ---
+// Both directions stream: import reads the file in fixed-size chunks and adds
+// each record as soon as it is complete, export formats rows into one buffer
+// that is written out whenever it fills. Neither builds a second copy of the tasks
+
+// Record formats for import and export
+enum class TransferFormat {
+    NDJSON, // One JSON task object per line, with the keys saveTasks writes
+    CSV // RFC 4180; a header row names the columns (id,description,status,createdAt,updatedAt)
+};
+
+// Outcome of an import
+struct ImportResult {
+    size_t imported; // Records added as new tasks
+    size_t skipped; // Malformed records, or records without a description
+
+    ImportResult() : imported(0), skipped(0) {}
+};
+
+/**
+ * \@brief Parses a format name ("ndjson" or "csv")
+ * \@return True if the name is known
+ */
+bool parseTransferFormat(const std::string& name, TransferFormat& format);
+
+/**
+ * \@brief Guesses a file's format from its name: CSV for ".csv", NDJSON otherwise
+ */
+TransferFormat transferFormatForFile(const std::string& path);
+
+/**
+ * \@brief Adds every record of a file as a new task
+ * Ids in the file are ignored: each task gets the next id from the list's counter.
+ * Status defaults to todo and missing timestamps to now. The changes are recorded
+ * for the next commit; past a few thousand tasks the commit becomes one snapshot
+ * \@param tasks The list of tasks (will be modified)
+ * \@param path The file to read
+ * \@param format The file's record format
+ * \@param result Output parameter: how many records were imported and skipped
+ * \@return False if the file could not be read, or a CSV header has no description column
+ * (tasks imported before the error stay)
+ */
+template <typename Tasks>
+bool importTasks(Tasks& tasks, const std::string& path, TransferFormat format, ImportResult& result);
+
+/**
+ * \@brief Writes every live task to a stream, in insertion order
+ * \@param tasks The list of tasks
+ * \@param format The record format
+ * \@param out Where to write (std::cout, or a file)
+ * \@return The number of tasks written
+ */
+template <typename Tasks>
+size_t exportTasks(const Tasks& tasks, TransferFormat format, std::ostream& out);
+
+#endif // TRANSFER_H
@@ -1,32 +1,70 @@
-#ifndef UTILS_H
-#define UTILS_H
-
-#include <vector>
-#include <string>
-#include <chrono> // For time points
-#include "task.h" // For Task struct definition
-
-/**
- * \@brief Generates the next unique task ID
- * Finds the maximum existing ID and returns max + 1
- * Returns 1 if the task list is empty
- * \@param tasks The vector of existing tasks 
- * \@return The next available integer ID
- */
-int generateNextId(const std::vector<Task>& tasks);
-
-/**
- * \@brief Gets the current system time point
- * \@return A std::chrono::system_clock::time_point representing the current time
- */
-std::chrono::system_clock::time_point getCurrentTimestamp();
-
-/**
- * \@brief Formats a time point into a string (YYYY-MM-DD HH:MM:SS)
- * \@param tp The time point to format 
- * \@return A formatted string representation of the timestamp
- */
-std::string formatTimestamp(const std::chrono::system_clock::time_point& tp);
-
-
+#ifndef UTILS_H
+#define UTILS_H
+
+#include <vector>
+#include <string>
+#include <chrono> // For time points
+#include <cstdint> // For uint32_t
+#include "task.h" // For Task struct definition
+#include "task_list.h" // For TaskList and its next-id counter
+#include "task_table.h" // For TaskTable and its next-id counter
+
+/**
+ * \@brief Generates the next unique task ID
+ * Reads the list's persisted high-water mark in O(1); IDs of deleted
+ * tasks are never handed out again
+ * Returns 1 if no task was ever created
+ * \@param tasks The list of existing tasks 
+ * \@return The next available integer ID
+ */
+int generateNextId(const TaskList& tasks);
+int generateNextId(const TaskTable& tasks);
+
+/**
+ * \@brief Gets the current system time point
+ * \@return A std::chrono::system_clock::time_point representing the current time
+ */
+std::chrono::system_clock::time_point getCurrentTimestamp();
+
+// Length of a formatted timestamp ("YYYY-MM-DD HH:MM:SS")
+const size_t TIMESTAMP_LENGTH = 19;
+// Buffer size needed by the buffer-based formatTimestamp (includes the NUL)
+const size_t TIMESTAMP_BUFFER_SIZE = TIMESTAMP_LENGTH + 1;
+
+/**
+ * \@brief Formats a time point into a string (YYYY-MM-DD HH:MM:SS)
+ * \@param tp The time point to format 
+ * \@return A formatted string representation of the timestamp
+ */
+std::string formatTimestamp(const std::chrono::system_clock::time_point& tp);
+
+/**
+ * \@brief Formats a time point into a caller-provided buffer (YYYY-MM-DD HH:MM:SS, local time)
+ * Hand-rolled: no iostreams, and localtime is only consulted once per timezone transition
+ * \@param tp The time point to format
+ * \@param buffer Output buffer of at least TIMESTAMP_BUFFER_SIZE bytes; receives a NUL-terminated string
+ * \@return The number of characters written, excluding the NUL (TIMESTAMP_LENGTH)
+ */
+size_t formatTimestamp(const std::chrono::system_clock::time_point& tp, char* buffer);
+
+/**
+ * \@brief Parses a local "YYYY-MM-DD HH:MM:SS" timestamp without iostreams or mktime
+ * Characters after the 19th are ignored
+ * \@param text The characters to parse (need not be NUL-terminated)
+ * \@param length Number of characters available
+ * \@param tp Output parameter: the parsed time point
+ * \@return True on success, false if the text does not match the format
+ */
+bool parseTimestamp(const char* text, size_t length, std::chrono::system_clock::time_point& tp);
+
+/**
+ * \@brief Computes a CRC-32 (IEEE 802.3, as in zlib) over a buffer
+ * Chain calls by passing the previous result as crc to checksum data in pieces
+ * \@param data The bytes to checksum
+ * \@param length Number of bytes
+ * \@param crc The CRC of the bytes before these (0 to start)
+ * \@return The CRC of everything so far
+ */
+uint32_t crc32(const void* data, size_t length, uint32_t crc = 0);
+
 #endif // UTILS_H
\ No newline at end of file
@@ -0,0 +1,488 @@
+#include "binary_store.h"
+#include "stats.h" // For --stats phase timing and byte counts
+#include <iostream>
+#include <vector>
+#include <string>
+#include <cstring> // For std::memcmp, std::memcpy
+#include <cstdio> // For std::rename, std::remove
+#include <algorithm> // For std::sort, std::lower_bound
+#include <utility> // For std::move, std::pair
+#include <unordered_map>
+#include <chrono>
+#include <fcntl.h> // For open
+#include <sys/mman.h> // For mmap, munmap
+#include <sys/stat.h> // For fstat
+#include <unistd.h> // For pwrite, fsync, close
+
+// Name of the binary store in the working directory
+const std::string BINARY_STORE_FILE = "tasks.bin";
+const char BINARY_STORE_MAGIC[8] = { 'T', 'A', 'S', 'K', 'B', 'I', 'N', '1' };
+const uint32_t BINARY_STORE_VERSION = 1;
+// Smallest number of slots reserved when the file is (re)written
+const uint64_t MIN_RECORD_CAPACITY = 1024;
+// Persisted id -> slot index: a magic followed by one uint32 per id (slot + 1, 0 = no slot)
+const std::string BINARY_INDEX_FILE = "tasks.bin.idx";
+const char BINARY_INDEX_MAGIC[8] = { 'T', 'A', 'S', 'K', 'I', 'D', 'X', '1' };
+
+static_assert(sizeof(BinaryStoreHeader) == 128, "BinaryStoreHeader layout changed");
+static_assert(sizeof(TaskRecordSlot) == 40, "TaskRecordSlot layout changed");
+
+/**
+ * \@brief Read-only memory mapping of an open tasks.bin
+ * Writes go through pwrite on the same descriptor; on Linux the mapping shares
+ * the page cache, so slots written through pwrite are visible here immediately
+ */
+class MappedTaskFile {
+public:
+    explicit MappedTaskFile(int fd) : data(nullptr), length(0) {
+        struct stat info;
+        if (fstat(fd, &info) != 0 || info.st_size < static_cast<off_t>(sizeof(BinaryStoreHeader))) {
+            return;
+        }
+        void* mapped = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_SHARED, fd, 0);
+        if (mapped == MAP_FAILED) {
+            return;
+        }
+        data = static_cast<const char*>(mapped);
+        length = static_cast<size_t>(info.st_size);
+    }
+
+    ~MappedTaskFile() {
+        if (data != nullptr) {
+            munmap(const_cast<char*>(data), length);
+        }
+    }
+
+    MappedTaskFile(const MappedTaskFile&) = delete;
+    MappedTaskFile& operator=(const MappedTaskFile&) = delete;
+
+    /**
+     * \@brief Checks that the file is mapped and its header describes a consistent layout
+     */
+    bool valid() const {
+        if (data == nullptr) {
+            return false;
+        }
+        const BinaryStoreHeader& h = header();
+        return std::memcmp(h.magic, BINARY_STORE_MAGIC, sizeof(h.magic)) == 0
+            && h.version == BINARY_STORE_VERSION
+            && h.recordSize == sizeof(TaskRecordSlot)
+            && h.recordCount <= h.recordCapacity
+            && h.heapOffset == sizeof(BinaryStoreHeader) + h.recordCapacity * sizeof(TaskRecordSlot)
+            && h.heapOffset + h.heapSize <= length;
+    }
+
+    const BinaryStoreHeader& header() const {
+        return *reinterpret_cast<const BinaryStoreHeader*>(data);
+    }
+
+    const TaskRecordSlot* slots() const {
+        return reinterpret_cast<const TaskRecordSlot*>(data + sizeof(BinaryStoreHeader));
+    }
+
+    /**
+     * \@brief Returns a slot's description if it lies inside the mapped part of the heap
+     * \@return Pointer to the bytes, or nullptr if the range is outside the mapping
+     */
+    const char* description(const TaskRecordSlot& slot) const {
+        uint64_t start = header().heapOffset + slot.descriptionOffset;
+        if (start + slot.descriptionLength > length) {
+            return nullptr;
+        }
+        return data + start;
+    }
+
+private:
+    const char* data;
+    size_t length;
+};
+
+/**
+ * \@brief Converts a time point to the nanosecond count stored in a slot
+ */
+static int64_t toSlotTime(const std::chrono::system_clock::time_point& tp) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(tp.time_since_epoch()).count();
+}
+
+/**
+ * \@brief Converts a slot's nanosecond count back to a time point
+ */
+static std::chrono::system_clock::time_point fromSlotTime(int64_t nanos) {
+    return std::chrono::system_clock::time_point(
+        std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::nanoseconds(nanos)));
+}
+
+/**
+ * \@brief Writes a buffer at a given offset, retrying on short writes
+ * \@return True if every byte was written
+ */
+static bool writeAt(int fd, const void* buffer, size_t size, uint64_t offset) {
+    const char* p = static_cast<const char*>(buffer);
+    while (size > 0) {
+        ssize_t written = pwrite(fd, p, size, static_cast<off_t>(offset));
+        if (written <= 0) {
+            return false;
+        }
+        addBytesWritten(static_cast<size_t>(written));
+        p += written;
+        size -= static_cast<size_t>(written);
+        offset += static_cast<uint64_t>(written);
+    }
+    return true;
+}
+
+/**
+ * \@brief Finds the slot holding a task id with a binary search (slots are in id order)
+ * \@param slots The slot array
+ * \@param count Number of slots in use
+ * \@param id The task id to look for
+ * \@return The slot index, or count if the id has no slot
+ */
+static uint64_t findSlot(const TaskRecordSlot* slots, uint64_t count, int id) {
+    const TaskRecordSlot* end = slots + count;
+    const TaskRecordSlot* it = std::lower_bound(slots, end, id,
+                                                [](const TaskRecordSlot& slot, int key) { return slot.id < key; });
+    return (it != end && it->id == id) ? static_cast<uint64_t>(it - slots) : count;
+}
+
+bool binaryStoreExists() {
+    struct stat info;
+    return stat(BINARY_STORE_FILE.c_str(), &info) == 0;
+}
+
+/**
+ * \@brief Offset of an id's entry in tasks.bin.idx
+ */
+static uint64_t indexEntryOffset(int id) {
+    return sizeof(BINARY_INDEX_MAGIC) + static_cast<uint64_t>(id) * sizeof(uint32_t);
+}
+
+/**
+ * \@brief Finds the slot holding a task id through the persisted index
+ * The index is only a hint: the entry is checked against the slot it points to,
+ * and a binary search over the slots is used when it is missing or stale
+ * \@param indexFd Descriptor of tasks.bin.idx, or -1 if there is none
+ * \@param slots The slot array
+ * \@param count Number of slots in use
+ * \@param id The task id to look for
+ * \@return The slot index, or count if the id has no slot
+ */
+static uint64_t lookupSlot(int indexFd, const TaskRecordSlot* slots, uint64_t count, int id) {
+    uint32_t entry = 0;
+    if (indexFd >= 0 && id >= 0
+        && pread(indexFd, &entry, sizeof(entry), static_cast<off_t>(indexEntryOffset(id))) == sizeof(entry)
+        && entry > 0 && entry - 1 < count && slots[entry - 1].id == id) {
+        return entry - 1;
+    }
+    return findSlot(slots, count, id);
+}
+
+/**
+ * \@brief Writes a complete tasks.bin.idx for the given slots (via a temporary file and rename)
+ * \@param slots The slot array, in id order
+ * \@param count Number of slots in use
+ */
+static void saveBinaryIndex(const TaskRecordSlot* slots, uint64_t count) {
+    int maxId = 0;
+    for (uint64_t i = 0; i < count; ++i) {
+        maxId = std::max(maxId, slots[i].id);
+    }
+    std::vector<uint32_t> entries(static_cast<size_t>(maxId) + 1, 0);
+    for (uint64_t i = 0; i < count; ++i) {
+        if (slots[i].id >= 0) {
+            entries[static_cast<size_t>(slots[i].id)] = static_cast<uint32_t>(i + 1);
+        }
+    }
+
+    const std::string tempFile = BINARY_INDEX_FILE + ".tmp";
+    int fd = open(tempFile.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        return; // The index is an optimization; lookups fall back to binary search
+    }
+    bool ok = writeAt(fd, BINARY_INDEX_MAGIC, sizeof(BINARY_INDEX_MAGIC), 0)
+           && writeAt(fd, entries.data(), entries.size() * sizeof(uint32_t), sizeof(BINARY_INDEX_MAGIC));
+    ok = (close(fd) == 0) && ok;
+    if (!ok || std::rename(tempFile.c_str(), BINARY_INDEX_FILE.c_str()) != 0) {
+        std::remove(tempFile.c_str());
+        std::remove(BINARY_INDEX_FILE.c_str()); // Never leave an index describing an older file
+    }
+}
+
+/**
+ * \@brief Loads all live tasks from tasks.bin by memory-mapping it
+ * \@param nextId Output parameter: the stored next-id counter (0 if the file predates it)
+ * \@return The tasks in id order. Returns empty vector if the file is missing or invalid
+ */
+std::vector<Task> loadBinaryTasks(int& nextId) {
+    std::vector<Task> tasks;
+    nextId = 0;
+    int fd = open(BINARY_STORE_FILE.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return tasks;
+    }
+    MappedTaskFile file(fd);
+    close(fd); // The mapping stays valid after the descriptor is closed
+
+    if (!file.valid()) {
+        std::cerr << "Warning: '" << BINARY_STORE_FILE << "' is malformed or empty. Starting with empty task list." << std::endl;
+        return tasks;
+    }
+
+    const BinaryStoreHeader& header = file.header();
+    const TaskRecordSlot* slots = file.slots();
+    // Counted as parsing: the mapped pages are faulted in while the slots are decoded
+    PhaseTimer parseTimer(StatsPhase::PARSE);
+    addBytesRead(static_cast<size_t>(header.heapOffset + header.heapSize));
+    nextId = header.nextId;
+    tasks.reserve(header.liveCount);
+    for (uint64_t i = 0; i < header.recordCount; ++i) {
+        const TaskRecordSlot& slot = slots[i];
+        if (slot.flags & SLOT_DELETED) {
+            continue;
+        }
+        const char* description = file.description(slot);
+        if (description == nullptr || slot.descriptionOffset + slot.descriptionLength > header.heapSize ||
+            slot.status >= TASK_STATUS_COUNT) {
+            std::cerr << "Warning: Skipping task " << slot.id << " with an invalid description or status in '" << BINARY_STORE_FILE << "'." << std::endl;
+            continue;
+        }
+        tasks.emplace_back(slot.id, std::string(description, slot.descriptionLength),
+                           static_cast<TaskStatus>(slot.status),
+                           fromSlotTime(slot.createdAt), fromSlotTime(slot.updatedAt));
+    }
+    return tasks;
+}
+
+/**
+ * \@brief Writes a complete, compacted tasks.bin (via a temporary file and rename)
+ * Reserves spare slots so that new tasks can be appended in place for a while
+ * \@param tasks The tasks to store
+ * \@param nextId The next-id counter to store in the header
+ * \@return True on success, false otherwise
+ */
+bool saveBinaryTasks(const std::vector<Task>& tasks, int nextId) {
+    std::vector<const Task*> ordered;
+    ordered.reserve(tasks.size());
+    for (const auto& task : tasks) {
+        ordered.push_back(&task);
+    }
+    return saveBinaryTasks(std::move(ordered), nextId);
+}
+
+/**
+ * \@brief Writes a complete, compacted tasks.bin from tasks held elsewhere
+ * \@param ordered The tasks to store, in any order (sorted here)
+ * \@param nextId The next-id counter to store in the header
+ * \@return True on success, false otherwise
+ */
+bool saveBinaryTasks(std::vector<const Task*> ordered, int nextId) {
+    auto serializeStart = std::chrono::steady_clock::now();
+    // Slots must be in id order for findSlot
+    std::sort(ordered.begin(), ordered.end(), [](const Task* a, const Task* b) { return a->id < b->id; });
+
+    BinaryStoreHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, BINARY_STORE_MAGIC, sizeof(header.magic));
+    header.version = BINARY_STORE_VERSION;
+    header.recordSize = sizeof(TaskRecordSlot);
+    header.recordCount = ordered.size();
+    header.recordCapacity = std::max<uint64_t>(MIN_RECORD_CAPACITY, ordered.size() + ordered.size() / 2);
+    header.liveCount = ordered.size();
+    header.nextId = nextId;
+    header.heapOffset = sizeof(BinaryStoreHeader) + header.recordCapacity * sizeof(TaskRecordSlot);
+
+    // Header and slot region are built in memory, unused slots stay zeroed
+    std::vector<char> records(static_cast<size_t>(header.heapOffset), 0);
+    TaskRecordSlot* slots = reinterpret_cast<TaskRecordSlot*>(records.data() + sizeof(BinaryStoreHeader));
+    std::string heap;
+    for (size_t i = 0; i < ordered.size(); ++i) {
+        const Task& task = *ordered[i];
+        TaskRecordSlot& slot = slots[i];
+        slot.id = task.id;
+        slot.status = static_cast<uint8_t>(task.status);
+        slot.descriptionLength = static_cast<uint32_t>(task.description.size());
+        slot.descriptionOffset = heap.size();
+        slot.createdAt = toSlotTime(task.createdAt);
+        slot.updatedAt = toSlotTime(task.updatedAt);
+        heap += task.description;
+    }
+    header.heapSize = heap.size();
+    std::memcpy(records.data(), &header, sizeof(header));
+    addPhaseTime(StatsPhase::SERIALIZE, std::chrono::steady_clock::now() - serializeStart);
+
+    PhaseTimer writeTimer(StatsPhase::WRITE);
+
+    const std::string tempFile = BINARY_STORE_FILE + ".tmp";
+    int fd = open(tempFile.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        std::cerr << "Error: Could not open '" << tempFile << "' for writing." << std::endl;
+        return false;
+    }
+    bool ok = writeAt(fd, records.data(), records.size(), 0)
+           && writeAt(fd, heap.data(), heap.size(), header.heapOffset);
+    ok = ok && fsync(fd) == 0; // Durable before the rename can replace the old file
+    ok = (close(fd) == 0) && ok;
+    if (!ok || std::rename(tempFile.c_str(), BINARY_STORE_FILE.c_str()) != 0) {
+        std::cerr << "Error: Failed to write '" << BINARY_STORE_FILE << "'." << std::endl;
+        std::remove(tempFile.c_str());
+        return false;
+    }
+    saveBinaryIndex(slots, header.recordCount);
+    return true;
+}
+
+/**
+ * \@brief Applies individual changes to tasks.bin in place
+ * New descriptions are appended to the heap first, while the new slots are built
+ * in memory; then the heap is made durable and covered by the header before any
+ * slot points into it, and the slots are made durable before the header counts
+ * them. A crash, or a change that does not fit, thus never leaves a slot that
+ * points past the persisted heap: at worst a crash leaves part of the batch applied
+ * \@param changes The changes to apply, in order
+ * \@param nextId The current next-id counter, stored in the header
+ * \@return False if the changes cannot be applied in place (the caller should
+ * rewrite the whole file with saveBinaryTasks), true otherwise
+ */
+bool applyBinaryChanges(const std::vector<TaskChange>& changes, int nextId) {
+    PhaseTimer writeTimer(StatsPhase::WRITE); // Slot encoding is trivial next to the pwrites
+    int fd = open(BINARY_STORE_FILE.c_str(), O_RDWR);
+    if (fd < 0) {
+        return false; // No file yet: the first save writes it in full
+    }
+    MappedTaskFile file(fd);
+    if (!file.valid()) {
+        close(fd);
+        return false;
+    }
+
+    const BinaryStoreHeader original = file.header();
+    BinaryStoreHeader header = original; // Local copy, written back once the slots are durable
+    header.nextId = nextId;
+    const TaskRecordSlot* slots = file.slots();
+    int indexFd = open(BINARY_INDEX_FILE.c_str(), O_RDWR);
+    bool inPlace = true;
+
+    // Slots changed by this batch, written only after the heap they point into is durable
+    std::unordered_map<uint64_t, TaskRecordSlot> staged;
+    std::unordered_map<int, uint64_t> appended; // Id -> slot, for tasks that got a new slot
+    auto currentSlot = [&](uint64_t index) -> const TaskRecordSlot& {
+        auto it = staged.find(index);
+        return it != staged.end() ? it->second : slots[index];
+    };
+
+    for (const auto& change : changes) {
+        auto added = appended.find(change.id);
+        uint64_t index = header.recordCount; // Not in the file, nor added by this batch
+        if (added != appended.end()) {
+            index = added->second;
+        } else {
+            uint64_t found = lookupSlot(indexFd, slots, original.recordCount, change.id);
+            if (found < original.recordCount) {
+                index = found;
+            }
+        }
+
+        if (change.deleted) {
+            if (index == header.recordCount || (currentSlot(index).flags & SLOT_DELETED)) {
+                continue; // Already gone
+            }
+            TaskRecordSlot slot = currentSlot(index);
+            slot.flags |= SLOT_DELETED;
+            header.liveCount--;
+            header.heapGarbage += slot.descriptionLength;
+            staged[index] = slot;
+            continue;
+        }
+
+        const Task& task = change.task;
+        TaskRecordSlot slot;
+        std::memset(&slot, 0, sizeof(slot));
+        bool reuseDescription = false;
+        if (index < header.recordCount) {
+            slot = currentSlot(index);
+            if (slot.flags & SLOT_DELETED) {
+                header.liveCount++;
+                header.heapGarbage -= slot.descriptionLength; // Re-added: counted again below if replaced
+            }
+            const char* current = file.description(slot);
+            reuseDescription = current != nullptr && slot.descriptionLength == task.description.size()
+                && std::memcmp(current, task.description.data(), task.description.size()) == 0;
+            if (!reuseDescription) {
+                header.heapGarbage += slot.descriptionLength;
+            }
+        } else if (header.recordCount < header.recordCapacity
+                   && (header.recordCount == 0 || currentSlot(header.recordCount - 1).id < task.id)) {
+            // New task with the highest id: take the next free slot
+            index = header.recordCount++;
+            header.liveCount++;
+            appended[task.id] = index;
+        } else {
+            inPlace = false; // Slot region is full or the id would break the ordering
+            break;
+        }
+
+        if (!reuseDescription) {
+            // The new description goes to the end of the heap; the old bytes become garbage
+            slot.descriptionOffset = header.heapSize;
+            slot.descriptionLength = static_cast<uint32_t>(task.description.size());
+            if (!writeAt(fd, task.description.data(), task.description.size(), header.heapOffset + header.heapSize)) {
+                inPlace = false;
+                break;
+            }
+            header.heapSize += task.description.size();
+        }
+        slot.id = task.id;
+        slot.status = static_cast<uint8_t>(task.status);
+        slot.flags &= static_cast<uint8_t>(~SLOT_DELETED);
+        slot.createdAt = toSlotTime(task.createdAt);
+        slot.updatedAt = toSlotTime(task.updatedAt);
+        staged[index] = slot;
+    }
+
+    // Once more than half of the heap is dead, a full rewrite is cheaper than carrying it around
+    if (inPlace && header.heapGarbage > header.heapSize / 2 && header.heapSize > 64 * 1024) {
+        inPlace = false;
+    }
+    // Deleted slots are tombstones too: past the TOMBSTONE_COMPACT_* threshold, the rewrite drops them
+    uint64_t deletedSlots = header.recordCount - header.liveCount;
+    if (inPlace && deletedSlots >= TOMBSTONE_COMPACT_MIN && deletedSlots * TOMBSTONE_COMPACT_DIVISOR > header.recordCount) {
+        inPlace = false;
+    }
+
+    if (inPlace && header.heapSize > original.heapSize) {
+        // Cover the appended descriptions first; until a slot points at them they are garbage
+        BinaryStoreHeader grown = original;
+        grown.heapSize = header.heapSize;
+        grown.heapGarbage += header.heapSize - original.heapSize;
+        inPlace = fsync(fd) == 0 && writeAt(fd, &grown, sizeof(grown), 0);
+    }
+    if (inPlace) {
+        std::vector<std::pair<uint64_t, TaskRecordSlot>> ordered(staged.begin(), staged.end());
+        std::sort(ordered.begin(), ordered.end(),
+                  [](const std::pair<uint64_t, TaskRecordSlot>& a, const std::pair<uint64_t, TaskRecordSlot>& b) {
+                      return a.first < b.first;
+                  });
+        for (const auto& entry : ordered) {
+            uint64_t slotOffset = sizeof(BinaryStoreHeader) + entry.first * sizeof(TaskRecordSlot);
+            if (!writeAt(fd, &entry.second, sizeof(entry.second), slotOffset)) {
+                inPlace = false;
+                break;
+            }
+        }
+    }
+    inPlace = inPlace && fsync(fd) == 0 && writeAt(fd, &header, sizeof(header), 0) && fsync(fd) == 0;
+    if (indexFd >= 0) {
+        if (inPlace) {
+            // The index is only a hint, so its entries for the new slots need no fsync
+            for (const auto& entry : appended) {
+                uint32_t slotNumber = static_cast<uint32_t>(entry.second + 1);
+                if (entry.first >= 0) {
+                    writeAt(indexFd, &slotNumber, sizeof(slotNumber), indexEntryOffset(entry.first));
+                }
+            }
+        }
+        close(indexFd);
+    }
+    close(fd);
+    return inPlace;
+}
@@ -0,0 +1,1266 @@
+#include "btree_store.h"
+#include "stats.h" // For --stats phase timing and byte counts
+#include "utils.h" // For crc32
+#include <iostream>
+#include <vector>
+#include <string>
+#include <list>
+#include <memory> // For std::unique_ptr
+#include <unordered_map>
+#include <cstring> // For std::memcmp, std::memcpy, std::memset
+#include <cstdio> // For std::rename, std::remove
+#include <algorithm> // For std::sort, std::lower_bound, std::upper_bound, std::min
+#include <utility> // For std::move
+#include <chrono>
+#include <cstddef> // For offsetof
+#include <fcntl.h> // For open
+#include <sys/stat.h> // For fstat, stat
+#include <unistd.h> // For pread, pwrite, fsync, close
+
+// Name of the paged store and its journal in the working directory
+const std::string PAGED_STORE_FILE = "tasks.db";
+const std::string PAGED_JOURNAL_FILE = "tasks.db-journal";
+const char PAGED_STORE_MAGIC[8] = { 'T', 'A', 'S', 'K', 'D', 'B', '0', '1' };
+const uint32_t PAGED_STORE_VERSION = 1;
+const char JOURNAL_MAGIC[8] = { 'T', 'A', 'S', 'K', 'J', 'R', 'N', '1' };
+const char JOURNAL_COMMIT_MAGIC[8] = { 'T', 'A', 'S', 'K', 'J', 'E', 'N', 'D' };
+// The full rewrite writes its pages in batches of this many bytes
+const size_t BULK_WRITE_BYTES = 1024 * 1024;
+
+// Page types (first byte of every page but the header)
+const uint8_t PAGE_LEAF = 1;
+const uint8_t PAGE_INTERNAL = 2;
+const uint8_t PAGE_OVERFLOW = 3;
+const uint8_t PAGE_FREE = 4;
+
+// Header at the start of every page but page 0
+struct PageHeader {
+    uint8_t type; // PAGE_* value
+    uint8_t reserved;
+    uint16_t count; // Leaf: records; internal: separator keys
+    uint32_t link; // Internal: leftmost child; overflow and free: next page (0 = none)
+};
+
+// Internal page entry after the header: the child holds the ids >= key
+struct InternalEntry {
+    int32_t key;
+    uint32_t child;
+};
+
+// Journal layout: [JournalHeader][JournalEntry + page image]...[JournalTrailer]
+struct JournalHeader {
+    char magic[8]; // "TASKJRN1"
+    uint64_t fileId; // fileId of the tasks.db the pages belong to
+    uint32_t entryCount; // Page images that follow
+    uint32_t reserved;
+};
+
+struct JournalEntry {
+    uint32_t page; // Page number the image belongs at
+    uint32_t crc; // CRC-32 of the image
+};
+
+struct JournalTrailer {
+    char magic[8]; // "TASKJEND": the journal was written to the end
+    uint32_t crc; // CRC-32 of everything before the trailer
+    uint32_t reserved;
+};
+
+const size_t PAGE_BODY_SIZE = PAGED_PAGE_SIZE - sizeof(PageHeader);
+const size_t INTERNAL_MAX_KEYS = PAGE_BODY_SIZE / sizeof(InternalEntry);
+
+static_assert(sizeof(PagedStoreHeader) == 128, "PagedStoreHeader layout changed");
+static_assert(sizeof(PagedTaskCell) == 32, "PagedTaskCell layout changed");
+static_assert(sizeof(PageHeader) == 8, "PageHeader layout changed");
+static_assert(2 * (sizeof(PagedTaskCell) + PAGED_INLINE_DESCRIPTION_LIMIT) <= PAGE_BODY_SIZE,
+              "A leaf must hold at least two records, or splits could not make room");
+
+// The fileId of tasks.db is stored in the header's reserved bytes
+const size_t HEADER_FILE_ID_OFFSET = offsetof(PagedStoreHeader, reserved);
+
+/**
+ * \@brief Converts a time point to the nanosecond count stored in a cell
+ */
+static int64_t toCellTime(const std::chrono::system_clock::time_point& tp) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(tp.time_since_epoch()).count();
+}
+
+/**
+ * \@brief Converts a cell's nanosecond count back to a time point
+ */
+static std::chrono::system_clock::time_point fromCellTime(int64_t nanos) {
+    return std::chrono::system_clock::time_point(
+        std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::nanoseconds(nanos)));
+}
+
+/**
+ * \@brief Writes a buffer at a given offset, retrying on short writes
+ * \@return True if every byte was written
+ */
+static bool writeAt(int fd, const void* buffer, size_t size, uint64_t offset) {
+    const char* p = static_cast<const char*>(buffer);
+    while (size > 0) {
+        ssize_t written = pwrite(fd, p, size, static_cast<off_t>(offset));
+        if (written <= 0) {
+            return false;
+        }
+        addBytesWritten(static_cast<size_t>(written));
+        p += written;
+        size -= static_cast<size_t>(written);
+        offset += static_cast<uint64_t>(written);
+    }
+    return true;
+}
+
+/**
+ * \@brief Reads a buffer from a given offset, retrying on short reads
+ * \@return True if every byte was read (false at end of file)
+ */
+static bool readAt(int fd, void* buffer, size_t size, uint64_t offset) {
+    char* p = static_cast<char*>(buffer);
+    while (size > 0) {
+        ssize_t got = pread(fd, p, size, static_cast<off_t>(offset));
+        if (got <= 0) {
+            return false;
+        }
+        addBytesRead(static_cast<size_t>(got));
+        p += got;
+        size -= static_cast<size_t>(got);
+        offset += static_cast<uint64_t>(got);
+    }
+    return true;
+}
+
+/**
+ * \@brief Makes a new directory entry (the journal, a renamed file) durable
+ */
+static void syncWorkingDirectory() {
+    int dirFd = open(".", O_RDONLY);
+    if (dirFd >= 0) {
+        fsync(dirFd);
+        close(dirFd);
+    }
+}
+
+bool pagedStoreExists() {
+    struct stat info;
+    return stat(PAGED_STORE_FILE.c_str(), &info) == 0;
+}
+
+/**
+ * \@brief Replays or discards a journal left behind by an interrupted commit
+ * A journal that was written to the end (trailer present, every checksum right)
+ * and belongs to this tasks.db is copied into place; anything else is a commit
+ * that never reached tasks.db, so it is dropped
+ * \@param fd Descriptor of tasks.db, open for writing
+ * \@return False if a complete journal could not be replayed
+ */
+static bool recoverJournal(int fd) {
+    int journalFd = open(PAGED_JOURNAL_FILE.c_str(), O_RDONLY);
+    if (journalFd < 0) {
+        return true; // The last commit finished
+    }
+    struct stat info;
+    std::vector<char> journal;
+    if (fstat(journalFd, &info) == 0) {
+        journal.resize(static_cast<size_t>(info.st_size));
+        if (!readAt(journalFd, journal.data(), journal.size(), 0)) {
+            journal.clear();
+        }
+    }
+    close(journalFd);
+
+    JournalHeader header;
+    JournalTrailer trailer;
+    uint64_t fileId = 0;
+    const size_t entrySize = sizeof(JournalEntry) + PAGED_PAGE_SIZE;
+    bool complete = journal.size() >= sizeof(header) + sizeof(trailer);
+    if (complete) {
+        std::memcpy(&header, journal.data(), sizeof(header));
+        std::memcpy(&trailer, journal.data() + journal.size() - sizeof(trailer), sizeof(trailer));
+        complete = std::memcmp(header.magic, JOURNAL_MAGIC, sizeof(header.magic)) == 0
+            && std::memcmp(trailer.magic, JOURNAL_COMMIT_MAGIC, sizeof(trailer.magic)) == 0
+            && journal.size() == sizeof(header) + header.entryCount * entrySize + sizeof(trailer)
+            && crc32(journal.data(), journal.size() - sizeof(trailer)) == trailer.crc
+            && readAt(fd, &fileId, sizeof(fileId), HEADER_FILE_ID_OFFSET)
+            && fileId == header.fileId; // Not a leftover from before a full rewrite
+    }
+    for (uint32_t i = 0; complete && i < header.entryCount; ++i) {
+        JournalEntry entry;
+        std::memcpy(&entry, journal.data() + sizeof(header) + i * entrySize, sizeof(entry));
+        complete = crc32(journal.data() + sizeof(header) + i * entrySize + sizeof(entry), PAGED_PAGE_SIZE) == entry.crc;
+    }
+
+    bool ok = true;
+    if (complete) {
+        for (uint32_t i = 0; ok && i < header.entryCount; ++i) {
+            const char* entryData = journal.data() + sizeof(header) + i * entrySize;
+            JournalEntry entry;
+            std::memcpy(&entry, entryData, sizeof(entry));
+            ok = writeAt(fd, entryData + sizeof(entry), PAGED_PAGE_SIZE, static_cast<uint64_t>(entry.page) * PAGED_PAGE_SIZE);
+        }
+        ok = ok && fsync(fd) == 0;
+        if (!ok) {
+            std::cerr << "Error: Could not replay '" << PAGED_JOURNAL_FILE << "' into '" << PAGED_STORE_FILE << "'." << std::endl;
+            return false; // Keep the journal for the next attempt
+        }
+        std::cerr << "Recovered " << header.entryCount << " page(s) of an interrupted commit from '" << PAGED_JOURNAL_FILE << "'." << std::endl;
+    }
+    std::remove(PAGED_JOURNAL_FILE.c_str());
+    return true;
+}
+
+/**
+ * \@brief LRU cache over the pages of one open tasks.db
+ * Clean pages are evicted least recently used first once the cache is full.
+ * Changed (dirty) pages are pinned until commit() has made them durable, so
+ * tasks.db itself is only ever written through the journal
+ * Pointers returned by read() stay valid until the next call into the cache;
+ * pointers returned by write() and append() until the commit
+ */
+class PageCache {
+public:
+    PageCache() = default;
+    PageCache(const PageCache&) = delete;
+    PageCache& operator=(const PageCache&) = delete;
+
+    /**
+     * \@brief Starts caching an open store
+     * \@param fd Descriptor of tasks.db
+     * \@param fileId The store's fileId, recorded in the journal
+     * \@param pageCount Pages in the file
+     */
+    void attach(int fd, uint64_t fileId, uint32_t pageCount) {
+        this->fd = fd;
+        this->fileId = fileId;
+        this->pageCount = pageCount;
+    }
+
+    uint32_t pages() const { return pageCount; }
+
+    /**
+     * \@brief Whether a page could not be read (a zeroed page was handed out instead)
+     */
+    bool failed() const { return readFailed; }
+
+    /**
+     * \@brief The contents of a page, for reading
+     */
+    const char* read(uint32_t page) {
+        return load(page).data.get();
+    }
+
+    /**
+     * \@brief The contents of a page, for changing; the page is pinned until commit
+     */
+    char* write(uint32_t page) {
+        Entry& entry = load(page);
+        if (!entry.dirty) {
+            recency.erase(entry.position); // Pinned pages are not eviction candidates
+            entry.dirty = true;
+            dirtyPages.push_back(page);
+        }
+        return entry.data.get();
+    }
+
+    /**
+     * \@brief Adds a zeroed page at the end of the file, pinned until commit
+     * \@return Its page number
+     */
+    uint32_t append() {
+        uint32_t page = pageCount++;
+        Entry entry;
+        entry.data.reset(new char[PAGED_PAGE_SIZE]());
+        entry.dirty = true;
+        entries.emplace(page, std::move(entry));
+        dirtyPages.push_back(page);
+        return page;
+    }
+
+    /**
+     * \@brief Makes the changed pages durable: journal first, then tasks.db
+     * \@return True once every changed page is in tasks.db
+     */
+    bool commit();
+
+private:
+    struct Entry {
+        std::unique_ptr<char[]> data;
+        bool dirty = false;
+        std::list<uint32_t>::iterator position; // In recency (clean pages only)
+    };
+
+    Entry& load(uint32_t page);
+    void trim();
+
+    int fd = -1;
+    uint64_t fileId = 0;
+    uint32_t pageCount = 0;
+    bool readFailed = false;
+    std::unordered_map<uint32_t, Entry> entries;
+    std::list<uint32_t> recency; // Clean pages, most recently used first
+    std::vector<uint32_t> dirtyPages; // In the order they were first changed
+};
+
+/**
+ * \@brief Finds a page in the cache, reading it (and evicting another) on a miss
+ */
+PageCache::Entry& PageCache::load(uint32_t page) {
+    auto it = entries.find(page);
+    if (it != entries.end()) {
+        if (!it->second.dirty) {
+            recency.splice(recency.begin(), recency, it->second.position);
+        }
+        return it->second;
+    }
+    trim();
+    Entry entry;
+    entry.data.reset(new char[PAGED_PAGE_SIZE]);
+    if (page >= pageCount || !readAt(fd, entry.data.get(), PAGED_PAGE_SIZE, static_cast<uint64_t>(page) * PAGED_PAGE_SIZE)) {
+        std::memset(entry.data.get(), 0, PAGED_PAGE_SIZE); // Decodes as an invalid page
+        readFailed = true;
+    }
+    recency.push_front(page);
+    entry.position = recency.begin();
+    return entries.emplace(page, std::move(entry)).first->second;
+}
+
+/**
+ * \@brief Evicts clean pages until there is room for one more
+ */
+void PageCache::trim() {
+    while (entries.size() >= PAGED_CACHE_PAGES && !recency.empty()) {
+        entries.erase(recency.back());
+        recency.pop_back();
+    }
+}
+
+/**
+ * \@brief Makes the changed pages durable: journal first, then tasks.db
+ * The journal holds every changed page's new image with its checksum, and a
+ * trailer that is only written once all of them are; it is fsynced before
+ * tasks.db is touched, so an interrupted commit either never happened or can
+ * be finished from the journal
+ * \@return True once every changed page is in tasks.db
+ */
+bool PageCache::commit() {
+    if (readFailed) {
+        return false;
+    }
+    if (dirtyPages.empty()) {
+        return true;
+    }
+    std::sort(dirtyPages.begin(), dirtyPages.end()); // Write tasks.db front to back
+
+    int journalFd = open(PAGED_JOURNAL_FILE.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (journalFd < 0) {
+        std::cerr << "Error: Could not open '" << PAGED_JOURNAL_FILE << "' for writing." << std::endl;
+        return false;
+    }
+    JournalHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, JOURNAL_MAGIC, sizeof(header.magic));
+    header.fileId = fileId;
+    header.entryCount = static_cast<uint32_t>(dirtyPages.size());
+
+    std::string buffer(reinterpret_cast<const char*>(&header), sizeof(header));
+    uint64_t offset = 0;
+    uint32_t crc = 0;
+    bool ok = true;
+    for (size_t i = 0; ok && i < dirtyPages.size(); ++i) {
+        const char* data = entries[dirtyPages[i]].data.get();
+        JournalEntry entry = { dirtyPages[i], crc32(data, PAGED_PAGE_SIZE) };
+        buffer.append(reinterpret_cast<const char*>(&entry), sizeof(entry));
+        buffer.append(data, PAGED_PAGE_SIZE);
+        if (buffer.size() >= BULK_WRITE_BYTES || i + 1 == dirtyPages.size()) {
+            crc = crc32(buffer.data(), buffer.size(), crc);
+            ok = writeAt(journalFd, buffer.data(), buffer.size(), offset);
+            offset += buffer.size();
+            buffer.clear();
+        }
+    }
+    JournalTrailer trailer;
+    std::memset(&trailer, 0, sizeof(trailer));
+    std::memcpy(trailer.magic, JOURNAL_COMMIT_MAGIC, sizeof(trailer.magic));
+    trailer.crc = crc;
+    ok = ok && writeAt(journalFd, &trailer, sizeof(trailer), offset) && fsync(journalFd) == 0;
+    ok = (close(journalFd) == 0) && ok;
+    if (!ok) {
+        std::cerr << "Error: Failed to write '" << PAGED_JOURNAL_FILE << "'." << std::endl;
+        std::remove(PAGED_JOURNAL_FILE.c_str()); // tasks.db is untouched
+        return false;
+    }
+    syncWorkingDirectory();
+
+    // The journal is durable: from here on a crash is finished by the next open
+    for (size_t i = 0; ok && i < dirtyPages.size(); ++i) {
+        ok = writeAt(fd, entries[dirtyPages[i]].data.get(), PAGED_PAGE_SIZE, static_cast<uint64_t>(dirtyPages[i]) * PAGED_PAGE_SIZE);
+    }
+    ok = ok && fsync(fd) == 0;
+    if (!ok) {
+        std::cerr << "Error: Failed to write '" << PAGED_STORE_FILE << "'; the next run replays '" << PAGED_JOURNAL_FILE << "'." << std::endl;
+        return false;
+    }
+    std::remove(PAGED_JOURNAL_FILE.c_str());
+
+    // The pages are clean again and may be evicted
+    for (uint32_t page : dirtyPages) {
+        Entry& entry = entries[page];
+        entry.dirty = false;
+        recency.push_front(page);
+        entry.position = recency.begin();
+    }
+    dirtyPages.clear();
+    while (entries.size() > PAGED_CACHE_PAGES) {
+        entries.erase(recency.back());
+        recency.pop_back();
+    }
+    return true;
+}
+
+// --- Page encodings ---
+
+// One leaf record, decoded: the cell and its description if stored inline
+struct LeafRecord {
+    PagedTaskCell cell;
+    std::string text; // Empty if the description is in an overflow chain
+};
+
+// An internal page, decoded: children.size() == keys.size() + 1
+struct InternalNode {
+    std::vector<int32_t> keys;
+    std::vector<uint32_t> children;
+};
+
+static size_t encodedSize(const LeafRecord& record) {
+    return sizeof(PagedTaskCell) + record.text.size();
+}
+
+/**
+ * \@brief Decodes a leaf page
+ * \@return False if the page is not a well-formed leaf
+ */
+static bool decodeLeaf(const char* page, std::vector<LeafRecord>& records) {
+    PageHeader header;
+    std::memcpy(&header, page, sizeof(header));
+    records.clear();
+    if (header.type != PAGE_LEAF) {
+        return false;
+    }
+    records.resize(header.count);
+    size_t pos = sizeof(PageHeader);
+    for (LeafRecord& record : records) {
+        if (pos + sizeof(PagedTaskCell) > PAGED_PAGE_SIZE) {
+            return false;
+        }
+        std::memcpy(&record.cell, page + pos, sizeof(PagedTaskCell));
+        pos += sizeof(PagedTaskCell);
+        if (!(record.cell.flags & CELL_OVERFLOW)) {
+            if (pos + record.cell.descriptionLength > PAGED_PAGE_SIZE) {
+                return false;
+            }
+            record.text.assign(page + pos, record.cell.descriptionLength);
+            pos += record.cell.descriptionLength;
+        }
+    }
+    return true;
+}
+
+/**
+ * \@brief Encodes records [first, last) as a leaf page (they must fit)
+ */
+static void encodeLeaf(char* page, const std::vector<LeafRecord>& records, size_t first, size_t last) {
+    std::memset(page, 0, PAGED_PAGE_SIZE);
+    PageHeader header = { PAGE_LEAF, 0, static_cast<uint16_t>(last - first), 0 };
+    std::memcpy(page, &header, sizeof(header));
+    size_t pos = sizeof(PageHeader);
+    for (size_t i = first; i < last; ++i) {
+        std::memcpy(page + pos, &records[i].cell, sizeof(PagedTaskCell));
+        pos += sizeof(PagedTaskCell);
+        std::memcpy(page + pos, records[i].text.data(), records[i].text.size());
+        pos += records[i].text.size();
+    }
+}
+
+/**
+ * \@brief Decodes an internal page
+ * \@return False if the page is not a well-formed internal page
+ */
+static bool decodeInternal(const char* page, InternalNode& node) {
+    PageHeader header;
+    std::memcpy(&header, page, sizeof(header));
+    if (header.type != PAGE_INTERNAL || header.count > INTERNAL_MAX_KEYS) {
+        return false;
+    }
+    node.keys.resize(header.count);
+    node.children.resize(header.count + 1);
+    node.children[0] = header.link;
+    for (size_t i = 0; i < header.count; ++i) {
+        InternalEntry entry;
+        std::memcpy(&entry, page + sizeof(PageHeader) + i * sizeof(InternalEntry), sizeof(entry));
+        node.keys[i] = entry.key;
+        node.children[i + 1] = entry.child;
+    }
+    return true;
+}
+
+/**
+ * \@brief Encodes an internal page (at most INTERNAL_MAX_KEYS keys)
+ */
+static void encodeInternal(char* page, const InternalNode& node) {
+    std::memset(page, 0, PAGED_PAGE_SIZE);
+    PageHeader header = { PAGE_INTERNAL, 0, static_cast<uint16_t>(node.keys.size()), node.children[0] };
+    std::memcpy(page, &header, sizeof(header));
+    for (size_t i = 0; i < node.keys.size(); ++i) {
+        InternalEntry entry = { node.keys[i], node.children[i + 1] };
+        std::memcpy(page + sizeof(PageHeader) + i * sizeof(InternalEntry), &entry, sizeof(entry));
+    }
+}
+
+/**
+ * \@brief Picks the child of an internal page whose subtree holds an id, without decoding the page
+ * \@param index Output parameter: the child's position (0 = leftmost)
+ * \@return The child's page number, or 0 if the page is not an internal page
+ */
+static uint32_t childFor(const char* page, int id, size_t& index) {
+    PageHeader header;
+    std::memcpy(&header, page, sizeof(header));
+    if (header.type != PAGE_INTERNAL || header.count > INTERNAL_MAX_KEYS) {
+        return 0;
+    }
+    // Binary search for the number of keys <= id
+    size_t low = 0;
+    size_t high = header.count;
+    while (low < high) {
+        size_t mid = (low + high) / 2;
+        InternalEntry entry;
+        std::memcpy(&entry, page + sizeof(PageHeader) + mid * sizeof(InternalEntry), sizeof(entry));
+        if (entry.key <= id) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    index = low;
+    if (low == 0) {
+        return header.link;
+    }
+    InternalEntry entry;
+    std::memcpy(&entry, page + sizeof(PageHeader) + (low - 1) * sizeof(InternalEntry), sizeof(entry));
+    return entry.child;
+}
+
+/**
+ * \@brief Finds where a record with an id sits (or would sit) in a sorted leaf
+ */
+static std::vector<LeafRecord>::iterator findRecord(std::vector<LeafRecord>& records, int id) {
+    return std::lower_bound(records.begin(), records.end(), id,
+                            [](const LeafRecord& record, int key) { return record.cell.id < key; });
+}
+
+// --- The tree ---
+
+/**
+ * \@brief An open tasks.db: the header, the page cache and the B+tree operations
+ * A failed read or a malformed page marks the store broken; every operation then
+ * does nothing and commit() refuses, so the caller falls back to a full rewrite
+ */
+class PagedTaskStore {
+public:
+    PagedTaskStore() = default;
+    ~PagedTaskStore() {
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+    PagedTaskStore(const PagedTaskStore&) = delete;
+    PagedTaskStore& operator=(const PagedTaskStore&) = delete;
+
+    bool open();
+    bool find(int id, Task& task);
+    void put(const Task& task);
+    void erase(int id);
+    void scan(std::vector<Task>& tasks);
+    bool commit(int nextId);
+
+    const PagedStoreHeader& header() const { return head; }
+
+private:
+    // An internal page on the way down, and which of its children was taken
+    struct PathStep {
+        uint32_t page;
+        size_t child;
+    };
+
+    bool broken() { return corrupt || cache.failed(); }
+    void markCorrupt(uint32_t page);
+    uint32_t descend(int id, std::vector<PathStep>& path);
+    void insertSeparator(std::vector<PathStep>& path, int32_t key, uint32_t child);
+    uint32_t allocatePage();
+    void freePage(uint32_t page);
+    LeafRecord makeRecord(const Task& task);
+    uint32_t writeOverflow(const std::string& text);
+    bool readDescription(const LeafRecord& record, std::string& description);
+    void releaseOverflow(const LeafRecord& record);
+    void scanPage(uint32_t page, uint32_t level, std::vector<Task>& tasks);
+
+    int fd = -1;
+    PagedStoreHeader head;
+    uint64_t fileId = 0;
+    PageCache cache;
+    bool corrupt = false;
+};
+
+/**
+ * \@brief Opens tasks.db, finishing an interrupted commit first
+ * \@return False if the file is missing or its header is invalid
+ */
+bool PagedTaskStore::open() {
+    fd = ::open(PAGED_STORE_FILE.c_str(), O_RDWR);
+    if (fd < 0) {
+        return false;
+    }
+    if (!recoverJournal(fd)) {
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || !readAt(fd, &head, sizeof(head), 0)) {
+        return false;
+    }
+    std::memcpy(&fileId, reinterpret_cast<const char*>(&head) + HEADER_FILE_ID_OFFSET, sizeof(fileId));
+    bool valid = std::memcmp(head.magic, PAGED_STORE_MAGIC, sizeof(head.magic)) == 0
+        && head.version == PAGED_STORE_VERSION
+        && head.pageSize == PAGED_PAGE_SIZE
+        && static_cast<uint64_t>(head.pageCount) * PAGED_PAGE_SIZE <= static_cast<uint64_t>(info.st_size)
+        && head.rootPage > 0 && head.rootPage < head.pageCount
+        && head.treeHeight >= 1;
+    if (!valid) {
+        return false;
+    }
+    cache.attach(fd, fileId, head.pageCount);
+    return true;
+}
+
+/**
+ * \@brief Marks the store broken, once, naming the page that did not decode
+ */
+void PagedTaskStore::markCorrupt(uint32_t page) {
+    if (!corrupt) {
+        std::cerr << "Warning: Page " << page << " of '" << PAGED_STORE_FILE << "' is malformed." << std::endl;
+    }
+    corrupt = true;
+}
+
+/**
+ * \@brief Walks from the root to the leaf that holds (or would hold) an id
+ * \@param path Output parameter: the internal pages passed, root first
+ * \@return The leaf's page number (0 if the store is broken)
+ */
+uint32_t PagedTaskStore::descend(int id, std::vector<PathStep>& path) {
+    path.clear();
+    uint32_t page = head.rootPage;
+    for (uint32_t level = head.treeHeight; level > 1; --level) {
+        size_t index = 0;
+        uint32_t child = childFor(cache.read(page), id, index);
+        if (child == 0 || child >= cache.pages()) {
+            markCorrupt(page);
+            return 0;
+        }
+        path.push_back(PathStep{ page, index });
+        page = child;
+    }
+    return page;
+}
+
+/**
+ * \@brief Reads one task
+ * \@return True if the store holds a task with this id
+ */
+bool PagedTaskStore::find(int id, Task& task) {
+    std::vector<PathStep> path;
+    uint32_t page = descend(id, path);
+    std::vector<LeafRecord> records;
+    if (page == 0 || !decodeLeaf(cache.read(page), records)) {
+        markCorrupt(page);
+        return false;
+    }
+    auto it = findRecord(records, id);
+    if (it == records.end() || it->cell.id != id || it->cell.status >= TASK_STATUS_COUNT) {
+        return false;
+    }
+    std::string description;
+    if (!readDescription(*it, description)) {
+        return false;
+    }
+    task = Task(id, std::move(description), static_cast<TaskStatus>(it->cell.status),
+                fromCellTime(it->cell.createdAt), fromCellTime(it->cell.updatedAt));
+    return true;
+}
+
+/**
+ * \@brief Adds a task or replaces the stored one with the same id
+ * Rewrites its leaf; a leaf that no longer fits splits in two, and the split
+ * travels up as far as the parents are full
+ */
+void PagedTaskStore::put(const Task& task) {
+    std::vector<PathStep> path;
+    uint32_t page = descend(task.id, path);
+    std::vector<LeafRecord> records;
+    if (page == 0 || !decodeLeaf(cache.read(page), records)) {
+        markCorrupt(page);
+        return;
+    }
+
+    auto it = findRecord(records, task.id);
+    size_t index = static_cast<size_t>(it - records.begin());
+    if (it != records.end() && it->cell.id == task.id) {
+        // Keep an overflow chain whose text is unchanged (a status change on a long task)
+        std::string current;
+        if ((it->cell.flags & CELL_OVERFLOW) && it->cell.descriptionLength == task.description.size()
+            && readDescription(*it, current) && current == task.description) {
+            it->cell.status = static_cast<uint8_t>(task.status);
+            it->cell.createdAt = toCellTime(task.createdAt);
+            it->cell.updatedAt = toCellTime(task.updatedAt);
+        } else {
+            releaseOverflow(*it);
+            *it = makeRecord(task);
+        }
+    } else {
+        records.insert(it, makeRecord(task));
+        ++head.taskCount;
+    }
+
+    size_t total = 0;
+    for (const LeafRecord& record : records) {
+        total += encodedSize(record);
+    }
+    if (total <= PAGE_BODY_SIZE) {
+        encodeLeaf(cache.write(page), records, 0, records.size());
+        return;
+    }
+
+    // Split. A record added at the end (new tasks get the highest id) goes alone to
+    // the new right leaf, so appends leave full leaves behind instead of half-empty ones
+    size_t split = records.size() - 1;
+    if (index + 1 != records.size()) {
+        size_t half = 0;
+        split = 0;
+        while (split < records.size() - 1 && half < total / 2) {
+            half += encodedSize(records[split++]);
+        }
+        split = std::max<size_t>(split, 1);
+    }
+    uint32_t right = allocatePage();
+    encodeLeaf(cache.write(page), records, 0, split);
+    encodeLeaf(cache.write(right), records, split, records.size());
+    insertSeparator(path, records[split].cell.id, right);
+}
+
+/**
+ * \@brief Links a new right sibling into the parent, splitting full parents on the way up
+ * \@param path The internal pages above the split page (consumed)
+ * \@param key The smallest id under the new page
+ * \@param child The new page
+ */
+void PagedTaskStore::insertSeparator(std::vector<PathStep>& path, int32_t key, uint32_t child) {
+    while (!path.empty()) {
+        PathStep step = path.back();
+        path.pop_back();
+        InternalNode node;
+        if (!decodeInternal(cache.read(step.page), node)) {
+            markCorrupt(step.page);
+            return;
+        }
+        node.keys.insert(node.keys.begin() + static_cast<std::ptrdiff_t>(step.child), key);
+        node.children.insert(node.children.begin() + static_cast<std::ptrdiff_t>(step.child) + 1, child);
+        if (node.keys.size() <= INTERNAL_MAX_KEYS) {
+            encodeInternal(cache.write(step.page), node);
+            return;
+        }
+        // The middle key moves up; the keys after it go to the new right page
+        size_t middle = node.keys.size() / 2;
+        InternalNode rightNode;
+        rightNode.keys.assign(node.keys.begin() + static_cast<std::ptrdiff_t>(middle) + 1, node.keys.end());
+        rightNode.children.assign(node.children.begin() + static_cast<std::ptrdiff_t>(middle) + 1, node.children.end());
+        key = node.keys[middle];
+        node.keys.resize(middle);
+        node.children.resize(middle + 1);
+        uint32_t right = allocatePage();
+        encodeInternal(cache.write(step.page), node);
+        encodeInternal(cache.write(right), rightNode);
+        child = right;
+    }
+    // The root split: a new root above the two halves
+    InternalNode root;
+    root.keys.push_back(key);
+    root.children.push_back(head.rootPage);
+    root.children.push_back(child);
+    uint32_t page = allocatePage();
+    encodeInternal(cache.write(page), root);
+    head.rootPage = page;
+    ++head.treeHeight;
+}
+
+/**
+ * \@brief Removes a task if the store holds it
+ * An emptied leaf is freed and unlinked from its parent (and an emptied parent
+ * from its own); a root left with a single child hands the root role down
+ */
+void PagedTaskStore::erase(int id) {
+    std::vector<PathStep> path;
+    uint32_t page = descend(id, path);
+    std::vector<LeafRecord> records;
+    if (page == 0 || !decodeLeaf(cache.read(page), records)) {
+        markCorrupt(page);
+        return;
+    }
+    auto it = findRecord(records, id);
+    if (it == records.end() || it->cell.id != id) {
+        return; // Not stored
+    }
+    releaseOverflow(*it);
+    records.erase(it);
+    --head.taskCount;
+    if (!records.empty() || path.empty()) {
+        encodeLeaf(cache.write(page), records, 0, records.size());
+        return;
+    }
+
+    freePage(page);
+    bool emptied = true;
+    while (emptied && !path.empty()) {
+        PathStep step = path.back();
+        path.pop_back();
+        InternalNode node;
+        if (!decodeInternal(cache.read(step.page), node)) {
+            markCorrupt(step.page);
+            return;
+        }
+        node.children.erase(node.children.begin() + static_cast<std::ptrdiff_t>(step.child));
+        if (!node.keys.empty()) {
+            // Drop the separator in front of the removed child (or after it, for the leftmost)
+            node.keys.erase(node.keys.begin() + static_cast<std::ptrdiff_t>(step.child > 0 ? step.child - 1 : 0));
+        }
+        emptied = node.children.empty();
+        if (emptied) {
+            freePage(step.page);
+        } else {
+            encodeInternal(cache.write(step.page), node);
+        }
+    }
+    if (emptied) {
+        // Every page went, the root included: start over with an empty leaf
+        head.rootPage = allocatePage();
+        encodeLeaf(cache.write(head.rootPage), std::vector<LeafRecord>(), 0, 0);
+        head.treeHeight = 1;
+        return;
+    }
+    while (head.treeHeight > 1) {
+        InternalNode root;
+        if (!decodeInternal(cache.read(head.rootPage), root)) {
+            markCorrupt(head.rootPage);
+            return;
+        }
+        if (!root.keys.empty()) {
+            break;
+        }
+        freePage(head.rootPage);
+        head.rootPage = root.children[0];
+        --head.treeHeight;
+    }
+}
+
+/**
+ * \@brief Takes a page off the free list, or adds one to the end of the file
+ */
+uint32_t PagedTaskStore::allocatePage() {
+    if (head.freeListHead == 0) {
+        return cache.append();
+    }
+    uint32_t page = head.freeListHead;
+    PageHeader header;
+    std::memcpy(&header, cache.read(page), sizeof(header));
+    if (header.type != PAGE_FREE || header.link >= cache.pages()) {
+        markCorrupt(page);
+        head.freeListHead = 0; // Stop trusting the list; new pages come from the end
+        return cache.append();
+    }
+    head.freeListHead = header.link;
+    --head.freePageCount;
+    return page;
+}
+
+/**
+ * \@brief Puts a page on the free list
+ */
+void PagedTaskStore::freePage(uint32_t page) {
+    char* data = cache.write(page);
+    std::memset(data, 0, PAGED_PAGE_SIZE);
+    PageHeader header = { PAGE_FREE, 0, 0, head.freeListHead };
+    std::memcpy(data, &header, sizeof(header));
+    head.freeListHead = page;
+    ++head.freePageCount;
+}
+
+/**
+ * \@brief Builds the leaf record for a task, moving a long description to overflow pages
+ */
+LeafRecord PagedTaskStore::makeRecord(const Task& task) {
+    LeafRecord record;
+    std::memset(&record.cell, 0, sizeof(record.cell));
+    record.cell.id = task.id;
+    record.cell.status = static_cast<uint8_t>(task.status);
+    record.cell.descriptionLength = static_cast<uint32_t>(task.description.size());
+    record.cell.createdAt = toCellTime(task.createdAt);
+    record.cell.updatedAt = toCellTime(task.updatedAt);
+    if (task.description.size() > PAGED_INLINE_DESCRIPTION_LIMIT) {
+        record.cell.flags = CELL_OVERFLOW;
+        record.cell.overflowPage = writeOverflow(task.description);
+    } else {
+        record.text = task.description;
+    }
+    return record;
+}
+
+/**
+ * \@brief Writes text to a chain of overflow pages
+ * \@return The first page of the chain
+ */
+uint32_t PagedTaskStore::writeOverflow(const std::string& text) {
+    uint32_t first = 0;
+    char* previous = nullptr; // Pinned until the commit, so the pointer stays valid
+    for (size_t pos = 0; pos < text.size(); pos += PAGE_BODY_SIZE) {
+        uint32_t page = allocatePage();
+        char* data = cache.write(page);
+        std::memset(data, 0, PAGED_PAGE_SIZE);
+        PageHeader header = { PAGE_OVERFLOW, 0, 0, 0 };
+        std::memcpy(data, &header, sizeof(header));
+        std::memcpy(data + sizeof(PageHeader), text.data() + pos, std::min(PAGE_BODY_SIZE, text.size() - pos));
+        if (previous != nullptr) {
+            std::memcpy(previous + offsetof(PageHeader, link), &page, sizeof(page));
+        } else {
+            first = page;
+        }
+        previous = data;
+    }
+    return first;
+}
+
+/**
+ * \@brief The description of a record, from the leaf or from its overflow chain
+ * \@return False if the chain is broken
+ */
+bool PagedTaskStore::readDescription(const LeafRecord& record, std::string& description) {
+    if (!(record.cell.flags & CELL_OVERFLOW)) {
+        description = record.text;
+        return true;
+    }
+    description.clear();
+    description.reserve(record.cell.descriptionLength);
+    uint32_t page = record.cell.overflowPage;
+    while (description.size() < record.cell.descriptionLength) {
+        const char* data = page != 0 && page < cache.pages() ? cache.read(page) : nullptr;
+        PageHeader header;
+        if (data != nullptr) {
+            std::memcpy(&header, data, sizeof(header));
+        }
+        if (data == nullptr || header.type != PAGE_OVERFLOW) {
+            markCorrupt(page);
+            return false;
+        }
+        size_t chunk = std::min<size_t>(PAGE_BODY_SIZE, record.cell.descriptionLength - description.size());
+        description.append(data + sizeof(PageHeader), chunk);
+        page = header.link;
+    }
+    return true;
+}
+
+/**
+ * \@brief Frees the overflow chain of a record that is being replaced or deleted
+ */
+void PagedTaskStore::releaseOverflow(const LeafRecord& record) {
+    if (!(record.cell.flags & CELL_OVERFLOW)) {
+        return;
+    }
+    uint32_t page = record.cell.overflowPage;
+    while (page != 0 && page < cache.pages()) {
+        PageHeader header;
+        std::memcpy(&header, cache.read(page), sizeof(header));
+        if (header.type != PAGE_OVERFLOW) {
+            markCorrupt(page);
+            return;
+        }
+        freePage(page);
+        page = header.link;
+    }
+}
+
+/**
+ * \@brief Appends every task under a page to tasks, in id order
+ * \@param level Height of the page above the leaves (1 = leaf)
+ */
+void PagedTaskStore::scanPage(uint32_t page, uint32_t level, std::vector<Task>& tasks) {
+    if (broken()) {
+        return;
+    }
+    if (level > 1) {
+        InternalNode node;
+        if (!decodeInternal(cache.read(page), node)) {
+            markCorrupt(page);
+            return;
+        }
+        for (uint32_t child : node.children) {
+            scanPage(child, level - 1, tasks);
+        }
+        return;
+    }
+    std::vector<LeafRecord> records;
+    if (!decodeLeaf(cache.read(page), records)) {
+        markCorrupt(page);
+        return;
+    }
+    for (const LeafRecord& record : records) {
+        std::string description;
+        if (record.cell.status >= TASK_STATUS_COUNT || !readDescription(record, description)) {
+            std::cerr << "Warning: Skipping task " << record.cell.id << " with an invalid description or status in '" << PAGED_STORE_FILE << "'." << std::endl;
+            continue;
+        }
+        tasks.emplace_back(record.cell.id, std::move(description), static_cast<TaskStatus>(record.cell.status),
+                           fromCellTime(record.cell.createdAt), fromCellTime(record.cell.updatedAt));
+    }
+}
+
+/**
+ * \@brief Reads every task, in id order
+ */
+void PagedTaskStore::scan(std::vector<Task>& tasks) {
+    tasks.reserve(static_cast<size_t>(head.taskCount));
+    scanPage(head.rootPage, head.treeHeight, tasks);
+}
+
+/**
+ * \@brief Writes the header and every changed page through the journal
+ * \@param nextId The next-id counter to store
+ * \@return False if the store is broken or the pages could not be written
+ */
+bool PagedTaskStore::commit(int nextId) {
+    if (broken()) {
+        return false;
+    }
+    head.nextId = nextId;
+    head.pageCount = cache.pages();
+    char* page = cache.write(0);
+    std::memset(page, 0, PAGED_PAGE_SIZE);
+    std::memcpy(page, &head, sizeof(head));
+    return cache.commit();
+}
+
+// --- Public interface ---
+
+/**
+ * \@brief Loads every task from tasks.db by walking the tree's leaves in id order
+ * \@param nextId Output parameter: the stored next-id counter
+ * \@return The tasks in id order. Returns empty vector if the file is missing or invalid
+ */
+std::vector<Task> loadPagedTasks(int& nextId) {
+    std::vector<Task> tasks;
+    nextId = 0;
+    PagedTaskStore store;
+    if (!store.open()) {
+        std::cerr << "Warning: '" << PAGED_STORE_FILE << "' is malformed or empty. Starting with empty task list." << std::endl;
+        return tasks;
+    }
+    // Counted as parsing, like tasks.bin: the pages are read as the records are decoded
+    PhaseTimer parseTimer(StatsPhase::PARSE);
+    nextId = store.header().nextId;
+    store.scan(tasks);
+    return tasks;
+}
+
+/**
+ * \@brief Reads one task from tasks.db through the tree, without loading the others
+ * \@param id The ID of the task to find
+ * \@param task Output parameter: the task, if found
+ * \@return True if the store holds a task with this id
+ */
+bool findPagedTask(int id, Task& task) {
+    PagedTaskStore store;
+    return store.open() && store.find(id, task);
+}
+
+/**
+ * \@brief Buffered, sequential writer of the pages of a new tasks.db
+ */
+class PageWriter {
+public:
+    explicit PageWriter(int fd) : fd(fd) {}
+
+    /**
+     * \@brief The page number the next emitted page gets
+     */
+    uint32_t nextPage() const { return pageCount; }
+
+    /**
+     * \@brief Appends one page image
+     * \@return Its page number
+     */
+    uint32_t emit(const char* page) {
+        buffer.append(page, PAGED_PAGE_SIZE);
+        if (buffer.size() >= BULK_WRITE_BYTES) {
+            flush();
+        }
+        return pageCount++;
+    }
+
+    /**
+     * \@brief Writes what is buffered
+     * \@return False once any write has failed
+     */
+    bool flush() {
+        ok = ok && writeAt(fd, buffer.data(), buffer.size(), written);
+        written += buffer.size();
+        buffer.clear();
+        return ok;
+    }
+
+private:
+    int fd;
+    std::string buffer;
+    uint64_t written = 0;
+    uint32_t pageCount = 0;
+    bool ok = true;
+};
+
+/**
+ * \@brief Writes a complete, tightly packed tasks.db (via a temporary file and rename)
+ * Leaves are filled in id order and written front to back; each internal level
+ * is then built over the one below until a single root remains
+ * \@param ordered The tasks to store, in any order
+ * \@param nextId The next-id counter to store in the header
+ * \@return True on success, false otherwise
+ */
+bool savePagedTasks(std::vector<const Task*> ordered, int nextId) {
+    PhaseTimer writeTimer(StatsPhase::WRITE); // Encoding pages is trivial next to writing them
+    std::sort(ordered.begin(), ordered.end(), [](const Task* a, const Task* b) { return a->id < b->id; });
+
+    const std::string tempFile = PAGED_STORE_FILE + ".tmp";
+    int fd = open(tempFile.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        std::cerr << "Error: Could not open '" << tempFile << "' for writing." << std::endl;
+        return false;
+    }
+    PageWriter writer(fd);
+    std::vector<char> page(PAGED_PAGE_SIZE, 0);
+    writer.emit(page.data()); // Page 0, the header, is written last
+
+    // Leaves, each as full as its records allow; (first id, page) of each for the level above
+    std::vector<InternalEntry> level;
+    std::vector<LeafRecord> records;
+    size_t used = 0;
+    auto emitLeaf = [&]() {
+        encodeLeaf(page.data(), records, 0, records.size());
+        uint32_t number = writer.emit(page.data());
+        level.push_back(InternalEntry{ records.empty() ? 0 : records.front().cell.id, number });
+        records.clear();
+        used = 0;
+    };
+    for (const Task* task : ordered) {
+        LeafRecord record;
+        std::memset(&record.cell, 0, sizeof(record.cell));
+        record.cell.id = task->id;
+        record.cell.status = static_cast<uint8_t>(task->status);
+        record.cell.descriptionLength = static_cast<uint32_t>(task->description.size());
+        record.cell.createdAt = toCellTime(task->createdAt);
+        record.cell.updatedAt = toCellTime(task->updatedAt);
+        if (task->description.size() > PAGED_INLINE_DESCRIPTION_LIMIT) {
+            // The chain goes out right away, on consecutive pages
+            record.cell.flags = CELL_OVERFLOW;
+            record.cell.overflowPage = writer.nextPage();
+            for (size_t pos = 0; pos < task->description.size(); pos += PAGE_BODY_SIZE) {
+                size_t chunk = std::min(PAGE_BODY_SIZE, task->description.size() - pos);
+                uint32_t next = pos + chunk < task->description.size() ? writer.nextPage() + 1 : 0;
+                std::fill(page.begin(), page.end(), 0);
+                PageHeader header = { PAGE_OVERFLOW, 0, 0, next };
+                std::memcpy(page.data(), &header, sizeof(header));
+                std::memcpy(page.data() + sizeof(PageHeader), task->description.data() + pos, chunk);
+                writer.emit(page.data());
+            }
+        } else {
+            record.text = task->description;
+        }
+        if (used + encodedSize(record) > PAGE_BODY_SIZE) {
+            emitLeaf();
+        }
+        used += encodedSize(record);
+        records.push_back(std::move(record));
+    }
+    if (!records.empty() || level.empty()) {
+        emitLeaf(); // The last leaf, or the empty root leaf of an empty store
+    }
+
+    uint32_t height = 1;
+    while (level.size() > 1) {
+        std::vector<InternalEntry> parents;
+        for (size_t first = 0; first < level.size(); first += INTERNAL_MAX_KEYS + 1) {
+            size_t last = std::min(level.size(), first + INTERNAL_MAX_KEYS + 1);
+            InternalNode node;
+            node.children.push_back(level[first].child);
+            for (size_t i = first + 1; i < last; ++i) {
+                node.keys.push_back(level[i].key);
+                node.children.push_back(level[i].child);
+            }
+            encodeInternal(page.data(), node);
+            parents.push_back(InternalEntry{ level[first].key, writer.emit(page.data()) });
+        }
+        level.swap(parents);
+        ++height;
+    }
+
+    PagedStoreHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, PAGED_STORE_MAGIC, sizeof(header.magic));
+    header.version = PAGED_STORE_VERSION;
+    header.pageSize = PAGED_PAGE_SIZE;
+    header.pageCount = writer.nextPage();
+    header.rootPage = level[0].child;
+    header.treeHeight = height;
+    header.nextId = nextId;
+    header.taskCount = ordered.size();
+    // A fresh identity, so a journal written against the old file is never replayed onto this one
+    uint64_t fileId = static_cast<uint64_t>(toCellTime(std::chrono::system_clock::now()));
+    std::memcpy(reinterpret_cast<char*>(&header) + HEADER_FILE_ID_OFFSET, &fileId, sizeof(fileId));
+
+    bool ok = writer.flush() && writeAt(fd, &header, sizeof(header), 0) && fsync(fd) == 0;
+    ok = (close(fd) == 0) && ok;
+    if (!ok || std::rename(tempFile.c_str(), PAGED_STORE_FILE.c_str()) != 0) {
+        std::cerr << "Error: Failed to write '" << PAGED_STORE_FILE << "'." << std::endl;
+        std::remove(tempFile.c_str());
+        return false;
+    }
+    syncWorkingDirectory();
+    std::remove(PAGED_JOURNAL_FILE.c_str()); // Belongs to the replaced file (and would not match it)
+    return true;
+}
+
+/**
+ * \@brief Applies individual changes to tasks.db, touching only the pages on their paths
+ * \@param changes The changes to apply, in order
+ * \@param nextId The current next-id counter, stored in the header
+ * \@return False if tasks.db is missing or cannot be updated (the caller should
+ * rewrite the whole file with savePagedTasks), true otherwise
+ */
+bool applyPagedChanges(const std::vector<TaskChange>& changes, int nextId) {
+    PhaseTimer writeTimer(StatsPhase::WRITE);
+    PagedTaskStore store;
+    if (!store.open()) {
+        return false; // No file yet: the first save writes it in full
+    }
+    for (const auto& change : changes) {
+        if (change.deleted) {
+            store.erase(change.id);
+        } else {
+            store.put(change.task);
+        }
+    }
+    return store.commit(nextId);
+}
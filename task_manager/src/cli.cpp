@@ -0,0 +1,632 @@
+#include "cli.h"
+#include <iostream>
+#include <vector>
+#include <string>
+#include <stdexcept>
+#include <limits> // For std::numeric_limits
+#include <utility> // For std::make_pair
+#include <chrono> // For timing the batch for --stats
+#include <fstream> // For export files
+#include "task.h"
+#include "commands.h" // Task manipulation functions (add, update, delete, list, mark) 
+#include "storage.h" // For commitTasks, recordFullRewrite
+#include "task_list.h" // For TaskList
+#include "search_index.h" // For SearchIndex::tokenize
+#include "stats.h" // For addPhaseTime
+#include "transfer.h" // For importTasks, exportTasks
+#include "time_index.h" // For TimeField (list --by)
+
+// Helper function to print usage instructions
+void printUsage(const char* progName) {
+    std::cerr << " " << std::endl;
+    std::cerr << "Usage: " << progName << " [--stats] <command> [options]" << std::endl;
+    std::cerr << "Commands:" << std::endl;
+    std::cerr << " add \"<description>\"" << std::endl;
+    std::cerr << " update <id> \"<new_description>\"" << std::endl;
+    std::cerr << " delete <ids>" << std::endl;
+    std::cerr << " mark-in-progress <ids>" << std::endl; 
+    std::cerr << " mark-done <ids>" << std::endl; 
+    std::cerr << " list [todo|in-progress|done] [--where <expr>] [--limit N] [--offset N] [--sort created|updated|id]" << std::endl;
+    std::cerr << "   <expr>: e.g. \"status=todo and created>=2025-01-01 and desc~deploy\"" << std::endl;
+    std::cerr << "           fields status, id, created, updated (= != < <= > >=), desc (~); and, or, not, ( )" << std::endl;
+    std::cerr << "      [--since <time>] [--until <time>] [--by updated|created]   (default: updated)" << std::endl;
+    std::cerr << "   <time>: YYYY-MM-DD | \"YYYY-MM-DD HH:MM:SS\" | an age such as 30m, 24h, 7d, 2w" << std::endl;
+    std::cerr << " search <terms...>   (tasks containing every word)" << std::endl;
+    std::cerr << " import <file> [--format ndjson|csv]   (add every record as a new task)" << std::endl;
+    std::cerr << " export [--format ndjson|csv] [file]   (all tasks, to stdout by default)" << std::endl;
+    std::cerr << " compact        (drop deleted tasks from memory and rewrite the store without them)" << std::endl;
+    std::cerr << " batch [file]   (one command per line, from file or stdin)" << std::endl;
+    std::cerr << " serve          (keep tasks in memory and serve other task-cli calls)" << std::endl;
+    std::cerr << "   <ids>: 5 | 3,7,9 | 10-500 (lists and ranges mix) | --status todo|in-progress|done" << std::endl;
+    std::cerr << "Options:" << std::endl;
+    std::cerr << " --stats        (print phase timings, bytes read/written and heap allocations to stderr)" << std::endl;
+}
+
+/**
+ * \@brief Parses a non-negative count such as the value of --limit
+ * \@return True if text is a plain decimal number that fits in size_t
+ */
+static bool parseCount(const std::string& text, size_t& value) {
+    if (text.empty() || text.size() > 18 || text.find_first_not_of("0123456789") != std::string::npos) {
+        return false;
+    }
+    value = static_cast<size_t>(std::stoull(text));
+    return true;
+}
+
+/**
+ * \@brief Parses the arguments of 'list': [status] [--where expr] [--since time] [--until time]
+ * [--by field] [--limit N] [--offset N] [--sort key], in any order
+ * Flags take their value as the next argument or after '=' (--limit=10)
+ * --since and --until bound the updated time (or the created time, with --by created),
+ * both ends inclusive, and combine with --where
+ * \@param args The command and its arguments
+ * \@param options Output parameter: the parsed options
+ * \@param error Output parameter: what was wrong, if parsing fails
+ * \@return True on success
+ */
+static bool parseListOptions(const std::vector<std::string>& args, ListOptions& options, std::string& error) {
+    std::string since;
+    std::string until;
+    TimeField timeField = TimeField::UPDATED;
+    for (size_t i = 1; i < args.size(); ++i) {
+        std::string flag = args[i];
+        if (flag.compare(0, 2, "--") != 0) {
+            if (!options.filterStatus.empty()) {
+                error = "'list' command takes at most one status filter: [todo|in-progress|done]";
+                return false;
+            }
+            if (flag != "todo" && flag != "in-progress" && flag != "done") {
+                error = "Invalid status filter. Use 'todo', 'in-progress', or 'done'.";
+                return false;
+            }
+            options.filterStatus = flag;
+            continue;
+        }
+
+        std::string value;
+        size_t equals = flag.find('=');
+        if (equals != std::string::npos) {
+            value = flag.substr(equals + 1);
+            flag.erase(equals);
+        } else if (i + 1 < args.size()) {
+            value = args[++i];
+        } else {
+            error = "'" + flag + "' requires a value.";
+            return false;
+        }
+
+        if (flag == "--where") {
+            if (!options.where.empty()) {
+                error = "'list' command takes at most one --where expression (combine them with 'and').";
+                return false;
+            }
+            if (!TaskQuery::compile(value, options.where, error)) {
+                return false;
+            }
+        } else if (flag == "--since") {
+            since = value;
+        } else if (flag == "--until") {
+            until = value;
+        } else if (flag == "--by") {
+            if (value == "created") {
+                timeField = TimeField::CREATED;
+            } else if (value == "updated") {
+                timeField = TimeField::UPDATED;
+            } else {
+                error = "Invalid --by field. Use 'created' or 'updated'.";
+                return false;
+            }
+        } else if (flag == "--limit") {
+            if (!parseCount(value, options.limit) || options.limit == 0) {
+                error = "--limit must be a positive number.";
+                return false;
+            }
+        } else if (flag == "--offset") {
+            if (!parseCount(value, options.offset)) {
+                error = "--offset must be a non-negative number.";
+                return false;
+            }
+        } else if (flag == "--sort") {
+            if (value == "id") {
+                options.sortKey = ListSortKey::ID;
+            } else if (value == "created") {
+                options.sortKey = ListSortKey::CREATED;
+            } else if (value == "updated") {
+                options.sortKey = ListSortKey::UPDATED;
+            } else {
+                error = "Invalid sort key. Use 'created', 'updated', or 'id'.";
+                return false;
+            }
+        } else {
+            error = "Unknown option '" + flag + "' for 'list'.";
+            return false;
+        }
+    }
+    // Bounds go in last, so --where may come before or after them
+    if (!since.empty() && !options.where.addTimeBound(timeField, true, since, error)) {
+        return false;
+    }
+    if (!until.empty() && !options.where.addTimeBound(timeField, false, until, error)) {
+        return false;
+    }
+    return true;
+}
+
+/**
+ * \@brief Parses the arguments of 'import' and 'export': [file] [--format ndjson|csv], in any order
+ * Without --format, the format follows the file name (.csv is CSV, anything else NDJSON)
+ * \@param args The command and its arguments
+ * \@param path Output parameter: the file, or empty if none was given
+ * \@param format Output parameter: the record format
+ * \@param error Output parameter: what was wrong, if parsing fails
+ * \@return True on success
+ */
+static bool parseTransferOptions(const std::vector<std::string>& args, std::string& path, TransferFormat& format,
+                                 std::string& error) {
+    bool formatGiven = false;
+    for (size_t i = 1; i < args.size(); ++i) {
+        std::string flag = args[i];
+        if (flag.compare(0, 8, "--format") != 0) {
+            if (!path.empty()) {
+                error = "'" + args[0] + "' command takes at most one file.";
+                return false;
+            }
+            path = flag;
+            continue;
+        }
+        std::string value;
+        if (flag.size() > 8 && flag[8] == '=') {
+            value = flag.substr(9);
+        } else if (flag.size() == 8 && i + 1 < args.size()) {
+            value = args[++i];
+        } else {
+            error = "'--format' requires a value: ndjson or csv.";
+            return false;
+        }
+        if (!parseTransferFormat(value, format)) {
+            error = "Invalid format '" + value + "'. Use 'ndjson' or 'csv'.";
+            return false;
+        }
+        formatGiven = true;
+    }
+    if (!formatGiven) {
+        format = transferFormatForFile(path);
+    }
+    return true;
+}
+
+/**
+ * \@brief Checks whether a command names one task by a plain id (delete 5), the original form
+ * Such commands keep their original messages; anything else is a bulk selection
+ */
+static bool isSingleId(const std::vector<std::string>& args) {
+    return args.size() == 2 && args[1].find(',') == std::string::npos && args[1].find('-', 1) == std::string::npos;
+}
+
+/**
+ * \@brief Parses a task id (a plain non-negative number that fits in an int)
+ */
+static bool parseTaskId(const std::string& text, int& id) {
+    size_t value = 0;
+    if (!parseCount(text, value) || value > static_cast<size_t>(std::numeric_limits<int>::max())) {
+        return false;
+    }
+    id = static_cast<int>(value);
+    return true;
+}
+
+/**
+ * \@brief Parses the arguments of a bulk command: ids, ranges and lists of them, or --status
+ * Forms: 3,7,9   10-500   3 7 10-20 (several arguments)   --status done   --status=done
+ * \@param args The command and its arguments
+ * \@param selection Output parameter: the parsed selection
+ * \@param error Output parameter: what was wrong, if parsing fails
+ * \@return True on success
+ */
+static bool parseTaskSelection(const std::vector<std::string>& args, TaskSelection& selection, std::string& error) {
+    const std::string& first = args[1];
+    if (first.compare(0, 8, "--status") == 0) {
+        std::string value;
+        if (first.size() > 8 && first[8] == '=' && args.size() == 2) {
+            value = first.substr(9);
+        } else if (first.size() == 8 && args.size() == 3) {
+            value = args[2];
+        } else {
+            error = "'--status' takes exactly one value and cannot be combined with ids.";
+            return false;
+        }
+        if (value != "todo" && value != "in-progress" && value != "done") {
+            error = "Invalid status filter. Use 'todo', 'in-progress', or 'done'.";
+            return false;
+        }
+        selection.byStatus = true;
+        selection.status = stringToStatus(value);
+        return true;
+    }
+
+    for (size_t i = 1; i < args.size(); ++i) {
+        const std::string& arg = args[i];
+        size_t start = 0;
+        while (start <= arg.size()) {
+            size_t comma = arg.find(',', start);
+            std::string item = arg.substr(start, comma == std::string::npos ? std::string::npos : comma - start);
+            size_t dash = item.find('-');
+            int low = 0;
+            int high = 0;
+            if (dash == std::string::npos) {
+                if (!parseTaskId(item, low)) {
+                    error = "Invalid task ID '" + item + "'. Use <id>, <id>,<id>,..., <first>-<last> or --status <status>.";
+                    return false;
+                }
+                selection.ids.push_back(low);
+            } else {
+                if (!parseTaskId(item.substr(0, dash), low) || !parseTaskId(item.substr(dash + 1), high) || low > high) {
+                    error = "Invalid ID range '" + item + "'. Use <first>-<last> with first <= last.";
+                    return false;
+                }
+                selection.ranges.push_back(std::make_pair(low, high));
+            }
+            if (comma == std::string::npos) {
+                break;
+            }
+            start = comma + 1;
+        }
+    }
+    return true;
+}
+
+/**
+ * \@brief Folds a bulk command's outcome into the command result
+ * The command fails if a listed id was missing or nothing was selected at all
+ */
+static void applyBulkResult(const BulkResult& bulk, CommandResult& result) {
+    result.modified = bulk.affected > 0;
+    result.succeeded = bulk.missing == 0 && bulk.affected + bulk.unchanged > 0;
+}
+
+/**
+ * \@brief Runs one command (e.g. {"add", "Buy milk"}) against the in-memory tasks
+ * Does not load or persist anything; the caller commits if result.modified is set
+ * \@param tasks The list of tasks (may be modified)
+ * \@param args The command and its arguments, without the program name
+ * \@param progName The program name, for usage messages
+ * \@return The outcome of the command
+ */
+CommandResult executeCommand(TaskList& tasks, const std::vector<std::string>& args, const char* progName) {
+    CommandResult result;
+    // Marks the result as failed with the given exit code
+    auto failed = [&result](int exitCode) {
+        result.exitCode = exitCode;
+        result.succeeded = false;
+        return result;
+    };
+
+    // Need at least a command
+    if (args.empty()) {
+        printUsage(progName);
+        return failed(1);
+    }
+
+    // --- Command Extraction ---
+    const std::string& command = args[0];
+
+    try {
+        // --- Command Handling --- 
+        if (command == "add") {
+            if (args.size() != 2) {
+                std::cerr << "Error: 'add' command requires exactly one argument: \"<description>\"" << std::endl;
+                printUsage(progName);
+                return failed(1);
+            }
+            std::string description = args[1];
+
+            // Check if the description contains at least one non-whitespace character
+            // std::string::npos is returned if no character matches the condition
+            if (description.find_first_not_of(" \t\n\r\f\v") == std::string::npos) {
+                std::cerr << "Error: Task description cannot be empty or whitespace only." << std::endl;
+                return failed(1);
+            }
+            addTask(tasks, description);
+            result.modified = true;
+        } else if (command == "update") {
+            if (args.size() != 3) {
+                std::cerr << "Error: 'update' command requires two arguments: <id> \"<new_description>\"" << std::endl;
+                printUsage(progName);
+                return failed(1);
+            }
+            // Convert ID argument from string to integer
+            int id = std::stoi(args[1]);
+            std::string newDescription = args[2];
+            // Check if the description contains at least one non-whitespace character
+            // std::string::npos is returned if no character matches the condition
+            if (newDescription.find_first_not_of(" \t\n\r\f\v") == std::string::npos) {
+                std::cerr << "Error: New task description cannot be empty or whitespace only." << std::endl;
+                return failed(1);
+            }
+            if (updateTask(tasks, id, newDescription)) {
+                result.modified = true;
+            } else {
+                result.succeeded = false;
+            }
+        } else if (command == "delete") {
+            if (args.size() < 2) {
+                std::cerr << "Error: 'delete' command requires an argument: <id>, a list, a range or --status <status>" << std::endl; 
+                printUsage(progName);
+                return failed(1);
+            }
+            if (isSingleId(args)) {
+                int id = std::stoi(args[1]);
+                if (deleteTask(tasks, id)) {
+                    result.modified = true;
+                } else {
+                    result.succeeded = false;
+                }
+            } else {
+                TaskSelection selection;
+                std::string error;
+                if (!parseTaskSelection(args, selection, error)) {
+                    std::cerr << "Error: " << error << std::endl;
+                    printUsage(progName);
+                    return failed(1);
+                }
+                applyBulkResult(deleteTasks(tasks, selection), result);
+            }
+        } else if (command == "mark-in-progress" || command == "mark-done") {
+            if (args.size() < 2) {
+                std::cerr << "Error: '" << command << "' command requires an argument: <id>, a list, a range or --status <status>" << std::endl; 
+                printUsage(progName);
+                return failed(1); 
+            }
+            TaskStatus status = command == "mark-done" ? TaskStatus::DONE : TaskStatus::IN_PROGRESS;
+            if (isSingleId(args)) {
+                int id = std::stoi(args[1]);
+                if (markTaskStatus(tasks, id, status)) {
+                    result.modified = true;
+                } else {
+                    result.succeeded = false;
+                }
+            } else {
+                TaskSelection selection;
+                std::string error;
+                if (!parseTaskSelection(args, selection, error)) {
+                    std::cerr << "Error: " << error << std::endl;
+                    printUsage(progName);
+                    return failed(1);
+                }
+                applyBulkResult(markTasksStatus(tasks, selection, status), result);
+            }
+        } else if (command == "list") {
+            ListOptions options;
+            std::string error;
+            if (!parseListOptions(args, options, error)) {
+                std::cerr << "Error: " << error << std::endl;
+                printUsage(progName);
+                return failed(1);
+            }
+            listTasks(tasks, options);
+        } else if (command == "search") {
+            if (args.size() < 2) {
+                std::cerr << "Error: 'search' command requires at least one argument: <terms...>" << std::endl;
+                printUsage(progName);
+                return failed(1);
+            }
+            // All remaining arguments form the query, so quoting is optional
+            std::string query = args[1];
+            for (size_t i = 2; i < args.size(); ++i) {
+                query += ' ';
+                query += args[i];
+            }
+            std::vector<std::string> terms;
+            SearchIndex::tokenize(query, terms);
+            if (terms.empty()) {
+                std::cerr << "Error: Search terms must contain at least one letter or digit." << std::endl;
+                return failed(1);
+            }
+            searchTasks(tasks, query);
+        } else if (command == "import") {
+            std::string path;
+            TransferFormat format = TransferFormat::NDJSON;
+            std::string error;
+            if (!parseTransferOptions(args, path, format, error)) {
+                std::cerr << "Error: " << error << std::endl;
+                printUsage(progName);
+                return failed(1);
+            }
+            if (path.empty()) {
+                std::cerr << "Error: 'import' command requires a file: <file>" << std::endl;
+                printUsage(progName);
+                return failed(1);
+            }
+            ImportResult imported;
+            bool readAll = importTasks(tasks, path, format, imported);
+            result.modified = imported.imported > 0; // Commit what was added, even after an error
+            std::cout << "Imported " << imported.imported << " task(s) from '" << path << "'";
+            if (imported.skipped > 0) {
+                std::cout << " (" << imported.skipped << " record(s) skipped)";
+            }
+            std::cout << "." << std::endl;
+            if (!readAll || imported.skipped > 0) {
+                return failed(1); // Still commits the tasks that were imported
+            }
+        } else if (command == "export") {
+            std::string path;
+            TransferFormat format = TransferFormat::NDJSON;
+            std::string error;
+            if (!parseTransferOptions(args, path, format, error)) {
+                std::cerr << "Error: " << error << std::endl;
+                printUsage(progName);
+                return failed(1);
+            }
+            if (path.empty() || path == "-") {
+                exportTasks(tasks, format, std::cout); // Nothing else goes to stdout, so it can be piped
+                if (!std::cout) {
+                    std::cerr << "Error: Failed to write the export to stdout." << std::endl;
+                    return failed(1);
+                }
+            } else {
+                std::ofstream output(path, std::ios::binary);
+                if (!output.is_open()) {
+                    std::cerr << "Error: Could not open '" << path << "' for writing." << std::endl;
+                    return failed(1);
+                }
+                size_t exported = exportTasks(tasks, format, output);
+                output.close();
+                if (!output) {
+                    std::cerr << "Error: Failed to write '" << path << "'." << std::endl;
+                    return failed(1);
+                }
+                std::cout << "Exported " << exported << " task(s) to '" << path << "'." << std::endl;
+            }
+        } else if (command == "compact") {
+            if (args.size() != 1) {
+                std::cerr << "Error: 'compact' command takes no arguments." << std::endl;
+                printUsage(progName);
+                return failed(1);
+            }
+            compactTasks(tasks);
+            // Rewrite the store without its tombstones too: the commit writes a fresh snapshot
+            // that replaces the log's delete records (JSON), or drops deleted slots (binary).
+            // Left to the caller, so batch and the daemon still commit once; the changes
+            // recorded before compact are logged ahead of that snapshot, so recovery from
+            // the previous checkpoint still replays them
+            recordFullRewrite();
+            result.modified = true;
+        } else {
+            std::cerr << "Error: Unknown command '" << command << "'" << std::endl;
+            printUsage(progName);
+            return failed(1);
+        }
+    } catch (const std::invalid_argument& e) {
+        std::cerr << "Error: Invalid task ID provided. ID must be a number." << std::endl;
+        return failed(1);
+    } catch (const std::out_of_range&e) {
+        std::cerr << "Error: Task ID provided is too large." << std::endl;
+        return failed(1); 
+    } catch (const std::exception& e) {
+        std::cerr << "Error: An unexpected error occurred: " << e.what() << std::endl;
+        return failed(1);
+    }
+
+
+    return result;
+}
+
+/**
+ * \@brief Splits a command line into arguments the way a POSIX shell would for simple input
+ * \@param line The line to split
+ * \@param args Output parameter: the arguments
+ * \@param error Output parameter: a description of the problem if splitting fails
+ * \@return True on success, false on unbalanced quotes
+ */
+bool splitCommandLine(const std::string& line, std::vector<std::string>& args, std::string& error) {
+    args.clear();
+    std::string current;
+    bool inArgument = false; // Distinguishes "" (an empty argument) from no argument
+    char quote = '\0'; // The quote character we are inside of, if any
+
+    for (size_t i = 0; i < line.size(); ++i) {
+        char c = line[i];
+        if (quote == '\'') {
+            if (c == '\'') {
+                quote = '\0';
+            } else {
+                current += c;
+            }
+        } else if (quote == '"') {
+            if (c == '"') {
+                quote = '\0';
+            } else if (c == '\\' && i + 1 < line.size() && (line[i + 1] == '"' || line[i + 1] == '\\')) {
+                current += line[++i];
+            } else {
+                current += c;
+            }
+        } else if (c == '\'' || c == '"') {
+            quote = c;
+            inArgument = true;
+        } else if (c == '\\' && i + 1 < line.size()) {
+            current += line[++i];
+            inArgument = true;
+        } else if (c == ' ' || c == '\t' || c == '\r') {
+            if (inArgument) {
+                args.push_back(current);
+                current.clear();
+                inArgument = false;
+            }
+        } else {
+            current += c;
+            inArgument = true;
+        }
+    }
+
+    if (quote != '\0') {
+        error = std::string("unterminated ") + (quote == '"' ? "double" : "single") + " quote";
+        return false;
+    }
+    if (inArgument) {
+        args.push_back(current);
+    }
+    return true;
+}
+
+/**
+ * \@brief Runs newline-delimited commands against one in-memory task list
+ * Tasks are loaded once by the caller and committed once here, so N commands
+ * cost one load and one write instead of N of each
+ * \@param tasks The list of tasks (may be modified)
+ * \@param input Where to read the commands from
+ * \@param progName The program name, for usage messages
+ * \@param saveFailed Output parameter, if not null: set if the commit failed
+ * \@return 0 if every command succeeded and the changes were saved, 1 otherwise
+ */
+int runBatch(TaskList& tasks, std::istream& input, const char* progName, bool* saveFailed) {
+    std::string line;
+    std::vector<std::string> args;
+    std::string error;
+    size_t lineNumber = 0;
+    size_t succeeded = 0;
+    size_t failures = 0;
+    bool modified = false;
+
+    auto commandStart = std::chrono::steady_clock::now();
+    while (std::getline(input, line)) {
+        ++lineNumber;
+        size_t first = line.find_first_not_of(" \t\r");
+        if (first == std::string::npos || line[first] == '#') {
+            continue; // Blank line or comment
+        }
+
+        CommandResult result;
+        if (!splitCommandLine(line, args, error)) {
+            std::cerr << "Error: " << error << std::endl;
+            result.succeeded = false;
+        } else if (!args.empty() && args[0] == "batch") {
+            std::cerr << "Error: 'batch' cannot be nested." << std::endl;
+            result.succeeded = false;
+        } else {
+            result = executeCommand(tasks, args, progName);
+        }
+
+        modified = modified || result.modified;
+        if (result.succeeded) {
+            ++succeeded;
+            std::cout << "Line " << lineNumber << ": ok" << std::endl;
+        } else {
+            ++failures;
+            std::cout << "Line " << lineNumber << ": failed" << std::endl;
+        }
+    }
+    addPhaseTime(StatsPhase::COMMAND, std::chrono::steady_clock::now() - commandStart);
+
+    // --- Persist everything once ---
+    bool saved = !modified || commitTasks(tasks);
+    if (saveFailed != nullptr) {
+        *saveFailed = !saved;
+    }
+    std::cout << "Batch complete: " << succeeded << " succeeded, " << failures << " failed." << std::endl;
+    if (!saved) {
+        std::cerr << "Error: The changes could not be saved." << std::endl;
+        return 1;
+    }
+    return failures == 0 ? 0 : 1;
+}
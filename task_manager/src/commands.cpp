@@ -1,134 +1,470 @@
-#include "commands.h"
-#include "utils.h" // For generateNextId and getCurrentTimestamp
-#include "task.h" // For Task struct and statusToString 
-#include <iostream>
-#include <vector>
-#include <string>
-#include <algorithm> // For std::find_if, std::remove_if
-#include <chrono> // For time points
-
-/**
- * \@brief Adds a new task to the task list 
- * \@param tasks The vector of tasks (will be modified)
- * \@param definition The description for the new task
- */
-void addTask(std::vector<Task>& tasks, const std::string& description) {
-    int newId = generateNextId(tasks); // Get the next available ID
-    auto now = getCurrentTimestamp(); // Get the current time 
-    tasks.emplace_back(newId, description, TaskStatus::TODO, now, now); // Add the new task
-    std::cout << "Task " << newId << " added: \"" << description << "\"" << std::endl;
-}
-
-/**
- * \@brief Finds a task by ID using std::find_if 
- * \@param tasks The vector of tasks to search within 
- * \@param id The ID of the task to find 
- * \@return An iterator to the found task, or tasks.end() if not found 
- */
-std::vector<Task>::iterator findTaskById(std::vector<Task>& tasks, int id) {
-    return std::find_if(tasks.begin(), tasks.end(),
-                        [id](const Task& task) { return task.id == id; });
-}
-
-/**
- * \@brief Updates the description of an existing task
- * \@param tasks The vector of tasks (will be modified)
- * \@param id The ID of the task to update 
- * \@param newDescription The new description for the task
- * \@return True if the task was found and updated, false otherwise
- */
-bool updateTask(std::vector<Task>& tasks, int id, const std::string& newDescription) {
-    auto it = findTaskById(tasks, id); 
-    if (it != tasks.end()) {
-        it->description = newDescription;
-        it->updatedAt = getCurrentTimestamp(); // Update the timestamp 
-        std::cout << "Task " << id << " updated." << std::endl;
-        return true;
-    } else {
-        std::cerr << "Error: Task with ID " << id << " not found." << std::endl;
-        return false;
-    }
-}
-
-/**
- * \@brief Deletes a task from the list by its ID
- * \@param tasks The vector of tasks (will be modified)
- * \@param id The ID of the task to delete 
- * \@return True if the task was found and deleted, false otherwise 
- */
-bool deleteTask(std::vector<Task>& tasks, int id) {
-    //remove_if moves the elements to be removed to the end and returns an iterator to the start of the removed range
-    auto new_end = std::remove_if(tasks.begin(), tasks.end(),
-                                  [id](const Task& task) { return task.id == id; });
-
-    if (new_end != tasks.end()) {
-        tasks.erase(new_end, tasks.end()); // Actually erase the elements
-        std::cout << "Task " << id << " deleted." << std::endl;
-        return true;
-    } else {
-        std::cerr << "Error: Task with ID " << id << " not found." << std::endl;
-        return false;
-    }
-}
-
-/**
- * \@brief Marks the status of an existing task
- * \@param tasks The vector of tasks (will be modified)
- * \@param id The ID of the task to mark
- * \@param status The new status for the task
- * \@return True if the task was found and its status updated, false otherwise 
- */
-bool markTaskStatus(std::vector<Task>& tasks, int id, TaskStatus status) { 
-    auto it = findTaskById(tasks, id); 
-    if (it != tasks.end()) {
-        it->status = status;
-        it->updatedAt = getCurrentTimestamp(); // Update the timestamp 
-        std::cout << "Task " << id << " marked as " << statusToString(status) << "." << std::endl;
-        return true;
-    } else {
-        std::cerr << "Error: Task with ID " << id << " not found." << std::endl;
-        return false;
-    }
-}
-
-/**
- * \@brief Lists tasks, optionally filtering by status
- * \@param tasks The vector of tasks to list 
- * \@param filterStatus The status to filter by ("todo", "in progress", "done", or empty string for all)
- */
-void listTasks(const std::vector<Task>& tasks, const std::string& filterStatus = "") {
-    std::cout << "\n--- Task List ---" << std::endl;
-    bool tasksDisplayed = false; 
-    TaskStatus filterEnum = TaskStatus::TODO; // Default, only used if filterStatus is not empty 
-    bool applyFilter = !filterStatus.empty(); 
-
-    if (applyFilter) {
-        filterEnum = stringToStatus(filterStatus); // Convert filter string to enum 
-    }
-
-    for (const auto& task : tasks) {
-        // Apply filter if specified 
-        if (applyFilter && task.status != filterEnum) {
-            continue; // Skip this task if it doesn't match the filter
-        }
-
-        // Print task details 
-        std::cout << "ID: " << task.id 
-                  << " | Status: " << statusToString(task.status) 
-                  << " | Created: " << formatTimestamp(task.createdAt) 
-                  << " | Updated: " << formatTimestamp(task.updatedAt) << std::endl;
-        std::cout << "Description: " << task.description << std::endl; 
-        std::cout << "------------------------" << std::endl;
-        tasksDisplayed = true; 
-    }
-
-    if (!tasksDisplayed) {
-        if (applyFilter) {
-            std::cout << "No tasks found with status: " << filterStatus << std::endl;
-        } else {
-            std::cout << "No tasks in the list." << std::endl;
-        }
-    }
-    std::cout << "Total tasks: " << tasks.size() << std::endl;
-    std::cout << "------------------------" << std::endl;
-}
\ No newline at end of file
+#include "commands.h"
+#include "utils.h" // For generateNextId and getCurrentTimestamp
+#include "task.h" // For Task struct and statusToString 
+#include "storage.h" // For recordTaskChange, recordTaskDeletion
+#include "task_list.h" // For TaskList and its id index
+#include "task_table.h" // For TaskTable, the struct-of-arrays representation
+#include <iostream>
+#include <vector>
+#include <string>
+#include <chrono> // For time points
+#include <algorithm> // For std::partial_sort, std::sort, std::min, std::lower_bound, std::unique, std::remove_if
+#include <cstdio> // For std::snprintf
+#include <utility> // For std::move
+
+// The commands are templates over the task container: they only use the row
+// interface TaskList and TaskTable share, and are instantiated for both at the
+// end of this file
+
+/**
+ * \@brief Adds a new task to the task list 
+ * \@param tasks The list of tasks (will be modified)
+ * \@param definition The description for the new task
+ */
+template <typename Tasks>
+void addTask(Tasks& tasks, const std::string& description) {
+    int newId = generateNextId(tasks); // Get the next available ID
+    auto now = getCurrentTimestamp(); // Get the current time 
+    Task task(newId, description, TaskStatus::TODO, now, now);
+    recordTaskChange(task);
+    tasks.add(std::move(task)); // Add the new task
+    std::cout << "Task " << newId << " added: \"" << description << "\"" << std::endl;
+}
+
+/**
+ * \@brief Finds a task by ID using the list's id index (O(1))
+ * \@param tasks The list of tasks to search within 
+ * \@param id The ID of the task to find 
+ * \@return A pointer to the found task, or nullptr if not found 
+ */
+Task* findTaskById(TaskList& tasks, int id) {
+    return tasks.find(id);
+}
+
+/**
+ * \@brief Updates the description of an existing task
+ * \@param tasks The list of tasks (will be modified)
+ * \@param id The ID of the task to update 
+ * \@param newDescription The new description for the task
+ * \@return True if the task was found and updated, false otherwise
+ */
+template <typename Tasks>
+bool updateTask(Tasks& tasks, int id, const std::string& newDescription) {
+    size_t row = 0;
+    // Also re-indexes the words and updates the timestamp
+    if (tasks.updateDescription(id, newDescription, getCurrentTimestamp()) && tasks.findRow(id, row)) {
+        recordTaskChange(tasks.taskAt(row));
+        std::cout << "Task " << id << " updated." << std::endl;
+        return true;
+    } else {
+        std::cerr << "Error: Task with ID " << id << " not found." << std::endl;
+        return false;
+    }
+}
+
+/**
+ * \@brief Deletes a task from the list by its ID
+ * \@param tasks The list of tasks (will be modified)
+ * \@param id The ID of the task to delete 
+ * \@return True if the task was found and deleted, false otherwise 
+ */
+template <typename Tasks>
+bool deleteTask(Tasks& tasks, int id) {
+    // The id index locates the task directly, and its row becomes a tombstone,
+    // so no later task moves
+    if (tasks.remove(id)) {
+        recordTaskDeletion(id);
+        std::cout << "Task " << id << " deleted." << std::endl;
+        return true;
+    } else {
+        std::cerr << "Error: Task with ID " << id << " not found." << std::endl;
+        return false;
+    }
+}
+
+/**
+ * \@brief Marks the status of an existing task
+ * \@param tasks The list of tasks (will be modified)
+ * \@param id The ID of the task to mark
+ * \@param status The new status for the task
+ * \@return True if the task was found and its status updated, false otherwise 
+ */
+template <typename Tasks>
+bool markTaskStatus(Tasks& tasks, int id, TaskStatus status) { 
+    size_t row = 0;
+    // Also keeps the per-status index in sync and updates the timestamp
+    if (tasks.updateStatus(id, status, getCurrentTimestamp()) && tasks.findRow(id, row)) {
+        recordTaskChange(tasks.taskAt(row));
+        std::cout << "Task " << id << " marked as " << statusToString(status) << "." << std::endl;
+        return true;
+    } else {
+        std::cerr << "Error: Task with ID " << id << " not found." << std::endl;
+        return false;
+    }
+}
+
+/**
+ * \@brief Resolves a selection to rows, in ascending order and without duplicates
+ * Listed ids and short ranges are looked up through the id index; a range wider
+ * than the list is matched against every row instead, so "1-1000000000" costs
+ * one pass over the tasks rather than a lookup per id
+ * \@param tasks The list of tasks
+ * \@param selection The tasks to find
+ * \@param missing Output parameter: the listed ids that have no task
+ * \@return The rows of the selected tasks
+ */
+template <typename Tasks>
+static std::vector<size_t> selectRows(const Tasks& tasks, const TaskSelection& selection, std::vector<int>& missing) {
+    if (selection.byStatus) {
+        return tasks.rowsWithStatus(selection.status); // Already in row order
+    }
+
+    std::vector<size_t> rows;
+    size_t row = 0;
+    for (int id : selection.ids) {
+        if (tasks.findRow(id, row)) {
+            rows.push_back(row);
+        } else {
+            missing.push_back(id);
+        }
+    }
+
+    // Ranges: merge overlaps, then either walk each range or scan the rows once
+    std::vector<std::pair<int, int>> ranges(selection.ranges);
+    std::sort(ranges.begin(), ranges.end());
+    std::vector<std::pair<int, int>> merged;
+    unsigned long long span = 0;
+    for (const auto& range : ranges) {
+        if (!merged.empty() && static_cast<long long>(range.first) <= static_cast<long long>(merged.back().second) + 1) {
+            merged.back().second = std::max(merged.back().second, range.second);
+        } else {
+            merged.push_back(range);
+        }
+    }
+    for (const auto& range : merged) {
+        span += static_cast<unsigned long long>(static_cast<long long>(range.second) - range.first + 1);
+    }
+    if (span <= tasks.size()) {
+        for (const auto& range : merged) {
+            for (long long id = range.first; id <= range.second; ++id) {
+                if (tasks.findRow(static_cast<int>(id), row)) {
+                    rows.push_back(row);
+                }
+            }
+        }
+    } else {
+        for (row = 0; row < tasks.slotCount(); ++row) {
+            if (!tasks.isLive(row)) {
+                continue;
+            }
+            int id = tasks.idAt(row);
+            // The first range ending at or after id is the only one that can hold it
+            auto it = std::lower_bound(merged.begin(), merged.end(), id,
+                                       [](const std::pair<int, int>& range, int value) { return range.second < value; });
+            if (it != merged.end() && it->first <= id) {
+                rows.push_back(row);
+            }
+        }
+    }
+
+    std::sort(rows.begin(), rows.end());
+    rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+    return rows;
+}
+
+/**
+ * \@brief Deletes every selected task in one pass over the list
+ * \@param tasks The list of tasks (will be modified)
+ * \@param selection Which tasks to delete
+ * \@return How many tasks were deleted, and how many listed ids had no task
+ */
+template <typename Tasks>
+BulkResult deleteTasks(Tasks& tasks, const TaskSelection& selection) {
+    BulkResult result;
+    std::vector<int> missing;
+    std::vector<size_t> rows = selectRows(tasks, selection, missing);
+    for (int id : missing) {
+        std::cerr << "Error: Task with ID " << id << " not found." << std::endl;
+    }
+    for (size_t row : rows) {
+        recordTaskDeletion(tasks.idAt(row));
+    }
+    tasks.removeRows(rows); // Survivors move down once, instead of once per deleted task
+    result.affected = rows.size();
+    result.missing = missing.size();
+    std::cout << "Deleted " << result.affected << " task(s)." << std::endl;
+    return result;
+}
+
+/**
+ * \@brief Sets the status of every selected task
+ * \@param tasks The list of tasks (will be modified)
+ * \@param selection Which tasks to mark
+ * \@param status The new status
+ * \@return How many tasks changed, were already marked, or were missing
+ */
+template <typename Tasks>
+BulkResult markTasksStatus(Tasks& tasks, const TaskSelection& selection, TaskStatus status) {
+    BulkResult result;
+    std::vector<int> missing;
+    std::vector<size_t> rows = selectRows(tasks, selection, missing);
+    for (int id : missing) {
+        std::cerr << "Error: Task with ID " << id << " not found." << std::endl;
+    }
+    auto now = getCurrentTimestamp(); // One timestamp for the whole change
+    for (size_t row : rows) {
+        if (tasks.statusAt(row) == status) {
+            ++result.unchanged;
+            continue;
+        }
+        // Status changes do not move rows, so the remaining row numbers stay valid
+        tasks.updateStatus(tasks.idAt(row), status, now);
+        recordTaskChange(tasks.taskAt(row));
+        ++result.affected;
+    }
+    result.missing = missing.size();
+    std::cout << "Marked " << result.affected << " task(s) as " << statusToString(status);
+    if (result.unchanged > 0) {
+        std::cout << " (" << result.unchanged << " already were)";
+    }
+    std::cout << "." << std::endl;
+    return result;
+}
+
+/**
+ * \@brief Drops the tombstones deleted tasks left behind in memory
+ * \@param tasks The list of tasks (will be modified; rows are renumbered)
+ * \@return The number of tombstones removed
+ */
+template <typename Tasks>
+size_t compactTasks(Tasks& tasks) {
+    size_t removed = tasks.compact();
+    std::cout << "Compacted the task list: " << tasks.size() << " task(s), " << removed << " tombstone(s) dropped." << std::endl;
+    return removed;
+}
+
+// Rows are flushed to std::cout whenever the buffer grows past this size
+const size_t OUTPUT_FLUSH_BYTES = 1 << 20;
+
+/**
+ * \@brief Appends the decimal form of an integer to a buffer
+ * \@param buffer The buffer to append to
+ * \@param value The value to append
+ */
+static void appendNumber(std::string& buffer, long long value) {
+    char digits[24];
+    int length = std::snprintf(digits, sizeof(digits), "%lld", value);
+    buffer.append(digits, static_cast<size_t>(length));
+}
+
+/**
+ * \@brief Appends one task the way list and search show it
+ * \@param buffer The output buffer to append to
+ * \@param tasks The container holding the task
+ * \@param row The task's row
+ */
+template <typename Tasks>
+static void appendTask(std::string& buffer, const Tasks& tasks, size_t row) {
+    char stamp[TIMESTAMP_BUFFER_SIZE];
+    buffer += "ID: ";
+    appendNumber(buffer, tasks.idAt(row));
+    buffer += " | Status: ";
+    buffer += statusToString(tasks.statusAt(row));
+    buffer += " | Created: ";
+    buffer.append(stamp, formatTimestamp(tasks.createdAtRow(row), stamp));
+    buffer += " | Updated: ";
+    buffer.append(stamp, formatTimestamp(tasks.updatedAtRow(row), stamp));
+    buffer += "\nDescription: ";
+    TextRef description = tasks.descriptionAt(row);
+    buffer.append(description.data, description.size);
+    buffer += "\n------------------------\n";
+}
+
+/**
+ * \@brief Writes the buffer to std::cout and empties it
+ * One large write instead of several stream insertions and a flush per row
+ */
+static void flushOutput(std::string& buffer) {
+    std::cout.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    buffer.clear();
+}
+
+/**
+ * \@brief Formats tasks into a buffer, writing it out in large chunks
+ * \@param buffer The output buffer (may already hold a header)
+ * \@param tasks The container holding the tasks
+ * \@param rows The rows to format, in display order
+ */
+template <typename Tasks>
+static void appendTasks(std::string& buffer, const Tasks& tasks, const std::vector<size_t>& rows) {
+    for (size_t row : rows) {
+        appendTask(buffer, tasks, row);
+        if (buffer.size() >= OUTPUT_FLUSH_BYTES) {
+            flushOutput(buffer);
+        }
+    }
+}
+
+/**
+ * \@brief Orders two rows by a sort key, breaking ties by id so pages are stable
+ */
+template <typename Tasks>
+static bool rowLess(const Tasks& tasks, size_t a, size_t b, ListSortKey key) {
+    switch (key) {
+        case ListSortKey::CREATED:
+            if (tasks.createdAtRow(a) != tasks.createdAtRow(b)) {
+                return tasks.createdAtRow(a) < tasks.createdAtRow(b);
+            }
+            break;
+        case ListSortKey::UPDATED:
+            if (tasks.updatedAtRow(a) != tasks.updatedAtRow(b)) {
+                return tasks.updatedAtRow(a) < tasks.updatedAtRow(b);
+            }
+            break;
+        default:
+            break;
+    }
+    return tasks.idAt(a) < tasks.idAt(b);
+}
+
+/**
+ * \@brief Lists tasks, optionally filtering by status
+ * \@param tasks The list of tasks to list 
+ * \@param filterStatus The status to filter by ("todo", "in progress", "done", or empty string for all)
+ */
+template <typename Tasks>
+void listTasks(Tasks& tasks, const std::string& filterStatus) {
+    ListOptions options;
+    options.filterStatus = filterStatus;
+    listTasks(tasks, options);
+}
+
+/**
+ * \@brief Lists one page of tasks, optionally filtered and sorted
+ * Only the first offset + limit tasks in sort order are ordered (partial sort),
+ * and rows are formatted into one buffer that is written in large chunks
+ * \@param tasks The list of tasks to list (a desc~ query may build its search index)
+ * \@param options Status filter, --where query, sort key and page
+ */
+template <typename Tasks>
+void listTasks(Tasks& tasks, const ListOptions& options) {
+    std::string buffer;
+    buffer.reserve(OUTPUT_FLUSH_BYTES + 4096);
+    buffer += "\n--- Task List ---\n";
+
+    // --- Select: the per-status index (or the query's best index) yields only the matching rows ---
+    bool applyFilter = !options.filterStatus.empty();
+    std::vector<size_t> matches;
+    if (!options.where.empty()) {
+        matches = options.where.select(tasks);
+        if (applyFilter) {
+            TaskStatus status = stringToStatus(options.filterStatus);
+            matches.erase(std::remove_if(matches.begin(), matches.end(),
+                                         [&tasks, status](size_t row) { return tasks.statusAt(row) != status; }),
+                          matches.end());
+        }
+    } else if (applyFilter) {
+        matches = tasks.rowsWithStatus(stringToStatus(options.filterStatus)); // Convert filter string to enum
+    } else {
+        matches = tasks.liveRows(); // Skips the tombstones of deleted tasks
+    }
+
+    // --- Page: order only as much as the page needs ---
+    size_t total = matches.size();
+    size_t first = std::min(options.offset, total);
+    size_t last = options.limit > 0 ? std::min(total, first + std::min(options.limit, total - first)) : total;
+    if (options.sortKey != ListSortKey::NONE) {
+        ListSortKey key = options.sortKey;
+        auto less = [&tasks, key](size_t a, size_t b) { return rowLess(tasks, a, b, key); };
+        if (last < total) {
+            std::partial_sort(matches.begin(), matches.begin() + static_cast<std::ptrdiff_t>(last), matches.end(), less);
+        } else {
+            std::sort(matches.begin(), matches.end(), less);
+        }
+    }
+    matches.erase(matches.begin() + static_cast<std::ptrdiff_t>(last), matches.end());
+    matches.erase(matches.begin(), matches.begin() + static_cast<std::ptrdiff_t>(first));
+
+    // --- Print ---
+    appendTasks(buffer, tasks, matches);
+    if (matches.empty()) {
+        if (total > 0) {
+            buffer += "No tasks at offset ";
+            appendNumber(buffer, static_cast<long long>(options.offset));
+            buffer += ".\n";
+        } else if (!options.where.empty()) {
+            buffer += "No tasks match the --where expression.\n";
+        } else if (applyFilter) {
+            buffer += "No tasks found with status: " + options.filterStatus + "\n";
+        } else {
+            buffer += "No tasks in the list.\n";
+        }
+    }
+    if (!matches.empty() && (first > 0 || last < total)) {
+        buffer += "Showing ";
+        appendNumber(buffer, static_cast<long long>(first + 1));
+        buffer += "-";
+        appendNumber(buffer, static_cast<long long>(last));
+        buffer += " of ";
+        appendNumber(buffer, static_cast<long long>(total));
+        buffer += " matching task(s).\n";
+    }
+    buffer += "Total tasks: ";
+    appendNumber(buffer, static_cast<long long>(tasks.size()));
+    buffer += " (todo: ";
+    appendNumber(buffer, static_cast<long long>(tasks.countWithStatus(TaskStatus::TODO)));
+    buffer += ", in-progress: ";
+    appendNumber(buffer, static_cast<long long>(tasks.countWithStatus(TaskStatus::IN_PROGRESS)));
+    buffer += ", done: ";
+    appendNumber(buffer, static_cast<long long>(tasks.countWithStatus(TaskStatus::DONE)));
+    buffer += ")\n------------------------\n";
+    flushOutput(buffer);
+    std::cout.flush();
+}
+
+/**
+ * \@brief Lists the tasks whose descriptions contain every word of the query
+ * \@param tasks The list of tasks to search (its search index may be built on first use)
+ * \@param query The words to look for; matched whole and case-insensitively
+ * \@return The number of matching tasks
+ */
+template <typename Tasks>
+size_t searchTasks(Tasks& tasks, const std::string& query) {
+    std::vector<int> ids = tasks.search(query);
+    std::vector<size_t> rows(ids.size());
+    for (size_t i = 0; i < ids.size(); ++i) {
+        tasks.findRow(ids[i], rows[i]);
+    }
+
+    std::string buffer = "\n--- Search Results ---\n";
+    appendTasks(buffer, tasks, rows);
+    buffer += "Found ";
+    appendNumber(buffer, static_cast<long long>(ids.size()));
+    buffer += " task(s) matching \"" + query + "\".\n------------------------\n";
+    flushOutput(buffer);
+    std::cout.flush();
+    return ids.size();
+}
+
+// --- Instantiations for both task representations ---
+template void addTask<TaskList>(TaskList&, const std::string&);
+template bool updateTask<TaskList>(TaskList&, int, const std::string&);
+template bool deleteTask<TaskList>(TaskList&, int);
+template bool markTaskStatus<TaskList>(TaskList&, int, TaskStatus);
+template BulkResult deleteTasks<TaskList>(TaskList&, const TaskSelection&);
+template BulkResult markTasksStatus<TaskList>(TaskList&, const TaskSelection&, TaskStatus);
+template void listTasks<TaskList>(TaskList&, const std::string&);
+template void listTasks<TaskList>(TaskList&, const ListOptions&);
+template size_t searchTasks<TaskList>(TaskList&, const std::string&);
+template size_t compactTasks<TaskList>(TaskList&);
+
+template void addTask<TaskTable>(TaskTable&, const std::string&);
+template bool updateTask<TaskTable>(TaskTable&, int, const std::string&);
+template bool deleteTask<TaskTable>(TaskTable&, int);
+template bool markTaskStatus<TaskTable>(TaskTable&, int, TaskStatus);
+template BulkResult deleteTasks<TaskTable>(TaskTable&, const TaskSelection&);
+template BulkResult markTasksStatus<TaskTable>(TaskTable&, const TaskSelection&, TaskStatus);
+template void listTasks<TaskTable>(TaskTable&, const std::string&);
+template void listTasks<TaskTable>(TaskTable&, const ListOptions&);
+template size_t searchTasks<TaskTable>(TaskTable&, const std::string&);
+template size_t compactTasks<TaskTable>(TaskTable&);
@@ -0,0 +1,524 @@
+#include "daemon.h"
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <cerrno>
+#include <cstring> // For std::memcpy, std::strerror, std::strncpy
+#include <csignal> // For sigaction
+#include <fcntl.h> // For fcntl
+#include <poll.h> // For poll
+#include <sys/socket.h> // For socket, bind, listen, accept, connect
+#include <sys/stat.h> // For stat
+#include <sys/un.h> // For sockaddr_un
+#include <unistd.h> // For read, write, close, unlink
+#include "cli.h" // For executeCommand, runBatch
+#include "storage.h" // For commitTasks, discardTaskChanges, loadTasks
+
+// Name of the daemon's socket in the working directory (next to the task store)
+const char* const DAEMON_SOCKET_FILE = "tasks.sock";
+// Upper bounds on a request, so a garbled stream cannot make the daemon allocate without limit
+const uint32_t MAX_REQUEST_ARGS = 1024;
+const uint32_t MAX_REQUEST_FIELD_BYTES = 64u * 1024 * 1024;
+
+// Set from the signal handler; checked after every poll round
+static volatile sig_atomic_t stopRequested = 0;
+
+static void handleStopSignal(int) {
+    stopRequested = 1;
+}
+
+// A reply held back until the group commit has persisted the request's changes
+struct HeldReply {
+    int exitCode;
+    std::string out;
+    std::string err;
+    bool modified; // The request changed tasks, so the reply depends on the commit
+};
+
+// One connected client and its unframed input / unsent output
+struct ClientConnection {
+    int fd;
+    std::string inbound; // Bytes received but not yet parsed into a request
+    std::vector<HeldReply> held; // Replies waiting for the group commit
+    std::string outbound; // Replies ready to be written
+    bool closed; // The client hung up or sent garbage
+
+    explicit ClientConnection(int fd) : fd(fd), closed(false) {}
+};
+
+static void appendU32(std::string& buffer, uint32_t value) {
+    buffer.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+static void appendField(std::string& buffer, const std::string& field) {
+    appendU32(buffer, static_cast<uint32_t>(field.size()));
+    buffer += field;
+}
+
+/**
+ * \@brief Reads a u32 at pos if the buffer holds one, advancing pos
+ */
+static bool readU32(const std::string& buffer, size_t& pos, uint32_t& value) {
+    if (buffer.size() - pos < sizeof(value)) {
+        return false;
+    }
+    std::memcpy(&value, buffer.data() + pos, sizeof(value));
+    pos += sizeof(value);
+    return true;
+}
+
+/**
+ * \@brief Reads a length-prefixed field at pos if the buffer holds all of it, advancing pos
+ * \@param malformed Output parameter: set if the length exceeds MAX_REQUEST_FIELD_BYTES
+ */
+static bool readField(const std::string& buffer, size_t& pos, std::string& field, bool& malformed) {
+    uint32_t length = 0;
+    if (!readU32(buffer, pos, length)) {
+        return false;
+    }
+    if (length > MAX_REQUEST_FIELD_BYTES) {
+        malformed = true;
+        return false;
+    }
+    if (buffer.size() - pos < length) {
+        return false;
+    }
+    field.assign(buffer, pos, length);
+    pos += length;
+    return true;
+}
+
+/**
+ * \@brief Extracts one complete request from the front of a client's input buffer
+ * \@param buffer The bytes received so far
+ * \@param consumed Output parameter: bytes used by the request
+ * \@param malformed Output parameter: set if the bytes cannot be a valid request
+ * \@return True if a complete request was extracted
+ */
+static bool parseRequest(const std::string& buffer, size_t& consumed, std::vector<std::string>& args,
+                         std::string& input, bool& malformed) {
+    size_t pos = 0;
+    uint32_t argCount = 0;
+    if (!readU32(buffer, pos, argCount)) {
+        return false;
+    }
+    if (argCount > MAX_REQUEST_ARGS) {
+        malformed = true;
+        return false;
+    }
+    args.resize(argCount);
+    for (uint32_t i = 0; i < argCount; ++i) {
+        if (!readField(buffer, pos, args[i], malformed)) {
+            return false;
+        }
+    }
+    if (!readField(buffer, pos, input, malformed)) {
+        return false;
+    }
+    consumed = pos;
+    return true;
+}
+
+/**
+ * \@brief Redirects std::cout and std::cerr into string buffers for its lifetime
+ * Commands print their results directly; this is how the daemon captures them for the client
+ */
+class CapturedOutput {
+public:
+    CapturedOutput()
+        : previousOut(std::cout.rdbuf(out.rdbuf())), previousErr(std::cerr.rdbuf(err.rdbuf())) {}
+    ~CapturedOutput() {
+        std::cout.rdbuf(previousOut);
+        std::cerr.rdbuf(previousErr);
+    }
+    CapturedOutput(const CapturedOutput&) = delete;
+    CapturedOutput& operator=(const CapturedOutput&) = delete;
+
+    std::ostringstream out;
+    std::ostringstream err;
+
+private:
+    std::streambuf* previousOut;
+    std::streambuf* previousErr;
+};
+
+/**
+ * \@brief Executes one request against the resident tasks
+ * \@param saveFailed Output parameter: set if a batch's own commit failed
+ * \@return The reply, with modified set if the request left uncommitted changes
+ */
+static HeldReply handleRequest(TaskList& tasks, const std::vector<std::string>& args, const std::string& input,
+                               const char* progName, bool& saveFailed) {
+    HeldReply reply;
+    reply.exitCode = 0;
+    reply.modified = false;
+    CapturedOutput captured;
+    if (!args.empty() && args[0] == "serve") {
+        std::cerr << "Error: A daemon is already serving this directory." << std::endl;
+        reply.exitCode = 1;
+    } else if (!args.empty() && args[0] == "batch") {
+        std::istringstream script(input);
+        reply.exitCode = runBatch(tasks, script, progName, &saveFailed); // Commits on its own
+    } else {
+        CommandResult result = executeCommand(tasks, args, progName);
+        reply.exitCode = result.exitCode;
+        reply.modified = result.modified;
+    }
+    reply.out = captured.out.str();
+    reply.err = captured.err.str();
+    return reply;
+}
+
+/**
+ * \@brief Encodes a reply as a response
+ */
+static std::string encodeReply(const HeldReply& reply) {
+    std::string response;
+    appendU32(response, static_cast<uint32_t>(reply.exitCode));
+    appendField(response, reply.out);
+    appendField(response, reply.err);
+    return response;
+}
+
+/**
+ * \@brief Handles a failed commit: every held reply that depends on it reports the
+ * failure instead of its success message, and the resident tasks are loaded again,
+ * so they match the store rather than the changes that were never written
+ * \@param reason What the commit printed to stderr
+ */
+static void failHeldReplies(TaskList& tasks, std::vector<ClientConnection>& clients, const std::string& reason) {
+    for (auto& client : clients) {
+        for (auto& reply : client.held) {
+            if (reply.modified) {
+                reply.exitCode = 1;
+                reply.out.clear();
+                reply.err += reason;
+                reply.err += "Error: The changes could not be saved.\n";
+                reply.modified = false;
+            }
+        }
+    }
+    discardTaskChanges();
+    tasks = loadTasks();
+}
+
+static bool setNonBlocking(int fd) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+/**
+ * \@brief Fills in the address of the daemon socket
+ */
+static sockaddr_un daemonAddress() {
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    std::strncpy(address.sun_path, DAEMON_SOCKET_FILE, sizeof(address.sun_path) - 1);
+    return address;
+}
+
+/**
+ * \@brief Connects to the daemon socket in the working directory
+ * \@return The connected descriptor, or -1 if no daemon is listening
+ */
+static int connectToDaemon() {
+    struct stat info;
+    if (stat(DAEMON_SOCKET_FILE, &info) != 0 || !S_ISSOCK(info.st_mode)) {
+        return -1; // Cheap check first: the common case is that no daemon runs
+    }
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        return -1;
+    }
+    sockaddr_un address = daemonAddress();
+    if (connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        close(fd); // Stale socket file left by a daemon that did not shut down cleanly
+        return -1;
+    }
+    return fd;
+}
+
+/**
+ * \@brief Reads everything currently available from a client
+ */
+static void readFromClient(ClientConnection& client) {
+    char buffer[64 * 1024];
+    while (true) {
+        ssize_t received = read(client.fd, buffer, sizeof(buffer));
+        if (received > 0) {
+            client.inbound.append(buffer, static_cast<size_t>(received));
+        } else if (received < 0 && errno == EINTR) {
+            continue;
+        } else {
+            if (received == 0 || (errno != EAGAIN && errno != EWOULDBLOCK)) {
+                client.closed = true;
+            }
+            return;
+        }
+    }
+}
+
+/**
+ * \@brief Writes as much pending output as the client's socket accepts
+ */
+static void writeToClient(ClientConnection& client) {
+    while (!client.outbound.empty()) {
+        ssize_t sent = write(client.fd, client.outbound.data(), client.outbound.size());
+        if (sent > 0) {
+            client.outbound.erase(0, static_cast<size_t>(sent));
+        } else if (sent < 0 && errno == EINTR) {
+            continue;
+        } else {
+            if (sent < 0 && errno != EAGAIN && errno != EWOULDBLOCK) {
+                client.closed = true;
+                client.outbound.clear();
+            }
+            return;
+        }
+    }
+}
+
+int runDaemon(TaskList& tasks, const char* progName) {
+    // --- Refuse to start twice in the same directory ---
+    if (daemonRunning()) {
+        std::cerr << "Error: A daemon is already listening on '" << DAEMON_SOCKET_FILE << "'." << std::endl;
+        return 1;
+    }
+    unlink(DAEMON_SOCKET_FILE); // Remove a stale socket file, if any
+
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un address = daemonAddress();
+    if (listener < 0 || bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+        listen(listener, SOMAXCONN) != 0 || !setNonBlocking(listener)) {
+        std::cerr << "Error: Could not listen on '" << DAEMON_SOCKET_FILE << "': " << std::strerror(errno) << std::endl;
+        if (listener >= 0) {
+            close(listener);
+        }
+        return 1;
+    }
+
+    // --- Signals: stop cleanly on SIGINT/SIGTERM, survive clients that hang up ---
+    struct sigaction action;
+    std::memset(&action, 0, sizeof(action));
+    action.sa_handler = handleStopSignal; // No SA_RESTART, so poll returns on a signal
+    sigaction(SIGINT, &action, nullptr);
+    sigaction(SIGTERM, &action, nullptr);
+    signal(SIGPIPE, SIG_IGN);
+
+    std::cout << "Serving " << tasks.size() << " task(s) on '" << DAEMON_SOCKET_FILE << "'. Press Ctrl+C to stop." << std::endl;
+
+    std::vector<ClientConnection> clients;
+    std::vector<pollfd> pollFds;
+    std::vector<std::string> args;
+    std::string input;
+
+    while (!stopRequested) {
+        pollFds.clear();
+        pollFds.push_back({ listener, POLLIN, 0 });
+        for (const auto& client : clients) {
+            short events = POLLIN;
+            if (!client.outbound.empty()) {
+                events |= POLLOUT;
+            }
+            pollFds.push_back({ client.fd, events, 0 });
+        }
+        if (poll(pollFds.data(), pollFds.size(), -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            std::cerr << "Error: poll failed: " << std::strerror(errno) << std::endl;
+            break;
+        }
+
+        // --- Read and execute every request that arrived this round ---
+        bool modified = false;
+        for (size_t i = 0; i < clients.size(); ++i) {
+            short revents = pollFds[i + 1].revents;
+            if (revents & (POLLIN | POLLHUP | POLLERR)) {
+                readFromClient(clients[i]);
+            }
+            size_t consumed = 0;
+            bool malformed = false;
+            while (parseRequest(clients[i].inbound, consumed, args, input, malformed)) {
+                clients[i].inbound.erase(0, consumed);
+                bool saveFailed = false;
+                clients[i].held.push_back(handleRequest(tasks, args, input, progName, saveFailed));
+                modified = modified || clients[i].held.back().modified;
+                if (saveFailed) {
+                    // The batch's commit carried the changes held so far in this round as well
+                    failHeldReplies(tasks, clients, std::string());
+                    modified = false;
+                }
+            }
+            if (malformed) {
+                clients[i].closed = true;
+            }
+        }
+
+        // --- Group commit: one write for the whole round, before anyone hears back ---
+        if (modified) {
+            bool saved = false;
+            std::string out;
+            std::string err;
+            {
+                CapturedOutput captured;
+                saved = commitTasks(tasks);
+                out = captured.out.str();
+                err = captured.err.str();
+            }
+            std::cout << out;
+            std::cerr << err;
+            if (!saved) {
+                failHeldReplies(tasks, clients, err);
+            }
+        }
+        for (auto& client : clients) {
+            for (const auto& reply : client.held) {
+                client.outbound += encodeReply(reply);
+            }
+            client.held.clear();
+            writeToClient(client);
+        }
+
+        // --- Drop clients that hung up ---
+        size_t kept = 0;
+        for (size_t i = 0; i < clients.size(); ++i) {
+            if (clients[i].closed) {
+                close(clients[i].fd);
+            } else {
+                if (kept != i) {
+                    clients[kept] = std::move(clients[i]);
+                }
+                ++kept;
+            }
+        }
+        clients.erase(clients.begin() + static_cast<std::ptrdiff_t>(kept), clients.end());
+
+        // --- Accept new clients after serving the existing ones ---
+        if (pollFds[0].revents & POLLIN) {
+            while (true) {
+                int fd = accept(listener, nullptr, nullptr);
+                if (fd < 0) {
+                    break;
+                }
+                if (!setNonBlocking(fd)) {
+                    close(fd);
+                    continue;
+                }
+                clients.emplace_back(fd);
+            }
+        }
+    }
+
+    // --- Shutdown ---
+    bool saved = commitTasks(tasks);
+    for (const auto& client : clients) {
+        close(client.fd);
+    }
+    close(listener);
+    unlink(DAEMON_SOCKET_FILE);
+    std::cout << "Daemon stopped." << std::endl;
+    return saved ? 0 : 1;
+}
+
+/**
+ * \@brief Writes a whole buffer to a blocking descriptor
+ */
+static bool writeAll(int fd, const std::string& data) {
+    size_t offset = 0;
+    while (offset < data.size()) {
+        ssize_t sent = write(fd, data.data() + offset, data.size() - offset);
+        if (sent < 0 && errno == EINTR) {
+            continue;
+        }
+        if (sent <= 0) {
+            return false;
+        }
+        offset += static_cast<size_t>(sent);
+    }
+    return true;
+}
+
+/**
+ * \@brief Reads exactly size bytes from a blocking descriptor
+ */
+static bool readExactly(int fd, std::string& data, size_t size) {
+    data.resize(size);
+    size_t offset = 0;
+    while (offset < size) {
+        ssize_t received = read(fd, &data[offset], size - offset);
+        if (received < 0 && errno == EINTR) {
+            continue;
+        }
+        if (received <= 0) {
+            return false;
+        }
+        offset += static_cast<size_t>(received);
+    }
+    return true;
+}
+
+/**
+ * \@brief Reads one length-prefixed field of a response
+ */
+static bool readResponseField(int fd, std::string& field) {
+    std::string lengthBytes;
+    if (!readExactly(fd, lengthBytes, sizeof(uint32_t))) {
+        return false;
+    }
+    uint32_t length = 0;
+    std::memcpy(&length, lengthBytes.data(), sizeof(length));
+    return readExactly(fd, field, length);
+}
+
+bool daemonRunning() {
+    int fd = connectToDaemon();
+    if (fd < 0) {
+        return false;
+    }
+    close(fd);
+    return true;
+}
+
+bool forwardToDaemon(const std::vector<std::string>& args, const std::string& input, int& exitCode) {
+    int fd = connectToDaemon();
+    if (fd < 0) {
+        return false;
+    }
+
+    std::string request;
+    appendU32(request, static_cast<uint32_t>(args.size()));
+    for (const auto& arg : args) {
+        appendField(request, arg);
+    }
+    appendField(request, input);
+
+    // The daemon has not seen a complete request until the last byte arrives,
+    // so a failed send means the command did not run and can still run locally
+    signal(SIGPIPE, SIG_IGN);
+    if (!writeAll(fd, request)) {
+        close(fd);
+        return false;
+    }
+
+    std::string exitBytes;
+    std::string out;
+    std::string err;
+    bool received = readExactly(fd, exitBytes, sizeof(uint32_t)) && readResponseField(fd, out) && readResponseField(fd, err);
+    close(fd);
+    if (!received) {
+        // The command may or may not have run; running it again here could apply it twice
+        std::cerr << "Error: Lost the connection to the task-cli daemon; the command's outcome is unknown." << std::endl;
+        exitCode = 1;
+        return true;
+    }
+
+    uint32_t code = 0;
+    std::memcpy(&code, exitBytes.data(), sizeof(code));
+    exitCode = static_cast<int>(code);
+    std::cout << out << std::flush;
+    std::cerr << err << std::flush;
+    return true;
+}
@@ -0,0 +1,296 @@
+#include "json_text.h"
+#include <string>
+#include <cstdint>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h> // For the SSE2 and AVX2 intrinsics
+#endif
+
+// --- Scanning for bytes that need attention ---
+// Escaping stops at '"', '\\' and control characters (< 0x20); decoding stops
+// at '"' and '\\' only. Each scanner returns the first such byte, or end
+
+/**
+ * \@brief Checks whether a byte has to be escaped in a JSON string
+ */
+static inline bool needsEscape(unsigned char c) {
+    return c == '"' || c == '\\' || c < 0x20;
+}
+
+/**
+ * \@brief Byte-at-a-time scan, for the tail of a buffer and for non-x86 builds
+ * \@tparam Controls Whether control characters count as hits (escaping) or not (decoding)
+ */
+template <bool Controls>
+static const char* scanScalar(const char* p, const char* end) {
+    for (; p < end; ++p) {
+        unsigned char c = static_cast<unsigned char>(*p);
+        if (Controls ? needsEscape(c) : (c == '"' || c == '\\')) {
+            return p;
+        }
+    }
+    return end;
+}
+
+#if defined(__SSE2__)
+/**
+ * \@brief 16 bytes at a time: compare against '"' and '\\', and test c <= 0x1F as max(c, 0x1F) == 0x1F
+ */
+template <bool Controls>
+static const char* scanSse2(const char* p, const char* end) {
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i lastControl = _mm_set1_epi8(0x1F);
+    while (end - p >= 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        __m128i hits = _mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash));
+        if (Controls) {
+            hits = _mm_or_si128(hits, _mm_cmpeq_epi8(_mm_max_epu8(chunk, lastControl), lastControl));
+        }
+        unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(hits));
+        if (mask != 0) {
+            return p + __builtin_ctz(mask);
+        }
+        p += 16;
+    }
+    return scanScalar<Controls>(p, end);
+}
+
+/**
+ * \@brief The same scan 32 bytes at a time; only called when the CPU reports AVX2
+ */
+template <bool Controls>
+__attribute__((target("avx2"))) static const char* scanAvx2(const char* p, const char* end) {
+    const __m256i quote = _mm256_set1_epi8('"');
+    const __m256i backslash = _mm256_set1_epi8('\\');
+    const __m256i lastControl = _mm256_set1_epi8(0x1F);
+    while (end - p >= 32) {
+        __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        __m256i hits = _mm256_or_si256(_mm256_cmpeq_epi8(chunk, quote), _mm256_cmpeq_epi8(chunk, backslash));
+        if (Controls) {
+            hits = _mm256_or_si256(hits, _mm256_cmpeq_epi8(_mm256_max_epu8(chunk, lastControl), lastControl));
+        }
+        unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(hits));
+        if (mask != 0) {
+            return p + __builtin_ctz(mask);
+        }
+        p += 32;
+    }
+    return scanSse2<Controls>(p, end);
+}
+#endif
+
+typedef const char* (*ScanFunction)(const char*, const char*);
+
+/**
+ * \@brief Picks the widest scanner the CPU supports (decided once per process)
+ */
+template <bool Controls>
+static ScanFunction chooseScanner() {
+#if defined(__SSE2__)
+    __builtin_cpu_init(); // May run before libgcc's own initializer
+    if (__builtin_cpu_supports("avx2")) {
+        return scanAvx2<Controls>;
+    }
+    return scanSse2<Controls>;
+#else
+    return scanScalar<Controls>;
+#endif
+}
+
+static const ScanFunction wideScanEscape = chooseScanner<true>();
+static const ScanFunction wideScanDecode = chooseScanner<false>();
+
+// Runs shorter than this are scanned inline with SSE2: for typical descriptions the
+// indirect call to the AVX2 scanner costs more than the wider compares save
+const ptrdiff_t WIDE_SCAN_MIN_BYTES = 256;
+
+/**
+ * \@brief Finds the next byte that must be escaped (Controls) or decoded (!Controls)
+ * \@return Pointer to it, or end
+ */
+template <bool Controls>
+static inline const char* findSpecialByte(const char* p, const char* end) {
+    if (end - p >= WIDE_SCAN_MIN_BYTES) {
+        return Controls ? wideScanEscape(p, end) : wideScanDecode(p, end);
+    }
+#if defined(__SSE2__)
+    return scanSse2<Controls>(p, end);
+#else
+    return scanScalar<Controls>(p, end);
+#endif
+}
+
+// --- Escaping ---
+
+const char HEX_DIGITS[] = "0123456789abcdef";
+
+/**
+ * \@brief Appends the escape sequence for one byte that needsEscape
+ */
+static void appendEscape(std::string& out, char c) {
+    switch (c) {
+        case '"': out += "\\\""; break; // Escape double quote
+        case '\\': out += "\\\\"; break; // Escape backslash
+        case '\b': out += "\\b"; break; // Backspace
+        case '\f': out += "\\f"; break; // Form feed
+        case '\n': out += "\\n"; break; // Newline
+        case '\r': out += "\\r"; break; // Carriage return
+        case '\t': out += "\\t"; break; // Tab
+        default: { // Any other control character
+            unsigned char byte = static_cast<unsigned char>(c);
+            char escape[6] = { '\\', 'u', '0', '0', HEX_DIGITS[byte >> 4], HEX_DIGITS[byte & 0xF] };
+            out.append(escape, sizeof(escape));
+            break;
+        }
+    }
+}
+
+/**
+ * \@brief Appends the escaped form of some text to a buffer
+ * \@param out The buffer to append to
+ * \@param data The text to escape
+ * \@param size Length of the text in bytes
+ */
+void appendJsonEscaped(std::string& out, const char* data, size_t size) {
+    const char* p = data;
+    const char* end = data + size;
+    while (p < end) {
+        const char* special = findSpecialByte<true>(p, end);
+        out.append(p, special - p); // The clean run before it
+        if (special == end) {
+            break;
+        }
+        appendEscape(out, *special);
+        p = special + 1;
+    }
+}
+
+/**
+ * \@brief Escapes a string for embedding in a JSON string value
+ * \@param input The string to escape
+ * \@return The escaped string (without surrounding quotes)
+ */
+std::string escapeJsonString(const std::string& input) {
+    std::string escaped;
+    escaped.reserve(input.size() + input.size() / 8);
+    appendJsonEscaped(escaped, input.data(), input.size());
+    return escaped;
+}
+
+// --- Decoding ---
+
+/**
+ * \@brief Reads the four hex digits of a \u escape
+ * \@return True if all four are hex digits
+ */
+static bool readHex4(const char* p, const char* end, uint32_t& value) {
+    if (end - p < 4) {
+        return false;
+    }
+    value = 0;
+    for (int i = 0; i < 4; ++i) {
+        char c = p[i];
+        uint32_t digit;
+        if (c >= '0' && c <= '9') {
+            digit = static_cast<uint32_t>(c - '0');
+        } else if (c >= 'a' && c <= 'f') {
+            digit = static_cast<uint32_t>(c - 'a' + 10);
+        } else if (c >= 'A' && c <= 'F') {
+            digit = static_cast<uint32_t>(c - 'A' + 10);
+        } else {
+            return false;
+        }
+        value = (value << 4) | digit;
+    }
+    return true;
+}
+
+/**
+ * \@brief Appends a code point as UTF-8
+ */
+static void appendUtf8(std::string& out, uint32_t codePoint) {
+    if (codePoint < 0x80) {
+        out += static_cast<char>(codePoint);
+    } else if (codePoint < 0x800) {
+        out += static_cast<char>(0xC0 | (codePoint >> 6));
+        out += static_cast<char>(0x80 | (codePoint & 0x3F));
+    } else if (codePoint < 0x10000) {
+        out += static_cast<char>(0xE0 | (codePoint >> 12));
+        out += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (codePoint & 0x3F));
+    } else {
+        out += static_cast<char>(0xF0 | (codePoint >> 18));
+        out += static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (codePoint & 0x3F));
+    }
+}
+
+/**
+ * \@brief Decodes the escape whose backslash precedes p
+ * \@param p The character after the backslash (must be < end)
+ * \@return Where decoding continues
+ */
+static const char* decodeEscape(const char* p, const char* end, std::string& out) {
+    switch (*p) {
+        case 'b': out += '\b'; return p + 1;
+        case 'f': out += '\f'; return p + 1;
+        case 'n': out += '\n'; return p + 1;
+        case 'r': out += '\r'; return p + 1;
+        case 't': out += '\t'; return p + 1;
+        case 'u': {
+            uint32_t codePoint = 0;
+            if (!readHex4(p + 1, end, codePoint)) {
+                break; // Not a valid \u escape: keep the 'u'
+            }
+            const char* next = p + 5;
+            if (codePoint >= 0xD800 && codePoint <= 0xDBFF) {
+                // High surrogate: only meaningful when a low surrogate escape follows
+                uint32_t low = 0;
+                if (end - next >= 6 && next[0] == '\\' && next[1] == 'u' && readHex4(next + 2, end, low) &&
+                    low >= 0xDC00 && low <= 0xDFFF) {
+                    codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+                    next += 6;
+                } else {
+                    codePoint = 0xFFFD;
+                }
+            } else if (codePoint >= 0xDC00 && codePoint <= 0xDFFF) {
+                codePoint = 0xFFFD; // Low surrogate on its own
+            }
+            appendUtf8(out, codePoint);
+            return next;
+        }
+        default:
+            break;
+    }
+    // \" \\ \/ and anything unknown: the character itself
+    out += *p;
+    return p + 1;
+}
+
+/**
+ * \@brief Decodes the contents of a JSON string up to its closing quote
+ * \@param pos The cursor, just past the opening quote (advanced past the closing quote on success)
+ * \@param end One past the last character of the buffer
+ * \@param out Output parameter: the decoded text is appended to it
+ * \@return True if the closing quote was found, false if the input ended first
+ */
+bool readJsonStringBody(const char*& pos, const char* end, std::string& out) {
+    const char* p = pos;
+    while (true) {
+        const char* special = findSpecialByte<false>(p, end);
+        out.append(p, special - p); // The plain run before it
+        if (special == end) {
+            return false; // Ran out of input before the closing quote
+        }
+        if (*special == '"') {
+            pos = special + 1;
+            return true;
+        }
+        p = special + 1; // Past the backslash
+        if (p >= end) {
+            return false;
+        }
+        p = decodeEscape(p, end, out);
+    }
+}
@@ -0,0 +1,1014 @@
+#include "lsm_store.h"
+#include "stats.h" // For --stats phase timing and byte counts
+#include "utils.h" // For crc32
+#include <iostream>
+#include <vector>
+#include <string>
+#include <map>
+#include <memory> // For std::shared_ptr, std::unique_ptr
+#include <mutex>
+#include <thread> // For the background merge
+#include <atomic>
+#include <cstring> // For std::memcmp, std::memcpy, std::memset
+#include <cstdio> // For std::rename, std::remove, std::snprintf
+#include <algorithm> // For std::sort, std::upper_bound, std::max
+#include <utility> // For std::move
+#include <chrono>
+#include <fcntl.h> // For open
+#include <sys/stat.h> // For fstat, stat
+#include <unistd.h> // For pread, write, fsync, ftruncate, close
+
+// Name of the manifest in the working directory; runs and logs are named after it
+const std::string LSM_MANIFEST_FILE = "tasks.lsm";
+const char LSM_MANIFEST_MAGIC[8] = { 'T', 'A', 'S', 'K', 'L', 'S', 'M', '1' };
+const uint32_t LSM_MANIFEST_VERSION = 1;
+const char LSM_RUN_MAGIC[8] = { 'T', 'A', 'S', 'K', 'R', 'U', 'N', '1' };
+// Runs are written in batches of this many bytes
+const size_t LSM_WRITE_BYTES = 1024 * 1024;
+// Bits set per id in a bloom filter: bits per key * ln 2, rounded
+const uint32_t LSM_BLOOM_HASHES = 7;
+// Smallest bloom filter, so a run of a handful of ids still filters
+const size_t LSM_BLOOM_MIN_BITS = 64;
+
+static_assert(sizeof(LsmManifestHeader) == 32, "LsmManifestHeader layout changed");
+static_assert(sizeof(LsmRecordHeader) == 32, "LsmRecordHeader layout changed");
+static_assert(sizeof(LsmIndexEntry) == 16, "LsmIndexEntry layout changed");
+static_assert(sizeof(LsmRunFooter) == 40, "LsmRunFooter layout changed");
+static_assert(sizeof(LsmWalFrame) == 16, "LsmWalFrame layout changed");
+
+/**
+ * \@brief Converts a time point to the nanosecond count stored in a record
+ */
+static int64_t toRecordTime(const std::chrono::system_clock::time_point& tp) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(tp.time_since_epoch()).count();
+}
+
+/**
+ * \@brief Converts a record's nanosecond count back to a time point
+ */
+static std::chrono::system_clock::time_point fromRecordTime(int64_t nanos) {
+    return std::chrono::system_clock::time_point(
+        std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::nanoseconds(nanos)));
+}
+
+/**
+ * \@brief The name of a run ("run") or log ("wal") file
+ */
+static std::string lsmFileName(uint32_t number, const char* extension) {
+    char name[40];
+    std::snprintf(name, sizeof(name), "%s-%06u.%s", LSM_MANIFEST_FILE.c_str(), number, extension);
+    return name;
+}
+
+/**
+ * \@brief Writes a whole buffer at the descriptor's position, retrying on short writes
+ * \@return True if every byte was written
+ */
+static bool writeAll(int fd, const void* buffer, size_t size) {
+    const char* p = static_cast<const char*>(buffer);
+    while (size > 0) {
+        ssize_t written = write(fd, p, size);
+        if (written <= 0) {
+            return false;
+        }
+        addBytesWritten(static_cast<size_t>(written));
+        p += written;
+        size -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+/**
+ * \@brief Reads a buffer from a given offset, retrying on short reads
+ * \@return True if every byte was read (false at end of file)
+ */
+static bool readAt(int fd, void* buffer, size_t size, uint64_t offset) {
+    char* p = static_cast<char*>(buffer);
+    while (size > 0) {
+        ssize_t got = pread(fd, p, size, static_cast<off_t>(offset));
+        if (got <= 0) {
+            return false;
+        }
+        addBytesRead(static_cast<size_t>(got));
+        p += got;
+        size -= static_cast<size_t>(got);
+        offset += static_cast<uint64_t>(got);
+    }
+    return true;
+}
+
+/**
+ * \@brief Makes a renamed manifest durable
+ */
+static void syncWorkingDirectory() {
+    int dirFd = open(".", O_RDONLY);
+    if (dirFd >= 0) {
+        fsync(dirFd);
+        close(dirFd);
+    }
+}
+
+bool lsmStoreExists() {
+    struct stat info;
+    return stat(LSM_MANIFEST_FILE.c_str(), &info) == 0;
+}
+
+// --- Records ---
+
+/**
+ * \@brief Appends one record: a task's new state, or a deletion marker if task is null
+ */
+static void appendRecord(std::string& out, int id, const Task* task) {
+    LsmRecordHeader header;
+    std::memset(&header, 0, sizeof(header));
+    header.id = id;
+    header.kind = task != nullptr ? LSM_RECORD_PUT : LSM_RECORD_DELETE;
+    if (task != nullptr) {
+        header.status = static_cast<uint8_t>(task->status);
+        header.descriptionLength = static_cast<uint32_t>(task->description.size());
+        header.createdAt = toRecordTime(task->createdAt);
+        header.updatedAt = toRecordTime(task->updatedAt);
+    }
+    out.append(reinterpret_cast<const char*>(&header), sizeof(header));
+    if (task != nullptr) {
+        out += task->description;
+    }
+}
+
+/**
+ * \@brief Decodes the record at pos and advances past it
+ * \@param entry Output parameter: the record as a change (deleted set for a marker)
+ * \@return False if the record runs past end or is invalid
+ */
+static bool decodeRecord(const char*& pos, const char* end, TaskChange& entry) {
+    LsmRecordHeader header;
+    if (static_cast<size_t>(end - pos) < sizeof(header)) {
+        return false;
+    }
+    std::memcpy(&header, pos, sizeof(header));
+    pos += sizeof(header);
+    if ((header.kind != LSM_RECORD_PUT && header.kind != LSM_RECORD_DELETE) ||
+        header.status >= TASK_STATUS_COUNT || header.descriptionLength > static_cast<size_t>(end - pos)) {
+        return false;
+    }
+    entry.id = header.id;
+    entry.deleted = header.kind == LSM_RECORD_DELETE;
+    entry.task.id = header.id;
+    entry.task.description.assign(pos, header.descriptionLength);
+    entry.task.status = static_cast<TaskStatus>(header.status);
+    entry.task.createdAt = fromRecordTime(header.createdAt);
+    entry.task.updatedAt = fromRecordTime(header.updatedAt);
+    pos += header.descriptionLength;
+    return true;
+}
+
+/**
+ * \@brief Merges newer entries over older ones; both sorted by id, the newer state wins
+ * \@param base The older entries, replaced by the merged ones
+ * \@param newer The newer entries
+ */
+static void mergeNewer(std::vector<TaskChange>& base, std::vector<TaskChange>&& newer) {
+    if (base.empty()) {
+        base = std::move(newer);
+        return;
+    }
+    std::vector<TaskChange> merged;
+    merged.reserve(base.size() + newer.size());
+    size_t i = 0;
+    size_t j = 0;
+    while (i < base.size() || j < newer.size()) {
+        if (j == newer.size() || (i < base.size() && base[i].id < newer[j].id)) {
+            merged.push_back(std::move(base[i++]));
+        } else {
+            if (i < base.size() && base[i].id == newer[j].id) {
+                ++i; // Superseded
+            }
+            merged.push_back(std::move(newer[j++]));
+        }
+    }
+    base.swap(merged);
+}
+
+// --- Bloom filters ---
+
+/**
+ * \@brief Spreads an id over 64 bits (the splitmix64 finalizer)
+ */
+static uint64_t mixId(int id) {
+    uint64_t x = static_cast<uint64_t>(static_cast<uint32_t>(id)) + 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+/**
+ * \@brief The i-th bit of an id's hash (double hashing: h1 + i * h2)
+ */
+static size_t bloomBit(uint64_t hash, uint32_t i, size_t bitCount) {
+    uint32_t h1 = static_cast<uint32_t>(hash);
+    uint32_t h2 = static_cast<uint32_t>(hash >> 32) | 1;
+    return static_cast<size_t>((h1 + static_cast<uint64_t>(i) * h2) % bitCount);
+}
+
+/**
+ * \@brief Sets the bits of an id in a bloom filter
+ */
+static void bloomAdd(std::vector<uint8_t>& bloom, uint32_t hashes, int id) {
+    uint64_t hash = mixId(id);
+    for (uint32_t i = 0; i < hashes; ++i) {
+        size_t bit = bloomBit(hash, i, bloom.size() * 8);
+        bloom[bit / 8] |= static_cast<uint8_t>(1u << (bit % 8));
+    }
+}
+
+/**
+ * \@brief Checks whether a bloom filter may hold an id
+ * \@return False if the id is certainly absent
+ */
+static bool bloomMayContain(const std::vector<uint8_t>& bloom, uint32_t hashes, int id) {
+    uint64_t hash = mixId(id);
+    for (uint32_t i = 0; i < hashes; ++i) {
+        size_t bit = bloomBit(hash, i, bloom.size() * 8);
+        if (!(bloom[bit / 8] & (1u << (bit % 8)))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// --- Run files ---
+
+/**
+ * \@brief Writes a run file: records in id order, then the index, bloom filter and footer
+ */
+class RunWriter {
+public:
+    explicit RunWriter(uint32_t number) : name(lsmFileName(number, "run")) {
+        fd = open(name.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) {
+            std::cerr << "Error: Could not open '" << name << "' for writing." << std::endl;
+        }
+    }
+    ~RunWriter() {
+        if (fd >= 0) {
+            close(fd);
+            std::remove(name.c_str()); // Never finished
+        }
+    }
+
+    /**
+     * \@brief Appends a record; ids must come in ascending order
+     * \@param task The task's state, or null for a deletion marker
+     */
+    void add(int id, const Task* task) {
+        if (!blockOpen) {
+            index.push_back(LsmIndexEntry{ id, id, offset });
+            blockOpen = true;
+        }
+        size_t before = buffer.size();
+        appendRecord(buffer, id, task);
+        offset += buffer.size() - before;
+        index.back().lastId = id;
+        ids.push_back(id);
+        blockOpen = offset - index.back().offset < LSM_BLOCK_BYTES;
+        if (buffer.size() >= LSM_WRITE_BYTES) {
+            flush();
+        }
+    }
+
+    /**
+     * \@brief Writes the index, bloom filter and footer, and syncs the file
+     * \@return True if the whole run is on disk
+     */
+    bool finish() {
+        LsmRunFooter footer;
+        std::memset(&footer, 0, sizeof(footer));
+        std::memcpy(footer.magic, LSM_RUN_MAGIC, sizeof(footer.magic));
+        footer.indexOffset = offset;
+        footer.recordCount = ids.size();
+        footer.blockCount = static_cast<uint32_t>(index.size());
+        size_t bitCount = std::max(LSM_BLOOM_MIN_BITS, ids.size() * LSM_BLOOM_BITS_PER_KEY);
+        std::vector<uint8_t> bloom((bitCount + 7) / 8, 0);
+        for (int id : ids) {
+            bloomAdd(bloom, LSM_BLOOM_HASHES, id);
+        }
+        footer.bloomBytes = static_cast<uint32_t>(bloom.size());
+        footer.bloomHashes = LSM_BLOOM_HASHES;
+
+        size_t tailStart = buffer.size();
+        buffer.append(reinterpret_cast<const char*>(index.data()), index.size() * sizeof(LsmIndexEntry));
+        buffer.append(reinterpret_cast<const char*>(bloom.data()), bloom.size());
+        footer.crc = crc32(buffer.data() + tailStart, buffer.size() - tailStart);
+        buffer.append(reinterpret_cast<const char*>(&footer), sizeof(footer));
+
+        bool ok = flush() && fd >= 0 && fsync(fd) == 0;
+        ok = fd >= 0 && close(fd) == 0 && ok;
+        fd = -1;
+        if (!ok) {
+            std::cerr << "Error: Failed to write '" << name << "'." << std::endl;
+            std::remove(name.c_str());
+        }
+        return ok;
+    }
+
+private:
+    bool flush() {
+        failed = failed || fd < 0 || !writeAll(fd, buffer.data(), buffer.size());
+        buffer.clear();
+        return !failed;
+    }
+
+    std::string name;
+    int fd = -1;
+    std::string buffer; // Bytes not yet written
+    uint64_t offset = 0; // Record bytes so far (written and buffered)
+    bool blockOpen = false; // The last index entry's block takes more records
+    std::vector<LsmIndexEntry> index;
+    std::vector<int> ids; // For the bloom filter
+    bool failed = false;
+};
+
+/**
+ * \@brief An open, immutable run: its descriptor plus the index and bloom filter in memory
+ * Reads use pread only, so the merge thread may read a run while commits read it too
+ */
+class LsmRun {
+public:
+    explicit LsmRun(uint32_t number) : number(number) {}
+    ~LsmRun() {
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+    LsmRun(const LsmRun&) = delete;
+    LsmRun& operator=(const LsmRun&) = delete;
+
+    bool open();
+    bool find(int id, TaskChange& entry) const;
+    bool readAll(std::vector<TaskChange>& entries) const;
+    uint32_t fileNumber() const { return number; }
+
+private:
+    uint32_t number;
+    int fd = -1;
+    LsmRunFooter footer;
+    std::vector<LsmIndexEntry> index;
+    std::vector<uint8_t> bloom;
+};
+
+/**
+ * \@brief Opens the run file and reads its index and bloom filter
+ * \@return False if the file is missing, truncated or fails its checksum
+ */
+bool LsmRun::open() {
+    std::string name = lsmFileName(number, "run");
+    fd = ::open(name.c_str(), O_RDONLY | O_CLOEXEC);
+    struct stat info;
+    if (fd < 0 || fstat(fd, &info) != 0 || static_cast<uint64_t>(info.st_size) < sizeof(footer) ||
+        !readAt(fd, &footer, sizeof(footer), static_cast<uint64_t>(info.st_size) - sizeof(footer)) ||
+        std::memcmp(footer.magic, LSM_RUN_MAGIC, sizeof(footer.magic)) != 0) {
+        return false;
+    }
+    uint64_t indexBytes = static_cast<uint64_t>(footer.blockCount) * sizeof(LsmIndexEntry);
+    if (footer.indexOffset + indexBytes + footer.bloomBytes + sizeof(footer) != static_cast<uint64_t>(info.st_size) ||
+        footer.bloomBytes == 0 || footer.bloomHashes == 0) {
+        return false;
+    }
+    std::vector<char> tail(indexBytes + footer.bloomBytes);
+    if (!readAt(fd, tail.data(), tail.size(), footer.indexOffset) || crc32(tail.data(), tail.size()) != footer.crc) {
+        return false;
+    }
+    index.resize(footer.blockCount);
+    std::memcpy(index.data(), tail.data(), indexBytes);
+    bloom.assign(tail.begin() + static_cast<std::ptrdiff_t>(indexBytes), tail.end());
+    return true;
+}
+
+/**
+ * \@brief Looks an id up: bloom filter, then a binary search of the sparse index, then one block
+ * \@param entry Output parameter: the run's record for the id (a state or a deletion marker)
+ * \@return True if the run has a record for the id
+ */
+bool LsmRun::find(int id, TaskChange& entry) const {
+    if (index.empty() || !bloomMayContain(bloom, footer.bloomHashes, id)) {
+        return false;
+    }
+    auto block = std::upper_bound(index.begin(), index.end(), id,
+                                  [](int key, const LsmIndexEntry& e) { return key < e.firstId; });
+    if (block == index.begin() || id > (--block)->lastId) {
+        return false;
+    }
+    uint64_t end = block + 1 == index.end() ? footer.indexOffset : (block + 1)->offset;
+    std::vector<char> bytes(end - block->offset);
+    if (!readAt(fd, bytes.data(), bytes.size(), block->offset)) {
+        return false;
+    }
+    const char* pos = bytes.data();
+    const char* stop = pos + bytes.size();
+    while (pos < stop && decodeRecord(pos, stop, entry)) {
+        if (entry.id >= id) {
+            return entry.id == id;
+        }
+    }
+    return false;
+}
+
+/**
+ * \@brief Reads every record of the run, in id order
+ * \@return False if the blocks cannot be read or decoded
+ */
+bool LsmRun::readAll(std::vector<TaskChange>& entries) const {
+    std::vector<char> bytes(footer.indexOffset);
+    if (!readAt(fd, bytes.data(), bytes.size(), 0)) {
+        return false;
+    }
+    entries.clear();
+    entries.reserve(footer.recordCount);
+    const char* pos = bytes.data();
+    const char* stop = pos + bytes.size();
+    while (pos < stop) {
+        TaskChange entry;
+        if (!decodeRecord(pos, stop, entry)) {
+            return false;
+        }
+        entries.push_back(std::move(entry));
+    }
+    return entries.size() == footer.recordCount;
+}
+
+// --- Manifest and log ---
+
+// The manifest's contents
+struct Manifest {
+    int nextId = 0;
+    uint32_t nextFileNumber = 1;
+    uint32_t walNumber = 0;
+    std::vector<uint32_t> runs; // Newest first
+};
+
+/**
+ * \@brief Reads and checks tasks.lsm
+ * \@return False if it is missing, truncated or fails its checksum
+ */
+static bool readManifest(Manifest& manifest) {
+    int fd = open(LSM_MANIFEST_FILE.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    LsmManifestHeader header;
+    bool ok = readAt(fd, &header, sizeof(header), 0) &&
+              std::memcmp(header.magic, LSM_MANIFEST_MAGIC, sizeof(header.magic)) == 0 &&
+              header.version == LSM_MANIFEST_VERSION;
+    std::vector<uint32_t> runs(ok ? header.runCount : 0);
+    ok = ok && readAt(fd, runs.data(), runs.size() * sizeof(uint32_t), sizeof(header));
+    close(fd);
+    if (!ok) {
+        return false;
+    }
+    uint32_t stored = header.crc;
+    header.crc = 0;
+    uint32_t crc = crc32(&header, sizeof(header));
+    if (crc32(runs.data(), runs.size() * sizeof(uint32_t), crc) != stored) {
+        return false;
+    }
+    manifest.nextId = header.nextId;
+    manifest.nextFileNumber = header.nextFileNumber;
+    manifest.walNumber = header.walNumber;
+    manifest.runs.swap(runs);
+    return true;
+}
+
+/**
+ * \@brief Replaces tasks.lsm (via a temporary file, fsync and rename)
+ * \@return True once the new manifest is in place
+ */
+static bool writeManifest(const Manifest& manifest) {
+    LsmManifestHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, LSM_MANIFEST_MAGIC, sizeof(header.magic));
+    header.version = LSM_MANIFEST_VERSION;
+    header.runCount = static_cast<uint32_t>(manifest.runs.size());
+    header.nextId = manifest.nextId;
+    header.nextFileNumber = manifest.nextFileNumber;
+    header.walNumber = manifest.walNumber;
+    uint32_t crc = crc32(&header, sizeof(header));
+    header.crc = crc32(manifest.runs.data(), manifest.runs.size() * sizeof(uint32_t), crc);
+
+    const std::string tempFile = LSM_MANIFEST_FILE + ".tmp";
+    int fd = open(tempFile.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    bool ok = fd >= 0 && writeAll(fd, &header, sizeof(header)) &&
+              writeAll(fd, manifest.runs.data(), manifest.runs.size() * sizeof(uint32_t)) && fsync(fd) == 0;
+    ok = (fd < 0 || close(fd) == 0) && ok;
+    if (!ok || std::rename(tempFile.c_str(), LSM_MANIFEST_FILE.c_str()) != 0) {
+        std::cerr << "Error: Failed to write '" << LSM_MANIFEST_FILE << "'." << std::endl;
+        std::remove(tempFile.c_str());
+        return false;
+    }
+    syncWorkingDirectory();
+    return true;
+}
+
+/**
+ * \@brief Appends one commit's changes to the log as a single checksummed frame
+ * Not synced, like tasks.log: a crash may lose the last commits, never earlier ones
+ * \@param bytes Output parameter: the bytes appended
+ * \@return True if the whole frame was written
+ */
+static bool appendWal(uint32_t number, const std::vector<TaskChange>& changes, int nextId, uint64_t& bytes) {
+    std::string frame(sizeof(LsmWalFrame), '\0');
+    for (const auto& change : changes) {
+        appendRecord(frame, change.id, change.deleted ? nullptr : &change.task);
+    }
+    LsmWalFrame header;
+    header.length = static_cast<uint32_t>(frame.size() - sizeof(header));
+    header.nextId = nextId;
+    header.recordCount = static_cast<uint32_t>(changes.size());
+    uint32_t crc = crc32(&header.nextId, sizeof(header.nextId) + sizeof(header.recordCount));
+    header.crc = crc32(frame.data() + sizeof(header), header.length, crc);
+    std::memcpy(&frame[0], &header, sizeof(header));
+
+    std::string name = lsmFileName(number, "wal");
+    int fd = open(name.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    bool ok = fd >= 0 && writeAll(fd, frame.data(), frame.size());
+    ok = (fd < 0 || close(fd) == 0) && ok;
+    if (!ok) {
+        std::cerr << "Error: Failed to write to '" << name << "'." << std::endl;
+        return false;
+    }
+    bytes = frame.size();
+    return true;
+}
+
+/**
+ * \@brief Rebuilds the memtable from the log
+ * Replay stops at the first frame that is cut short or fails its checksum (a commit
+ * that was being written when the process died); the log is truncated there, so
+ * later commits are not appended behind the damage (unless only the shared lock is
+ * held, see storeRepairAllowed)
+ * \@param nextId In/out: raised to the counter of the last complete frame
+ * \@param bytes Output parameter: the length of the intact log
+ * \@return False if the log exists but cannot be read
+ */
+static bool replayWal(uint32_t number, std::map<int, TaskChange>& memtable, int& nextId, uint64_t& bytes) {
+    std::string name = lsmFileName(number, "wal");
+    bytes = 0;
+    int fd = open(name.c_str(), O_RDWR | O_CLOEXEC);
+    if (fd < 0) {
+        return true; // No commits since the last flush
+    }
+    struct stat info;
+    std::vector<char> log;
+    bool ok = fstat(fd, &info) == 0;
+    if (ok) {
+        log.resize(static_cast<size_t>(info.st_size));
+        ok = readAt(fd, log.data(), log.size(), 0);
+    }
+    if (!ok) {
+        close(fd);
+        std::cerr << "Error: Could not read '" << name << "'." << std::endl;
+        return false;
+    }
+
+    size_t pos = 0;
+    while (log.size() - pos >= sizeof(LsmWalFrame)) {
+        LsmWalFrame header;
+        std::memcpy(&header, log.data() + pos, sizeof(header));
+        const char* records = log.data() + pos + sizeof(header);
+        if (header.length > log.size() - pos - sizeof(header)) {
+            break;
+        }
+        uint32_t crc = crc32(&header.nextId, sizeof(header.nextId) + sizeof(header.recordCount));
+        if (crc32(records, header.length, crc) != header.crc) {
+            break;
+        }
+        std::vector<TaskChange> entries(header.recordCount);
+        const char* at = records;
+        const char* stop = records + header.length;
+        uint32_t decoded = 0;
+        while (decoded < header.recordCount && decodeRecord(at, stop, entries[decoded])) {
+            ++decoded;
+        }
+        if (decoded != header.recordCount || at != stop) {
+            break;
+        }
+        for (auto& entry : entries) {
+            int id = entry.id;
+            memtable[id] = std::move(entry);
+        }
+        nextId = std::max(nextId, header.nextId);
+        pos += sizeof(header) + header.length;
+    }
+    if (pos < log.size()) {
+        std::cerr << "Warning: Dropping " << (log.size() - pos) << " damaged byte(s) at the end of '" << name << "'." << std::endl;
+        if (storeRepairAllowed() && ftruncate(fd, static_cast<off_t>(pos)) != 0) {
+            std::cerr << "Warning: Could not truncate '" << name << "'." << std::endl;
+        }
+    }
+    close(fd);
+    bytes = pos;
+    return true;
+}
+
+// --- The store ---
+
+class MergeWorker;
+
+/**
+ * \@brief The open store: manifest, runs (newest first) and memtable
+ * Used with storeMutex held: the merge thread swaps its result into the run list
+ */
+class LsmTaskStore {
+public:
+    bool open();
+    bool find(int id, Task& task) const;
+    void scan(std::vector<Task>& tasks) const;
+    bool apply(const std::vector<TaskChange>& changes, int nextId);
+    bool replaceRuns(const std::vector<std::shared_ptr<LsmRun>>& merged, uint32_t number);
+    int nextId() const { return currentNextId; }
+    uint32_t nextFileNumber() const { return manifest.nextFileNumber; }
+
+    /**
+     * \@brief Adopts a freshly written single-run store
+     */
+    void reset(const Manifest& written, std::shared_ptr<LsmRun> run) {
+        manifest = written;
+        runs.assign(1, std::move(run));
+        memtable.clear();
+        walBytes = 0;
+        currentNextId = written.nextId;
+    }
+
+private:
+    bool flush();
+    void startMerge();
+
+    Manifest manifest;
+    std::vector<std::shared_ptr<LsmRun>> runs; // Newest first
+    std::map<int, TaskChange> memtable; // Changes since the last flush, by id
+    uint64_t walBytes = 0; // Size of the current log
+    int currentNextId = 0;
+};
+
+static std::mutex storeMutex; // Guards openStore against the merge thread
+static std::unique_ptr<LsmTaskStore> openStore; // Opened by the first call that needs it
+
+/**
+ * \@brief Runs one merge at a time on a background thread
+ */
+class MergeWorker {
+public:
+    ~MergeWorker() { wait(); }
+
+    /**
+     * \@brief Whether a merge is still running
+     */
+    bool busy() const { return running.load(); }
+
+    /**
+     * \@brief Starts merging runs into a new run file (with storeMutex held)
+     * \@param inputs The runs to merge, newest first; they must include the oldest run
+     * \@param number The merged run's file number
+     */
+    void start(std::vector<std::shared_ptr<LsmRun>> inputs, uint32_t number) {
+        if (thread.joinable()) {
+            thread.join(); // Finished: running is cleared as its last step
+        }
+        running = true;
+        thread = std::thread(&MergeWorker::merge, this, std::move(inputs), number);
+    }
+
+    /**
+     * \@brief Waits for a running merge (without storeMutex held: the merge takes it to finish)
+     */
+    void wait() {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+
+private:
+    void merge(std::vector<std::shared_ptr<LsmRun>> inputs, uint32_t number);
+
+    std::thread thread;
+    std::atomic<bool> running{ false };
+};
+
+// Declared after the store, so it is destroyed (and joined) first
+static MergeWorker merger;
+
+/**
+ * \@brief Merges runs oldest to newest into one run and swaps it into the store
+ * The inputs include the oldest run, so nothing older can hold a deleted id and
+ * deletion markers are dropped. Commits and flushes go on meanwhile; they only
+ * add newer runs in front of the inputs
+ */
+void MergeWorker::merge(std::vector<std::shared_ptr<LsmRun>> inputs, uint32_t number) {
+    std::vector<TaskChange> merged;
+    bool ok = true;
+    for (auto it = inputs.rbegin(); ok && it != inputs.rend(); ++it) {
+        std::vector<TaskChange> entries;
+        ok = (*it)->readAll(entries);
+        mergeNewer(merged, std::move(entries));
+    }
+    if (ok) {
+        RunWriter writer(number);
+        for (const auto& entry : merged) {
+            if (!entry.deleted) {
+                writer.add(entry.id, &entry.task);
+            }
+        }
+        std::vector<TaskChange>().swap(merged);
+        ok = writer.finish();
+    } else {
+        std::cerr << "Warning: Could not read a run of '" << LSM_MANIFEST_FILE << "' to merge it." << std::endl;
+    }
+    {
+        std::lock_guard<std::mutex> guard(storeMutex);
+        if (ok && !(openStore && openStore->replaceRuns(inputs, number))) {
+            std::remove(lsmFileName(number, "run").c_str());
+        }
+    }
+    running = false;
+}
+
+/**
+ * \@brief Reads the manifest, opens every run and replays the log into the memtable
+ * \@return False if the manifest or a run is missing or malformed
+ */
+bool LsmTaskStore::open() {
+    if (!readManifest(manifest)) {
+        return false;
+    }
+    for (uint32_t number : manifest.runs) {
+        auto run = std::make_shared<LsmRun>(number);
+        if (!run->open()) {
+            std::cerr << "Warning: '" << lsmFileName(number, "run") << "' is missing or malformed." << std::endl;
+            return false;
+        }
+        runs.push_back(std::move(run));
+    }
+    currentNextId = manifest.nextId;
+    return replayWal(manifest.walNumber, memtable, currentNextId, walBytes);
+}
+
+/**
+ * \@brief Finds the newest state of a task: the memtable, then each run from newest to oldest
+ * \@return True if the task exists (its newest record is not a deletion marker)
+ */
+bool LsmTaskStore::find(int id, Task& task) const {
+    auto it = memtable.find(id);
+    if (it != memtable.end()) {
+        task = it->second.task;
+        return !it->second.deleted;
+    }
+    TaskChange entry;
+    for (const auto& run : runs) {
+        if (run->find(id, entry)) {
+            task = std::move(entry.task);
+            return !entry.deleted;
+        }
+    }
+    return false;
+}
+
+/**
+ * \@brief Collects every live task in id order: runs merged oldest to newest, then the memtable
+ */
+void LsmTaskStore::scan(std::vector<Task>& tasks) const {
+    std::vector<TaskChange> merged;
+    for (auto it = runs.rbegin(); it != runs.rend(); ++it) {
+        std::vector<TaskChange> entries;
+        if (!(*it)->readAll(entries)) {
+            std::cerr << "Warning: Skipping unreadable '" << lsmFileName((*it)->fileNumber(), "run") << "'." << std::endl;
+            continue;
+        }
+        mergeNewer(merged, std::move(entries));
+    }
+    std::vector<TaskChange> recent;
+    recent.reserve(memtable.size());
+    for (const auto& entry : memtable) {
+        recent.push_back(entry.second);
+    }
+    mergeNewer(merged, std::move(recent));
+
+    tasks.reserve(merged.size());
+    for (auto& entry : merged) {
+        if (!entry.deleted) {
+            tasks.push_back(std::move(entry.task));
+        }
+    }
+}
+
+/**
+ * \@brief Logs the changes, applies them to the memtable and flushes it once its log is full
+ * \@return False if the log or a flush could not be written
+ */
+bool LsmTaskStore::apply(const std::vector<TaskChange>& changes, int nextId) {
+    uint64_t bytes = 0;
+    if (!appendWal(manifest.walNumber, changes, nextId, bytes)) {
+        return false;
+    }
+    walBytes += bytes;
+    currentNextId = nextId;
+    for (const auto& change : changes) {
+        memtable[change.id] = change;
+    }
+    return walBytes < LSM_MEMTABLE_FLUSH_BYTES || flush();
+}
+
+/**
+ * \@brief Writes the memtable as the newest run and starts a new, empty log
+ * The new manifest names both, so a crash leaves either the old run list and
+ * log or the new ones; the old log is deleted afterwards
+ * \@return False if the run or the manifest could not be written
+ */
+bool LsmTaskStore::flush() {
+    uint32_t number = manifest.nextFileNumber++;
+    {
+        RunWriter writer(number);
+        for (const auto& entry : memtable) {
+            writer.add(entry.first, entry.second.deleted ? nullptr : &entry.second.task);
+        }
+        if (!writer.finish()) {
+            return false;
+        }
+    }
+    auto run = std::make_shared<LsmRun>(number);
+    Manifest next = manifest;
+    next.runs.insert(next.runs.begin(), number);
+    next.nextId = currentNextId;
+    next.walNumber = next.nextFileNumber++;
+    if (!run->open() || !writeManifest(next)) {
+        std::remove(lsmFileName(number, "run").c_str());
+        return false;
+    }
+    std::remove(lsmFileName(manifest.walNumber, "wal").c_str());
+    manifest = next;
+    runs.insert(runs.begin(), std::move(run));
+    memtable.clear();
+    walBytes = 0;
+    startMerge();
+    return true;
+}
+
+/**
+ * \@brief Starts merging every run in the background once there are too many of them
+ * Only one merge runs at a time; a later flush starts the next
+ */
+void LsmTaskStore::startMerge() {
+    if (runs.size() <= LSM_MAX_RUNS || merger.busy()) {
+        return;
+    }
+    merger.start(runs, manifest.nextFileNumber++);
+}
+
+/**
+ * \@brief Swaps a finished merge into the run list and deletes the merged runs
+ * \@param merged The merge's inputs, newest first; they are still the oldest runs
+ * \@param number The merged run's file number
+ * \@return False if the run list no longer ends with the inputs or the swap failed
+ */
+bool LsmTaskStore::replaceRuns(const std::vector<std::shared_ptr<LsmRun>>& merged, uint32_t number) {
+    if (merged.size() > runs.size() || !std::equal(merged.begin(), merged.end(), runs.end() - static_cast<std::ptrdiff_t>(merged.size()))) {
+        return false;
+    }
+    auto run = std::make_shared<LsmRun>(number);
+    if (!run->open()) {
+        return false;
+    }
+    size_t kept = runs.size() - merged.size();
+    Manifest next = manifest;
+    next.runs.resize(kept);
+    next.runs.push_back(number);
+    if (!writeManifest(next)) {
+        return false;
+    }
+    manifest = next;
+    runs.resize(kept);
+    runs.push_back(std::move(run));
+    for (const auto& old : merged) {
+        std::remove(lsmFileName(old->fileNumber(), "run").c_str()); // Open descriptors keep it readable
+    }
+    return true;
+}
+
+/**
+ * \@brief Opens the store if no call has yet (with storeMutex held)
+ * \@return The open store, or null if it is missing or malformed
+ */
+static LsmTaskStore* currentStore() {
+    if (!openStore) {
+        std::unique_ptr<LsmTaskStore> store(new LsmTaskStore());
+        if (!store->open()) {
+            return nullptr;
+        }
+        openStore = std::move(store);
+    }
+    return openStore.get();
+}
+
+// --- Public interface ---
+
+/**
+ * \@brief Loads every task by merging the runs and the memtable, newest state first
+ * \@param nextId Output parameter: the stored next-id counter
+ * \@return The live tasks in id order. Returns empty vector if the store is missing or invalid
+ */
+std::vector<Task> loadLsmTasks(int& nextId) {
+    std::vector<Task> tasks;
+    nextId = 0;
+    std::lock_guard<std::mutex> guard(storeMutex);
+    LsmTaskStore* store = currentStore();
+    if (store == nullptr) {
+        std::cerr << "Warning: '" << LSM_MANIFEST_FILE << "' is malformed or empty. Starting with empty task list." << std::endl;
+        return tasks;
+    }
+    // Counted as parsing, like tasks.db: the runs are read as the records are decoded
+    PhaseTimer parseTimer(StatsPhase::PARSE);
+    nextId = store->nextId();
+    store->scan(tasks);
+    return tasks;
+}
+
+/**
+ * \@brief Reads one task through the memtable, bloom filters and sparse indexes
+ * \@param id The ID of the task to find
+ * \@param task Output parameter: the task, if found
+ * \@return True if the store holds a live task with this id
+ */
+bool findLsmTask(int id, Task& task) {
+    std::lock_guard<std::mutex> guard(storeMutex);
+    LsmTaskStore* store = currentStore();
+    return store != nullptr && store->find(id, task);
+}
+
+/**
+ * \@brief Replaces the whole store with a single run of the given tasks and an empty log
+ * The new manifest takes effect by rename; the runs and log it replaces are deleted after
+ * \@param ordered The tasks to store, in any order
+ * \@param nextId The next-id counter to store in the manifest
+ * \@return True on success, false otherwise
+ */
+bool saveLsmTasks(std::vector<const Task*> ordered, int nextId) {
+    PhaseTimer writeTimer(StatsPhase::WRITE);
+    merger.wait();
+    std::lock_guard<std::mutex> guard(storeMutex);
+    std::sort(ordered.begin(), ordered.end(), [](const Task* a, const Task* b) { return a->id < b->id; });
+
+    Manifest old;
+    bool replacing = readManifest(old);
+    Manifest next;
+    next.nextFileNumber = std::max(old.nextFileNumber, openStore ? openStore->nextFileNumber() : 1u);
+    uint32_t number = next.nextFileNumber++;
+    {
+        RunWriter writer(number);
+        for (const Task* task : ordered) {
+            writer.add(task->id, task);
+        }
+        if (!writer.finish()) {
+            return false;
+        }
+    }
+    auto run = std::make_shared<LsmRun>(number);
+    next.runs.push_back(number);
+    next.nextId = nextId;
+    next.walNumber = next.nextFileNumber++;
+    if (!run->open() || !writeManifest(next)) {
+        std::remove(lsmFileName(number, "run").c_str());
+        return false;
+    }
+    if (replacing) {
+        for (uint32_t runNumber : old.runs) {
+            std::remove(lsmFileName(runNumber, "run").c_str());
+        }
+        std::remove(lsmFileName(old.walNumber, "wal").c_str());
+    }
+    if (!openStore) {
+        openStore.reset(new LsmTaskStore());
+    }
+    openStore->reset(next, std::move(run));
+    return true;
+}
+
+/**
+ * \@brief Appends changes to the log and the memtable, flushing it to a run when it is full
+ * \@param changes The changes to apply, in order
+ * \@param nextId The current next-id counter
+ * \@return False if the store is missing or cannot be updated (the caller should
+ * rewrite it with saveLsmTasks), true otherwise
+ */
+bool applyLsmChanges(const std::vector<TaskChange>& changes, int nextId) {
+    PhaseTimer writeTimer(StatsPhase::WRITE);
+    std::lock_guard<std::mutex> guard(storeMutex);
+    LsmTaskStore* store = currentStore();
+    return store != nullptr && store->apply(changes, nextId);
+}
+
+/**
+ * \@brief Waits for a background merge and closes the store
+ */
+void closeLsmStore() {
+    merger.wait();
+    std::lock_guard<std::mutex> guard(storeMutex);
+    openStore.reset();
+}
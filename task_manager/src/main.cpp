@@ -1,141 +1,136 @@
-#include <iostream>
-#include <vector>
-#include <string>
-#include <stdexcept>
-#include "task.h"
-#include "commands.h" // Task manipulation functions (add, update, delete, list, mark) 
-#include "storage.h" // For loadTasks and saveTasks (stubs for now)
-
-// Helper function to print usage instructions
-void printUsage(const char* progName) {
-    std::cerr << " " << std::endl;
-    std::cerr << "Usage: " << progName << " <command> [options]" << std::endl;
-    std::cerr << "Commands:" << std::endl;
-    std::cerr << " add \"<description>\"" << std::endl;
-    std::cerr << " update <id> \"<new_description>\"" << std::endl;
-    std::cerr << " delete <id>" << std::endl;
-    std::cerr << " mark-in-progress <id>" << std::endl; 
-    std::cerr << " mark-done <id>" << std::endl; 
-    std::cerr << " list [todo|in-progress|done]" << std::endl;
-}
-
-int main(int argc, char* argv[]) {
-
-    // --- Load existing tasks ---
-    std::vector<Task> tasks = loadTasks(); // Calls the load function from storage.cpp
-
-    // --- Argument Count Check ---
-    // Need at least the program name and a command
-    if (argc < 2) {
-        printUsage(argv[0]);
-        return 1;
-    }
-
-    // --- Command Extraction ---
-    std::string command = argv[1]; 
-    bool tasksModified = false; // Flag to track if saveTasks should be called 
-
-    try {
-        // --- Command Handling --- 
-        if (command == "add") {
-            if (argc != 3) {
-                std::cerr << "Error: 'add' command requires exactly one argument: \"<description>\"" << std::endl;
-                printUsage(argv[0]);
-                return 1;
-            }
-            std::string description = argv[2];
-
-            // Check if the description contains at least one non-whitespace character
-            // std::string::npos is returned if no character matches the condition
-            if (description.find_first_not_of(" \t\n\r\f\v") == std::string::npos) {
-                std::cerr << "Error: Task description cannot be empty or whitespace only." << std::endl;
-                return 1;
-            }
-            addTask(tasks, description);
-            tasksModified = true;
-        } else if (command == "update") {
-            if (argc != 4) {
-                std::cerr << "Error: 'update' command requires two arguments: <id> \"<new_description>\"" << std::endl;
-                printUsage(argv[0]);
-                return 1;
-            }
-            // Convert ID argument from string to integer
-            int id = std::stoi(argv[2]);
-            std::string newDescription = argv[3];
-            // Check if the description contains at least one non-whitespace character
-            // std::string::npos is returned if no character matches the condition
-            if (newDescription.find_first_not_of(" \t\n\r\f\v") == std::string::npos) {
-                std::cerr << "Error: New task description cannot be empty or whitespace only." << std::endl;
-                return 1;
-            }
-            if (updateTask(tasks, id, newDescription)) {
-                tasksModified = true;
-            }
-        } else if (command == "delete") {
-            if (argc != 3) {
-                std::cerr << "Error: 'delete' command requires exactly one argument: <id>" << std::endl; 
-                printUsage(argv[0]);
-                return 1;
-            }
-            int id = std::stoi(argv[2]);
-            if (deleteTask(tasks, id)) {
-                tasksModified = true;
-            }
-        } else if (command == "mark-in-progress") {
-            if (argc != 3) {
-                std::cerr << "Error: 'mark-in-progress' command requires exactly one argument: <id>" << std::endl; 
-                printUsage(argv[0]);
-                return 1; 
-            }
-            int id = std::stoi(argv[2]);
-            if (markTaskStatus(tasks, id, TaskStatus::IN_PROGRESS)) {
-                tasksModified = true;
-            }
-        } else if (command == "mark-done") {
-            if (argc != 3) {
-                std::cerr << "Error: 'mark-done' command requires exactly one argument: <id>" << std::endl;
-                printUsage(argv[0]);
-                return 1; 
-            }
-            int id = std::stoi(argv[2]);
-            if (markTaskStatus(tasks, id, TaskStatus::DONE)) {
-                tasksModified = true;
-            }
-        } else if (command == "list") {
-            std::string filterStatus = ""; // Default to list all 
-            if (argc == 3) {
-                filterStatus = argv[2];
-                if (filterStatus != "todo" && filterStatus != "in-progress" && filterStatus != "done") {
-                    std::cerr << "Error: Invalid status filter. Use 'todo', 'in-progress', or 'done'." << std::endl;
-                    printUsage(argv[0]);
-                    return 1;
-                }
-            } else if (argc > 3) {
-                std::cerr << "Error: 'list' command takes at most one optional argument: [todo|in-progress|done]" << std::endl;
-                printUsage(argv[0]);
-                return 1;
-            }
-            listTasks(tasks, filterStatus);
-        } else {
-            std::cerr << "Error: Unknown command '" << command << "'" << std::endl;
-            printUsage(argv[0]);
-            return 1;
-        }
-    } catch (const std::invalid_argument& e) {
-        std::cerr << "Error: Invalid task ID provided. ID must be a number." << std::endl;
-        return 1;
-    } catch (const std::out_of_range&e) {
-        std::cerr << "Error: Task ID provided is too large." << std::endl;
-        return 1; 
-    } catch (const std::exception& e) {
-        std::cerr << "Error: An unexpected error occurred: " << e.what() << std::endl;
-        return 1;
-    }
-
-    // --- Save tasks if modified ---
-    if (tasksModified) {
-        saveTasks(tasks); // Calls the save function from storage.cpp
-    }
-
-    return 0; // Indicate success
-}
\ No newline at end of file
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <string>
+#include "task.h"
+#include "cli.h" // For executeCommand, runBatch, printUsage
+#include "daemon.h" // For runDaemon, daemonRunning and forwardToDaemon
+#include "storage.h" // For loadTasks, commitTasks and the store lock
+#include "task_list.h" // For TaskList
+#include "stats.h" // For --stats
+#include <chrono>
+
+/**
+ * \@brief Runs one task-cli invocation: serve, batch, or a single command
+ * \@param args The command and its arguments (global options already removed)
+ * \@param progName The program name, for usage messages
+ * \@return The process exit code
+ */
+static int runCli(const std::vector<std::string>& args, const char* progName) {
+    // --- Argument Count Check ---
+    // Need at least a command
+    if (args.empty()) {
+        printUsage(progName);
+        return 1;
+    }
+
+    // --- Daemon mode: load once, then serve commands until stopped ---
+    if (args[0] == "serve") {
+        if (args.size() != 1) {
+            std::cerr << "Error: 'serve' command takes no arguments." << std::endl;
+            printUsage(progName);
+            return 1;
+        }
+        // A running daemon holds the lock below, so report it now instead of timing out on it
+        if (daemonRunning()) {
+            std::cerr << "Error: A daemon is already listening on 'tasks.sock'." << std::endl;
+            return 1;
+        }
+        // Held for the daemon's lifetime: nothing may change the store behind its back
+        if (!lockTaskStore(StoreLockMode::EXCLUSIVE)) {
+            return 1;
+        }
+        TaskList tasks = loadTasks();
+        setStatsTaskCount(tasks.size());
+        return runDaemon(tasks, progName);
+    }
+
+    // --- Batch input is read up front so it can be forwarded to a daemon ---
+    bool isBatch = args[0] == "batch";
+    std::string batchInput;
+    if (isBatch) {
+        if (args.size() > 2) {
+            std::cerr << "Error: 'batch' command takes at most one optional argument: [file]" << std::endl;
+            printUsage(progName);
+            return 1;
+        }
+        std::ostringstream script;
+        if (args.size() == 2 && args[1] != "-") {
+            std::ifstream input(args[1]);
+            if (!input.is_open()) {
+                std::cerr << "Error: Could not open '" << args[1] << "' for reading." << std::endl;
+                return 1;
+            }
+            script << input.rdbuf();
+        } else {
+            script << std::cin.rdbuf();
+        }
+        batchInput = script.str();
+    }
+
+    // --- Let a running daemon handle the command, if there is one ---
+    int exitCode = 0;
+    if (forwardToDaemon(args, batchInput, exitCode)) {
+        return exitCode;
+    }
+
+    // --- Lock the store from load through commit ---
+    // Only 'list', 'search' and 'export' leave the tasks alone; everything else may write
+    bool readOnly = args[0] == "list" || args[0] == "search" || args[0] == "export";
+    StoreLockMode lockMode = readOnly ? StoreLockMode::SHARED : StoreLockMode::EXCLUSIVE;
+    if (!lockTaskStore(lockMode)) {
+        return 1;
+    }
+
+    // --- Load existing tasks ---
+    // An export may go to stdout, which must then hold nothing but the records
+    setLoadMessages(args[0] != "export");
+    TaskList tasks = loadTasks(); // Calls the load function from storage.cpp
+
+    // --- Batch mode: many commands, one load, one save ---
+    if (isBatch) {
+        std::istringstream input(batchInput);
+        exitCode = runBatch(tasks, input, progName);
+        setStatsTaskCount(tasks.size());
+        return exitCode;
+    }
+
+    // --- Single command ---
+    CommandResult result;
+    {
+        PhaseTimer commandTimer(StatsPhase::COMMAND);
+        result = executeCommand(tasks, args, progName);
+    }
+    setStatsTaskCount(tasks.size());
+
+    // --- Save tasks if modified ---
+    if (result.modified && !commitTasks(tasks)) { // Appends the changes to the mutation log in storage.cpp
+        std::cerr << "Error: The changes could not be saved." << std::endl;
+        return 1;
+    }
+
+    return result.exitCode; // 0 indicates success
+}
+
+int main(int argc, char* argv[]) {
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::string> args(argv + 1, argv + argc);
+
+    // --- Global options come before the command ---
+    bool stats = !args.empty() && args[0] == "--stats";
+    if (stats) {
+        args.erase(args.begin());
+        enableAllocationCounting();
+    }
+
+    int exitCode = runCli(args, argv[0]);
+    unlockTaskStore(); // Also waits for a background merge of the lsm store
+
+    // A forwarded command is timed here only from the client side; the daemon did the work
+    if (stats) {
+        std::cout.flush();
+        printStats(std::cerr, std::chrono::steady_clock::now() - start);
+    }
+    return exitCode;
+}
@@ -0,0 +1,665 @@
+#include "query.h"
+#include "task.h" // For TaskStatus, stringToStatus
+#include "utils.h" // For parseTimestamp
+#include "search_index.h" // For SearchIndex::tokenize and containsAll
+#include "time_index.h" // For TimeIndex::keyOf, TimeField
+#include <vector>
+#include <string>
+#include <chrono>
+#include <limits> // For std::numeric_limits
+#include <algorithm> // For std::sort, std::unique, std::max, std::min
+
+// Open ends of a comparison's interval (id < 5 is [KEY_MIN, 5))
+const long long KEY_MIN = std::numeric_limits<long long>::min();
+const long long KEY_MAX = std::numeric_limits<long long>::max();
+
+// Longest relative age a time value may give (100 years), well inside the clock's range
+const long long MAX_AGE_SECONDS = 100LL * 366 * 24 * 3600;
+
+/**
+ * \@brief Lowercases ASCII letters (keywords and field names are case-insensitive)
+ */
+static std::string lowercase(std::string text) {
+    for (char& c : text) {
+        if (c >= 'A' && c <= 'Z') {
+            c = static_cast<char>(c - 'A' + 'a');
+        }
+    }
+    return text;
+}
+
+// --- Parsing ---
+
+/**
+ * \@brief The error for a value parseTimeRange rejects
+ */
+static std::string invalidTimeMessage(const std::string& value) {
+    return "Invalid time '" + value + "'. Use YYYY-MM-DD, \"YYYY-MM-DD HH:MM:SS\" or an age such as 24h or 7d.";
+}
+
+/**
+ * \@brief Parses a time value into the keys it covers
+ * A date covers the whole (local) day, a timestamp one second, and a relative
+ * age such as 30m, 24h, 7d or 2w the instant that long before now
+ * \@param value The time as written
+ * \@param low Output parameter: first key covered
+ * \@param high Output parameter: one past the last key covered
+ * \@return True if the value is a valid time
+ */
+static bool parseTimeRange(const std::string& value, long long& low, long long& high) {
+    std::chrono::system_clock::time_point first;
+    std::chrono::system_clock::time_point last;
+    size_t digits = value.find_first_not_of("0123456789");
+    if (digits > 0 && digits <= 6 && digits + 1 == value.size()) {
+        long long seconds = std::stoll(value.substr(0, digits));
+        switch (value[digits]) {
+            case 'w': seconds *= 7; // Fall through
+            case 'd': seconds *= 24; // Fall through
+            case 'h': seconds *= 60; // Fall through
+            case 'm': seconds *= 60; // Fall through
+            case 's': break;
+            default: return false;
+        }
+        if (seconds > MAX_AGE_SECONDS) {
+            return false;
+        }
+        low = TimeIndex::keyOf(std::chrono::system_clock::now() - std::chrono::seconds(seconds));
+        high = low + 1; // An instant, so --until 1h stops exactly an hour ago
+        return true;
+    } else if (value.size() == 10) {
+        std::string day = value + " 00:00:00";
+        std::string lastSecond = value + " 23:59:59";
+        if (!parseTimestamp(day.data(), day.size(), first) ||
+            !parseTimestamp(lastSecond.data(), lastSecond.size(), last)) {
+            return false;
+        }
+    } else if (value.size() == TIMESTAMP_LENGTH) {
+        if (!parseTimestamp(value.data(), value.size(), first)) {
+            return false;
+        }
+        last = first;
+    } else {
+        return false;
+    }
+    low = TimeIndex::keyOf(first);
+    high = TimeIndex::keyOf(last + std::chrono::seconds(1));
+    return true;
+}
+
+/**
+ * \@brief Recursive-descent parser from expression text to the query's node list
+ */
+class TaskQuery::Parser {
+public:
+    Parser(const std::string& text, std::vector<Node>& nodes, std::string& error)
+        : text(text), nodes(nodes), error(error) {}
+
+    /**
+     * \@brief Parses the whole text
+     * \@return True on success (the root is the last node)
+     */
+    bool parse() {
+        next();
+        size_t root = 0;
+        if (!parseOr(root)) {
+            return false;
+        }
+        if (token.type != TokenType::END) {
+            return fail("Unexpected '" + token.text + "' in --where expression.");
+        }
+        return true;
+    }
+
+private:
+    enum class TokenType { WORD, STRING, OPERATOR, LPAREN, RPAREN, END };
+
+    struct Token {
+        TokenType type;
+        std::string text;
+    };
+
+    bool fail(const std::string& message) {
+        if (error.empty()) {
+            error = message;
+        }
+        return false;
+    }
+
+    static bool isOperatorChar(char c) {
+        return c == '=' || c == '!' || c == '<' || c == '>' || c == '~';
+    }
+
+    /**
+     * \@brief Reads the next token into token; a lexical error becomes an END token and sets error
+     */
+    void next() {
+        while (pos < text.size() && (text[pos] == ' ' || text[pos] == '\t')) {
+            ++pos;
+        }
+        token.text.clear();
+        if (pos >= text.size()) {
+            token.type = TokenType::END;
+            return;
+        }
+        char c = text[pos];
+        if (c == '(' || c == ')') {
+            token.type = c == '(' ? TokenType::LPAREN : TokenType::RPAREN;
+            token.text = c;
+            ++pos;
+        } else if (c == '"') {
+            token.type = TokenType::STRING;
+            ++pos;
+            while (pos < text.size() && text[pos] != '"') {
+                if (text[pos] == '\\' && pos + 1 < text.size()) {
+                    ++pos; // \" and \\ stand for the character itself
+                }
+                token.text += text[pos++];
+            }
+            if (pos >= text.size()) {
+                fail("Unterminated quoted string in --where expression.");
+                token.type = TokenType::END;
+                return;
+            }
+            ++pos;
+        } else if (isOperatorChar(c)) {
+            token.type = TokenType::OPERATOR;
+            while (pos < text.size() && isOperatorChar(text[pos])) {
+                token.text += text[pos++];
+            }
+        } else {
+            token.type = TokenType::WORD;
+            while (pos < text.size() && text[pos] != ' ' && text[pos] != '\t' && text[pos] != '(' &&
+                   text[pos] != ')' && text[pos] != '"' && !isOperatorChar(text[pos])) {
+                token.text += text[pos++];
+            }
+        }
+    }
+
+    bool isKeyword(const char* keyword) const {
+        return token.type == TokenType::WORD && lowercase(token.text) == keyword;
+    }
+
+    /**
+     * \@brief Appends an AND/OR node over the operands, or returns the only operand
+     */
+    size_t combine(NodeKind kind, std::vector<size_t>& operands) {
+        if (operands.size() == 1) {
+            return operands[0];
+        }
+        Node node(kind);
+        node.children.swap(operands);
+        nodes.push_back(std::move(node));
+        return nodes.size() - 1;
+    }
+
+    bool parseOr(size_t& result) {
+        std::vector<size_t> operands(1);
+        if (!parseAnd(operands[0])) {
+            return false;
+        }
+        while (isKeyword("or")) {
+            next();
+            operands.push_back(0);
+            if (!parseAnd(operands.back())) {
+                return false;
+            }
+        }
+        result = combine(NodeKind::OR, operands);
+        return true;
+    }
+
+    bool parseAnd(size_t& result) {
+        std::vector<size_t> operands(1);
+        if (!parseFactor(operands[0])) {
+            return false;
+        }
+        while (isKeyword("and")) {
+            next();
+            operands.push_back(0);
+            if (!parseFactor(operands.back())) {
+                return false;
+            }
+        }
+        result = combine(NodeKind::AND, operands);
+        return true;
+    }
+
+    bool parseFactor(size_t& result) {
+        if (isKeyword("not")) {
+            next();
+            size_t operand = 0;
+            if (!parseFactor(operand)) {
+                return false;
+            }
+            Node node(NodeKind::NOT);
+            node.children.push_back(operand);
+            nodes.push_back(std::move(node));
+            result = nodes.size() - 1;
+            return true;
+        }
+        if (token.type == TokenType::LPAREN) {
+            next();
+            if (!parseOr(result)) {
+                return false;
+            }
+            if (token.type != TokenType::RPAREN) {
+                return fail("Missing ')' in --where expression.");
+            }
+            next();
+            return true;
+        }
+        return parseComparison(result);
+    }
+
+    bool parseComparison(size_t& result) {
+        if (token.type != TokenType::WORD) {
+            return fail(token.type == TokenType::END ? "Incomplete --where expression."
+                                                     : "Expected a field name before '" + token.text + "'.");
+        }
+        std::string field = lowercase(token.text);
+        next();
+        if (token.type != TokenType::OPERATOR) {
+            return fail("Expected an operator (= != < <= > >= ~) after '" + field + "'.");
+        }
+        std::string op = token.text == "==" ? "=" : token.text;
+        next();
+        if (token.type != TokenType::WORD && token.type != TokenType::STRING) {
+            return fail("Expected a value after '" + field + " " + op + "'.");
+        }
+        std::string value = token.text;
+        next();
+
+        if (field == "desc" || field == "description") {
+            if (op != "~") {
+                return fail("'" + field + "' only supports '~' (contains every word).");
+            }
+            Node node(NodeKind::TEXT);
+            node.text = value;
+            SearchIndex::tokenize(value, node.terms);
+            if (node.terms.empty()) {
+                return fail("'" + field + "~' needs at least one letter or digit.");
+            }
+            nodes.push_back(std::move(node));
+            result = nodes.size() - 1;
+            return true;
+        }
+        if (op == "~") {
+            return fail("'~' only applies to desc.");
+        }
+
+        // Every other comparison is "key in [low, high)", where [low, high) is the
+        // set of keys the value stands for (one id, one status, a second or a day)
+        long long low = 0;
+        long long high = 0;
+        NodeKind kind;
+        if (field == "status") {
+            if (value != "todo" && value != "in-progress" && value != "done") {
+                return fail("Invalid status '" + value + "'. Use 'todo', 'in-progress', or 'done'.");
+            }
+            if (op != "=" && op != "!=") {
+                return fail("'status' only supports '=' and '!='.");
+            }
+            kind = NodeKind::STATUS;
+            low = static_cast<long long>(stringToStatus(value));
+            high = low + 1;
+        } else if (field == "id") {
+            if (value.empty() || value.size() > 10 || value.find_first_not_of("0123456789") != std::string::npos) {
+                return fail("Invalid task ID '" + value + "' in --where expression.");
+            }
+            kind = NodeKind::ID;
+            low = std::stoll(value);
+            high = low + 1;
+        } else if (field == "created" || field == "createdat" || field == "updated" || field == "updatedat") {
+            kind = field[0] == 'c' ? NodeKind::CREATED : NodeKind::UPDATED;
+            if (!parseTimeRange(value, low, high)) {
+                return fail(invalidTimeMessage(value));
+            }
+        } else {
+            return fail("Unknown field '" + field + "'. Use status, id, created, updated or desc.");
+        }
+
+        Node node(kind);
+        if (op == "=") {
+            node.low = low;
+            node.high = high;
+        } else if (op == "!=") {
+            node.low = low;
+            node.high = high;
+            node.negated = true;
+        } else if (op == "<") {
+            node.low = KEY_MIN;
+            node.high = low;
+        } else if (op == "<=") {
+            node.low = KEY_MIN;
+            node.high = high;
+        } else if (op == ">") {
+            node.low = high;
+            node.high = KEY_MAX;
+        } else if (op == ">=") {
+            node.low = low;
+            node.high = KEY_MAX;
+        } else {
+            return fail("Unknown operator '" + op + "'. Use = != < <= > >= or ~.");
+        }
+        nodes.push_back(std::move(node));
+        result = nodes.size() - 1;
+        return true;
+    }
+
+    const std::string& text;
+    std::vector<Node>& nodes;
+    std::string& error;
+    size_t pos = 0;
+    Token token;
+};
+
+/**
+ * \@brief Parses an expression
+ * \@param text The expression
+ * \@param query Output parameter: the compiled query
+ * \@param error Output parameter: what was wrong, if parsing fails
+ * \@return True on success
+ */
+bool TaskQuery::compile(const std::string& text, TaskQuery& query, std::string& error) {
+    query.nodes.clear();
+    error.clear();
+    Parser parser(text, query.nodes, error);
+    if (!parser.parse()) {
+        query.nodes.clear();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * \@brief Narrows the query to tasks with a timestamp at or after (or at or before) a time
+ * The bound is ANDed with whatever the query already holds
+ * \@param field The timestamp to bound
+ * \@param lower True for "at or after value", false for "at or before value"
+ * \@param value The time (as in a --where comparison)
+ * \@param error Output parameter: what was wrong, if the time is invalid
+ * \@return True on success
+ */
+bool TaskQuery::addTimeBound(TimeField field, bool lower, const std::string& value, std::string& error) {
+    long long low = 0;
+    long long high = 0;
+    if (!parseTimeRange(value, low, high)) {
+        error = invalidTimeMessage(value);
+        return false;
+    }
+    Node bound(field == TimeField::CREATED ? NodeKind::CREATED : NodeKind::UPDATED);
+    bound.low = lower ? low : KEY_MIN;
+    bound.high = lower ? KEY_MAX : high;
+    bool hadRoot = !nodes.empty();
+    nodes.push_back(std::move(bound));
+    if (hadRoot) {
+        Node both(NodeKind::AND);
+        both.children.push_back(nodes.size() - 2);
+        both.children.push_back(nodes.size() - 1);
+        nodes.push_back(std::move(both));
+    }
+    return true;
+}
+
+// --- Evaluation ---
+
+/**
+ * \@brief The time index a CREATED or UPDATED node ranges over
+ */
+TimeField TaskQuery::timeField(NodeKind kind) {
+    return kind == NodeKind::CREATED ? TimeField::CREATED : TimeField::UPDATED;
+}
+
+/**
+ * \@brief Works out whether an index can produce a node's rows, and how many at most
+ * Status counts and id ranges are known in O(1), the search index answers in
+ * O(terms) and the time indexes in O(log N), but only once they are built; until
+ * then their operands are indexed with an unknown estimate. AND takes its most
+ * selective estimated operand, or an unestimated one if it has nothing else;
+ * OR needs all of them. Negations are only ever checked row by row
+ */
+template <typename Tasks>
+TaskQuery::Access TaskQuery::plan(Tasks& tasks, size_t index) const {
+    const Node& node = nodes[index];
+    Access access = { false, true, 0, 0 };
+    switch (node.kind) {
+        case NodeKind::STATUS:
+            access.indexed = true;
+            for (size_t status = 0; status < TASK_STATUS_COUNT; ++status) {
+                long long key = static_cast<long long>(status);
+                if ((key >= node.low && key < node.high) != node.negated) {
+                    access.estimate += tasks.countWithStatus(static_cast<TaskStatus>(status));
+                }
+            }
+            break;
+        case NodeKind::ID:
+            if (!node.negated) {
+                // Only ids below the next-id counter can exist
+                long long first = std::max(node.low, 1LL);
+                long long last = std::min(node.high, static_cast<long long>(tasks.nextId()));
+                access.indexed = true;
+                access.estimate = last > first ? static_cast<size_t>(last - first) : 0;
+            }
+            break;
+        case NodeKind::TEXT:
+            access.indexed = true;
+            access.estimated = tasks.hasSearchIndex();
+            if (access.estimated) {
+                access.estimate = tasks.searchEstimate(node.text);
+            }
+            break;
+        case NodeKind::CREATED:
+        case NodeKind::UPDATED:
+            if (!node.negated) {
+                access.indexed = true;
+                access.estimated = tasks.hasTimeIndexes();
+                if (access.estimated) {
+                    access.estimate = tasks.timeRangeEstimate(timeField(node.kind), node.low, node.high);
+                }
+            }
+            break;
+        case NodeKind::AND:
+            for (size_t child : node.children) {
+                Access operand = plan(tasks, child);
+                if (!operand.indexed) {
+                    continue;
+                }
+                // An estimated operand beats an unestimated one; among estimated ones, the smallest wins
+                bool better = !access.indexed ||
+                              (operand.estimated && (!access.estimated || operand.estimate < access.estimate));
+                if (better) {
+                    access = operand;
+                    access.child = child;
+                }
+            }
+            break;
+        case NodeKind::OR:
+            access.indexed = true;
+            for (size_t child : node.children) {
+                Access operand = plan(tasks, child);
+                if (!operand.indexed) {
+                    access.indexed = false;
+                    break;
+                }
+                access.estimated = access.estimated && operand.estimated;
+                access.estimate += operand.estimate;
+            }
+            break;
+        default:
+            break; // NOT: scan only
+    }
+    return access;
+}
+
+/**
+ * \@brief Builds the indexes an indexed node's plan needs, and no others
+ * Follows the operand AND picks and every operand of OR
+ */
+template <typename Tasks>
+void TaskQuery::buildIndexes(Tasks& tasks, size_t index) const {
+    const Node& node = nodes[index];
+    switch (node.kind) {
+        case NodeKind::TEXT:
+            tasks.searchEstimate(node.text); // Builds the search index on first use
+            break;
+        case NodeKind::CREATED:
+        case NodeKind::UPDATED:
+            tasks.timeRangeEstimate(timeField(node.kind), node.low, node.high); // Builds the time indexes
+            break;
+        case NodeKind::AND:
+            buildIndexes(tasks, plan(tasks, index).child);
+            break;
+        case NodeKind::OR:
+            for (size_t child : node.children) {
+                buildIndexes(tasks, child);
+            }
+            break;
+        default:
+            break; // Status bitmaps and the id index always exist
+    }
+}
+
+/**
+ * \@brief Collects the rows an indexed node yields (unordered, possibly with duplicates)
+ * Every row belongs to a live task; the rows are a superset of the node's matches
+ */
+template <typename Tasks>
+void TaskQuery::indexRows(Tasks& tasks, size_t index, std::vector<size_t>& rows) const {
+    const Node& node = nodes[index];
+    size_t row = 0;
+    switch (node.kind) {
+        case NodeKind::STATUS:
+            for (size_t status = 0; status < TASK_STATUS_COUNT; ++status) {
+                long long key = static_cast<long long>(status);
+                if ((key >= node.low && key < node.high) != node.negated) {
+                    std::vector<size_t> matching = tasks.rowsWithStatus(static_cast<TaskStatus>(status));
+                    rows.insert(rows.end(), matching.begin(), matching.end());
+                }
+            }
+            break;
+        case NodeKind::ID: {
+            long long first = std::max(node.low, 1LL);
+            long long last = std::min(node.high, static_cast<long long>(tasks.nextId()));
+            for (long long id = first; id < last; ++id) {
+                if (tasks.findRow(static_cast<int>(id), row)) {
+                    rows.push_back(row);
+                }
+            }
+            break;
+        }
+        case NodeKind::TEXT:
+            for (int id : tasks.search(node.text)) {
+                if (tasks.findRow(id, row)) {
+                    rows.push_back(row);
+                }
+            }
+            break;
+        case NodeKind::CREATED:
+        case NodeKind::UPDATED: {
+            std::vector<size_t> inRange = tasks.rowsInTimeRange(timeField(node.kind), node.low, node.high);
+            rows.insert(rows.end(), inRange.begin(), inRange.end());
+            break;
+        }
+        case NodeKind::AND:
+            indexRows(tasks, plan(tasks, index).child, rows);
+            break;
+        case NodeKind::OR:
+            for (size_t child : node.children) {
+                indexRows(tasks, child, rows);
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+ * \@brief Checks one live row against a node
+ */
+template <typename Tasks>
+bool TaskQuery::matches(const Tasks& tasks, size_t index, size_t row) const {
+    const Node& node = nodes[index];
+    long long key = 0;
+    switch (node.kind) {
+        case NodeKind::AND:
+            for (size_t child : node.children) {
+                if (!matches(tasks, child, row)) {
+                    return false;
+                }
+            }
+            return true;
+        case NodeKind::OR:
+            for (size_t child : node.children) {
+                if (matches(tasks, child, row)) {
+                    return true;
+                }
+            }
+            return false;
+        case NodeKind::NOT:
+            return !matches(tasks, node.children[0], row);
+        case NodeKind::TEXT: {
+            TextRef description = tasks.descriptionAt(row);
+            return SearchIndex::containsAll(description.data, description.size, node.terms);
+        }
+        case NodeKind::STATUS:
+            key = static_cast<long long>(tasks.statusAt(row));
+            break;
+        case NodeKind::ID:
+            key = tasks.idAt(row);
+            break;
+        case NodeKind::CREATED:
+            key = TimeIndex::keyOf(tasks.createdAtRow(row));
+            break;
+        case NodeKind::UPDATED:
+            key = TimeIndex::keyOf(tasks.updatedAtRow(row));
+            break;
+    }
+    return (key >= node.low && key < node.high) != node.negated;
+}
+
+/**
+ * \@brief Finds the rows of the live tasks the query matches
+ * If some index yields fewer rows than the list holds, only its rows are checked
+ * against the whole expression; otherwise every live row is. An index the plan
+ * picks but that is not built yet is built first, then the plan is made again
+ * \@param tasks The tasks to query (the index the plan picks may be built on first use)
+ * \@return Row numbers, in insertion order
+ */
+template <typename Tasks>
+std::vector<size_t> TaskQuery::select(Tasks& tasks) const {
+    if (nodes.empty()) {
+        return tasks.liveRows();
+    }
+    size_t root = nodes.size() - 1;
+    std::vector<size_t> rows;
+    Access access = plan(tasks, root);
+    if (access.indexed && !access.estimated) {
+        buildIndexes(tasks, root);
+        access = plan(tasks, root);
+    }
+    if (access.indexed && access.estimate < tasks.size()) {
+        rows.reserve(access.estimate);
+        indexRows(tasks, root, rows);
+        std::sort(rows.begin(), rows.end());
+        rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+        size_t kept = 0;
+        for (size_t row : rows) {
+            if (matches(tasks, root, row)) {
+                rows[kept++] = row;
+            }
+        }
+        rows.resize(kept);
+        return rows;
+    }
+
+    for (size_t row = 0; row < tasks.slotCount(); ++row) {
+        if (tasks.isLive(row) && matches(tasks, root, row)) {
+            rows.push_back(row);
+        }
+    }
+    return rows;
+}
+
+// --- Instantiations for both task representations ---
+template std::vector<size_t> TaskQuery::select<TaskList>(TaskList&) const;
+template std::vector<size_t> TaskQuery::select<TaskTable>(TaskTable&) const;
@@ -0,0 +1,185 @@
+#include "search_index.h"
+#include <vector>
+#include <string>
+#include <algorithm> // For std::sort, std::unique, std::lower_bound, std::min
+
+/**
+ * \@brief Checks whether a byte belongs to a term (ASCII letter/digit, or any non-ASCII byte)
+ */
+static bool isTermByte(unsigned char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c >= 0x80;
+}
+
+/**
+ * \@brief Splits text into its distinct, lowercased terms
+ * \@param text The text to split
+ * \@param terms Output parameter: the terms, sorted and without duplicates
+ */
+void SearchIndex::tokenize(const std::string& text, std::vector<std::string>& terms) {
+    terms.clear();
+    size_t i = 0;
+    while (i < text.size()) {
+        while (i < text.size() && !isTermByte(static_cast<unsigned char>(text[i]))) {
+            ++i;
+        }
+        size_t start = i;
+        while (i < text.size() && isTermByte(static_cast<unsigned char>(text[i]))) {
+            ++i;
+        }
+        if (i > start) {
+            std::string term(text, start, i - start);
+            for (char& c : term) {
+                if (c >= 'A' && c <= 'Z') {
+                    c = static_cast<char>(c - 'A' + 'a');
+                }
+            }
+            terms.push_back(std::move(term));
+        }
+    }
+    std::sort(terms.begin(), terms.end());
+    terms.erase(std::unique(terms.begin(), terms.end()), terms.end());
+}
+
+/**
+ * \@brief Indexes a task's description
+ * New tasks get the highest id so far, so their postings are almost always appends
+ * \@param id The task's ID (must not be indexed yet)
+ * \@param description The description to index
+ */
+void SearchIndex::add(int id, const std::string& description) {
+    tokenize(description, scratchTerms);
+    for (const auto& term : scratchTerms) {
+        std::vector<int>& ids = postings[term];
+        if (ids.empty() || ids.back() < id) {
+            ids.push_back(id);
+        } else {
+            auto it = std::lower_bound(ids.begin(), ids.end(), id);
+            if (it == ids.end() || *it != id) {
+                ids.insert(it, id);
+            }
+        }
+    }
+}
+
+/**
+ * \@brief Removes a task's postings
+ * \@param id The task's ID
+ * \@param description The description it was indexed with
+ */
+void SearchIndex::remove(int id, const std::string& description) {
+    tokenize(description, scratchTerms);
+    for (const auto& term : scratchTerms) {
+        auto entry = postings.find(term);
+        if (entry == postings.end()) {
+            continue;
+        }
+        std::vector<int>& ids = entry->second;
+        auto it = std::lower_bound(ids.begin(), ids.end(), id);
+        if (it != ids.end() && *it == id) {
+            ids.erase(it);
+        }
+        if (ids.empty()) {
+            postings.erase(entry); // Keep the term table free of dead words
+        }
+    }
+}
+
+/**
+ * \@brief Upper bound on the number of matches of a query, in O(terms)
+ * Lets a caller compare the index against other ways of narrowing a query
+ * before paying for the intersection
+ * \@param query The search text
+ * \@return Length of the shortest posting list among the query's terms (0 if one is absent)
+ */
+size_t SearchIndex::estimate(const std::string& query) const {
+    std::vector<std::string> terms;
+    tokenize(query, terms);
+    size_t shortest = 0;
+    for (size_t i = 0; i < terms.size(); ++i) {
+        auto entry = postings.find(terms[i]);
+        if (entry == postings.end()) {
+            return 0;
+        }
+        shortest = i == 0 ? entry->second.size() : std::min(shortest, entry->second.size());
+    }
+    return shortest;
+}
+
+/**
+ * \@brief Checks one text for every term without the index (same word rules as search)
+ * Walks the words of the text once, lowercasing each into a reused buffer
+ * \@param data The text to check
+ * \@param size Length of the text
+ * \@param terms Tokenized query terms (sorted, as produced by tokenize)
+ * \@return True if the text contains each term as a whole word
+ */
+bool SearchIndex::containsAll(const char* data, size_t size, const std::vector<std::string>& terms) {
+    std::vector<bool> found(terms.size(), false);
+    size_t remaining = terms.size();
+    std::string word;
+    size_t i = 0;
+    while (i < size && remaining > 0) {
+        while (i < size && !isTermByte(static_cast<unsigned char>(data[i]))) {
+            ++i;
+        }
+        word.clear();
+        while (i < size && isTermByte(static_cast<unsigned char>(data[i]))) {
+            char c = data[i++];
+            word += (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+        }
+        auto it = std::lower_bound(terms.begin(), terms.end(), word);
+        if (!word.empty() && it != terms.end() && *it == word) {
+            size_t index = static_cast<size_t>(it - terms.begin());
+            if (!found[index]) {
+                found[index] = true;
+                --remaining;
+            }
+        }
+    }
+    return remaining == 0;
+}
+
+/**
+ * \@brief Finds the tasks containing all of the given terms
+ * Starts from the shortest posting list and narrows it with binary searches
+ * into the others, so a rare term keeps the whole query cheap
+ * \@param query The search text (tokenized the same way as descriptions)
+ * \@return Matching task ids in ascending order (empty if the query has no terms)
+ */
+std::vector<int> SearchIndex::search(const std::string& query) const {
+    std::vector<std::string> terms;
+    tokenize(query, terms);
+
+    std::vector<const std::vector<int>*> lists;
+    lists.reserve(terms.size());
+    for (const auto& term : terms) {
+        auto entry = postings.find(term);
+        if (entry == postings.end()) {
+            return std::vector<int>(); // A term no task contains: nothing can match
+        }
+        lists.push_back(&entry->second);
+    }
+    if (lists.empty()) {
+        return std::vector<int>();
+    }
+    std::sort(lists.begin(), lists.end(),
+              [](const std::vector<int>* a, const std::vector<int>* b) { return a->size() < b->size(); });
+
+    std::vector<int> matches(*lists[0]);
+    for (size_t i = 1; i < lists.size() && !matches.empty(); ++i) {
+        const std::vector<int>& ids = *lists[i];
+        auto from = ids.begin();
+        size_t kept = 0;
+        for (int id : matches) {
+            from = std::lower_bound(from, ids.end(), id); // Both lists ascend, so never look back
+            if (from == ids.end()) {
+                break;
+            }
+            if (*from == id) {
+                matches[kept++] = id;
+            }
+        }
+        matches.resize(kept);
+    }
+    return matches;
+}
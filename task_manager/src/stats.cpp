@@ -0,0 +1,148 @@
+#include "stats.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio> // For std::snprintf
+#include <cstdlib> // For std::malloc, std::free
+#include <new> // For std::bad_alloc, std::nothrow_t
+#include <ostream>
+
+// Phase totals in steady_clock ticks; atomic so any thread may add to them
+static std::atomic<int64_t> phaseTicks[static_cast<size_t>(StatsPhase::PHASE_COUNT)];
+static std::atomic<uint64_t> bytesRead(0);
+static std::atomic<uint64_t> bytesWritten(0);
+static size_t taskCount = 0;
+
+// Updated by the replacement operator new; relaxed ordering is enough for counters
+static bool countAllocations = false; // Only written before other threads exist
+static std::atomic<uint64_t> allocationCount(0);
+static std::atomic<uint64_t> allocationBytes(0);
+
+static const char* const PHASE_NAMES[] = { "lock wait", "read", "parse", "command", "serialize", "write" };
+static_assert(sizeof(PHASE_NAMES) / sizeof(PHASE_NAMES[0]) == static_cast<size_t>(StatsPhase::PHASE_COUNT),
+              "PHASE_NAMES must name every StatsPhase");
+
+PhaseTimer::~PhaseTimer() {
+    addPhaseTime(phase, std::chrono::steady_clock::now() - start);
+}
+
+void addPhaseTime(StatsPhase phase, std::chrono::steady_clock::duration elapsed) {
+    phaseTicks[static_cast<size_t>(phase)].fetch_add(elapsed.count(), std::memory_order_relaxed);
+}
+
+void addBytesRead(size_t bytes) {
+    bytesRead.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+void addBytesWritten(size_t bytes) {
+    bytesWritten.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+void setStatsTaskCount(size_t count) {
+    taskCount = count;
+}
+
+/**
+ * \@brief Starts counting heap allocations
+ */
+void enableAllocationCounting() {
+    countAllocations = true;
+}
+
+AllocationStats currentAllocations() {
+    AllocationStats stats;
+    stats.count = allocationCount.load(std::memory_order_relaxed);
+    stats.bytes = allocationBytes.load(std::memory_order_relaxed);
+    return stats;
+}
+
+/**
+ * \@brief Prints the phase times, byte counts, task count and allocations
+ * \@param out Where to print (task-cli uses stderr so stdout stays parseable)
+ * \@param total Wall time of the whole invocation
+ */
+void printStats(std::ostream& out, std::chrono::steady_clock::duration total) {
+    // Snapshot first: formatting below allocates too
+    AllocationStats allocations = currentAllocations();
+    char line[128];
+    auto milliseconds = [](int64_t ticks) {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::duration(ticks)).count();
+    };
+
+    out << "--- Stats ---" << std::endl;
+    int64_t accounted = 0;
+    for (size_t i = 0; i < static_cast<size_t>(StatsPhase::PHASE_COUNT); ++i) {
+        int64_t ticks = phaseTicks[i].load(std::memory_order_relaxed);
+        accounted += ticks;
+        std::snprintf(line, sizeof(line), "%-11s %10.3f ms", PHASE_NAMES[i], milliseconds(ticks));
+        out << line;
+        if (static_cast<StatsPhase>(i) == StatsPhase::READ) {
+            out << "  (" << bytesRead.load() << " bytes)";
+        } else if (static_cast<StatsPhase>(i) == StatsPhase::WRITE) {
+            out << "  (" << bytesWritten.load() << " bytes)";
+        }
+        out << std::endl;
+    }
+    std::snprintf(line, sizeof(line), "%-11s %10.3f ms", "other", milliseconds(total.count() - accounted));
+    out << line << std::endl;
+    std::snprintf(line, sizeof(line), "%-11s %10.3f ms", "total", milliseconds(total.count()));
+    out << line << std::endl;
+    out << "tasks       " << taskCount << std::endl;
+    out << "allocations " << allocations.count << " (" << allocations.bytes << " bytes)" << std::endl;
+    out << "-------------" << std::endl;
+}
+
+// --- Replacement global allocation functions ---
+// Count every allocation (once enabled), then defer to malloc/free. The nothrow and array
+// forms are replaced too so none of them bypasses the counters
+
+void* operator new(std::size_t size) {
+    if (countAllocations) {
+        allocationCount.fetch_add(1, std::memory_order_relaxed);
+        allocationBytes.fetch_add(size, std::memory_order_relaxed);
+    }
+    void* p = std::malloc(size == 0 ? 1 : size);
+    if (p == nullptr) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void* operator new[](std::size_t size) {
+    return ::operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    if (countAllocations) {
+        allocationCount.fetch_add(1, std::memory_order_relaxed);
+        allocationBytes.fetch_add(size, std::memory_order_relaxed);
+    }
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t& tag) noexcept {
+    return ::operator new(size, tag);
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, const std::nothrow_t&) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p, const std::nothrow_t&) noexcept {
+    std::free(p);
+}
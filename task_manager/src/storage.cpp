@@ -1,342 +1,1418 @@
-#include "storage.h"
-#include "task.h" // For Task struct, statusToString, stringToStatus
-#include "utils.h" // For formatTimestamp, getCurrentTimestamp 
-#include <iostream>
-#include <vector>
-#include <fstream> // For file streams (ofstream, ifstream)
-#include <sstream> // For string streams (used in parsing and formatting)
-#include <string>
-#include <stdexcept> // For exception handling during parsing if needed 
-#include <iomanip> // For std::get_time, std::put_time 
-#include <algorithm> // For std::remove_if, std::find_if
-#include <cctype> // For ::isspace
-
-// --- Helper Functions for JSON Handling ---
-
-/**
- * \@brief Escapes special JSON characters in a string
- * Currently handles double qutoes and backslashes 
- * \@param input The string to escape 
- * \@return The escaped string suitable for embedding in a JSON string value
- */
-std::string escapeJsonString(const std::string& input) {
-    std::ostringstream ss; 
-    for (char c : input) {
-        switch (c) {
-            case '"': ss << "\\\""; break; // Escape double quote 
-            case '\\': ss << "\\\\"; break; // Escape backslash
-            case '\b': ss << "\\b"; break; // Backspace 
-            case '\f': ss << "\\f"; break; // Form feed 
-            case '\n': ss << "\\n"; break; // Newline 
-            case '\r': ss << "\\r"; break; // Carriage return 
-            case '\t': ss << "\\t"; break; // Tab
-            default: ss << c; break;
-        }
-    }
-    return ss.str(); 
-}
-
-/**
- * \@brief Parses a timestamp string (expected format: YYYY-MM-DD HH:MM:SS) 
- * into a std::chrono::system_clock::time_point 
- * \@param timestampStr The string representation of the timestamp
- * \@return The corresponding time_point. Returns epoch on parsing failure.
- */
-std::chrono::system_clock::time_point parseTimestamp(const std::string& timestampStr) {
-    std::tm tm = {}; // Initialize tm struct to zeros 
-    std::stringstream ss(timestampStr);
-
-    ss >> std::get_time(&tm, "%Y-%m-%d %H:%M:%S");
-
-    if (ss.fail()) {
-        std::cerr << "Warning: Failed to parse timestamp string: " << timestampStr << std::endl;
-        return std::chrono::system_clock::from_time_t(0); // Return epoch on failure
-    }
-
-    std::time_t time = std::mktime(&tm);
-    if (time == -1) {
-        std::cerr << "Warning: Failed to convert parsed time components for: " << timestampStr << std::endl;
-        return std::chrono::system_clock::from_time_t(0); // Return epoch on failure 
-    }
-    return std::chrono::system_clock::from_time_t(time);
-}
-
-/**
- * \@brief Trims leading/trailing whitespace and double quotes from a string
- * \@param s The string to trim
- * \@return The trimmed string
- */
-std::string trimQuotesAndWhitespace(const std::string& s) {
-    // Find the first non-whitespace character
-    size_t first = s.find_first_not_of(" \t\n\r\"");
-    if (std::string::npos == first) {
-        return "";
-    }
-    // Find the last non-whitespace/non-quote character
-    size_t last = s.find_last_not_of(" \t\n\r\"");
-    return s.substr(first, (last - first + 1));
-}
-
-/**
- * \@brief Parses a string containing a simplified JSON object into a Task struct
- * This is a basic paraser assuming a specific field order and simple structure
- * It does NOT handled nested structures, arrays within the object, or complex escaping robustly
- * \@param objStr The string segment representing the JSON object 
- * \@param task Output parameter: The task struct to populate
- * \@return True if parsing was successful, false otherwise
- */
-bool parseTaskObject(const std::string& objStr, Task& task) {
-    std::stringstream ss(objStr);
-    std::string key;
-    std::string valueStr;
-    int numeric_id_value = -1; 
-    char ch;
-
-    // Basic validation
-    if (objStr.empty() || objStr.front() != '{' || objStr.back() != '}') {
-        std::cerr << "Error: Invalid task object string format (missing braces): " << objStr << std::endl;
-        return false;
-    }
-
-    // Consume '{' and initial whitespace
-    ss >> ch >> std::ws;
-    if (ch != '{') {
-         std::cerr << "Error: Expected '{' at the beginning of task object string." << std::endl;
-         return false;
-    }
-
-
-    while (ss.peek() != EOF && ss.peek() != '}') {
-        // 1. Extract the key (must be quoted)
-        ss >> std::quoted(key);
-        if (ss.fail()) {
-            std::cerr << "Error: Failed to read quoted key in task object: " << objStr << std::endl;
-            return false;
-        }
-
-        // 2. Consume the colon ':'
-        ss >> std::ws >> ch >> std::ws; // Skip whitespace around colon
-        if (ch != ':') {
-            std::cerr << "Error: Expected ':' after key '" << key << "' in task object: " << objStr << std::endl;
-            return false;
-        }
-
-        bool value_is_numeric = false; 
-
-        // 3. Extract the value
-        if (ss.peek() == '"') { // Value is a quoted string
-            ss >> std::quoted(valueStr);
-            if (ss.fail()) {
-                std::cerr << "Error: Failed to read quoted value for key '" << key << "' in task object: " << objStr << std::endl;
-                return false;
-            }
-        } else { // Assume value is a number (only for ID in this structure)
-             if (!(ss >> numeric_id_value)) {
-                std::cerr << "Error: Failed to read numeric value for key '" << key << "' in task object: " << objStr << std::endl;
-                return false; 
-             }
-             value_is_numeric = true; 
-            // Optional: Add more validation here to ensure valueStr is purely numeric if needed
-        }
-
-        // 4. Assign value to the correct Task member
-        try {
-            if (key == "id") {
-                if (!value_is_numeric) {
-                    std::cerr << "Error: Expected numeric value for key 'id', but found: " << valueStr << std::endl;
-                    return false;
-                }
-                task.id = numeric_id_value; 
-            } else if (key == "description") {
-                task.description = valueStr; // Already unescaped by std::quoted
-            } else if (key == "status") {
-                task.status = stringToStatus(valueStr); // Already unescaped by std::quoted
-            } else if (key == "createdAt") {
-                task.createdAt = parseTimestamp(valueStr); // Already unescaped by std::quoted
-            } else if (key == "updatedAt") {
-                task.updatedAt = parseTimestamp(valueStr); // Already unescaped by std::quoted
-            } else {
-                std::cerr << "Warning: Unknown key '" << key << "' in task object." << std::endl;
-            }
-        } catch (const std::invalid_argument& e) {
-            std::cerr << "Error: Invalid numeric format for key '" << key << "': " << valueStr << std::endl;
-            return false;
-        } catch (const std::out_of_range& e) {
-            std::cerr << "Error: Numeric value out of range for key '" << key << "': " << valueStr << std::endl;
-            return false;
-        }
-
-        // 5. Check for comma or closing brace
-        ss >> std::ws; // Skip whitespace after value
-        ch = ss.peek();
-
-        if (ch == ',') {
-            ss.ignore(1); // Consume comma
-            ss >> std::ws; // Consume whitespace leading to the next key
-        } else if (ch == '}') {
-            // End of object is next, let the loop condition handle it
-        } else if (ch == EOF) {
-             std::cerr << "Error: Unexpected end of input after value for key '" << key << "'." << std::endl;
-             return false;
-        } else {
-            std::cerr << "Error: Expected ',' or '}' after value for key '" << key << "', but found '" << (char)ch << "' in task object: " << objStr << std::endl;
-            return false;
-        }
-    } // End while loop
-
-    // Consume the final '}'
-    if (ss.peek() == '}') {
-        ss.ignore(1);
-    } else if (ss.peek() != EOF) {
-         // If it's not EOF and not '}', something is wrong after the last element
-         std::cerr << "Error: Expected '}' at the end of task object, but found '" << (char)ss.peek() << "'." << std::endl;
-         return false;
-    }
-
-
-    return true; // Parsing successful
-}
-
-
-// --- Public Interface Functions --- 
-
-/**
- * \@brief Loads tasks from the specified JSON file ("tasks.json")
- * Handles file not existing, empty file, and basic JSON array structure 
- * Uses parseTaskObject to individual task parsing
- * \@return A vector containing the loaded tasks. Returns empty vector on error or if file is empty
- */
-std::vector<Task> loadTasks() {
-    const std::string filename = "tasks.json"; 
-    std::vector<Task> tasks; 
-    std::ifstream inputFile(filename);
-
-    // Check if the file stream was opened successfully
-    if (!inputFile.is_open()) {
-        return tasks; // Return empty vector if file doesn't exist or can't be opened
-    }
-
-    // Read the entire file content into a stringstream buffer
-    std::stringstream buffer;
-    buffer << inputFile.rdbuf();
-    inputFile.close();
-    std::string content = buffer.str();
-
-    // --- Basic JSON array validation ---
-    // Trim leading/trailing whitespace from the whole content 
-    content.erase(0, content.find_first_not_of(" \t\n\r"));
-    content.erase(content.find_last_not_of(" \t\n\r") + 1);
-
-    // Check if content is empty or doesn't look like a JSON array 
-    if (content.length() <= 1 || content.front() != '[' || content.back() != ']') {
-        if (!content.empty()) {
-            std::cerr << "Warning: '" << filename << "' is malformed or empty. Starting with empty task list." << std::endl;
-        }
-        // Otherwise, return empty vector
-        return tasks; 
-    }
-
-    // --- Parse task objects within the array ---
-    size_t startPos = 1; 
-    size_t objEndPos = 0;
-    int braceLevel = 0;
-
-    while (startPos < content.length() - 1) {
-        // Find the start of the next object '{'
-        size_t objStartPos = content.find('{', startPos);
-        if (objStartPos == std::string::npos) {
-            break; // No more objects found 
-        }
-
-        // Find the corresponding closing brace '}' for this object 
-        braceLevel = 0; 
-        objEndPos = objStartPos; 
-        while (objEndPos < content.length() - 1) {
-            if (content[objEndPos] == '{') {
-                braceLevel++;
-            } else if (content[objEndPos] == '}') {
-                braceLevel--;
-                if (braceLevel == 0) {
-                    break; // Found the matching closing brace
-                }
-            }
-            objEndPos++;
-        }
-
-        if (braceLevel != 0) {
-            std::cerr << "Warning: Malformed JSON structure in '" << filename << "'. Mismatched braces." << std::endl; 
-            tasks.clear();
-            return tasks; 
-        }
-
-        // Extract the object string 
-        std::string taskStr = content.substr(objStartPos, objEndPos - objStartPos + 1); 
-
-        Task task;
-        if (parseTaskObject(taskStr, task)) {
-            tasks.push_back(task); // Add successfully parsed task 
-        } else {
-            std::cerr << "Warning: Skipping malformed task object in '" << filename << "'." << std::endl;
-        }
-        startPos = objEndPos + 1; 
-    } // End while loop for finding objects
-
-    // --- Final Output ---
-    // Only print the "Loaded..." message if tasks were actually parsed
-    if (!tasks.empty()) {
-        std::cout << "Loaded " << tasks.size() << " task(s) from " << filename << "." << std::endl;
-    }
-    return tasks; 
-
-}
-
-/**
- * \@brief Saves the provided vector of tasks to the specified JSON file ("tasks.json")
- * Overwrites the file if it exists. Creates it if it doesn't
- * Formats the output as a JSON array of task objects 
- * \@param tasks The vector of tasks to save
- */
-void saveTasks(const std::vector<Task>& tasks) {
-    const std::string filename = "tasks.json"; 
-    // Open the file for writing 
-    std::ofstream outputFile(filename);
-
-    // Check if the file stream was opened successfully 
-    if (!outputFile.is_open()) {
-        std::cerr << "Error: Could not open '" << filename << "' for writing." << std::endl;
-        return; // Exit if file can't be opened 
-    }
-
-    // Write the opening bracket for the JSON array 
-    outputFile << "[" << std::endl;
-
-    // Iterate through the tasks and write each one as a JSON object
-    for (size_t i = 0; i < tasks.size(); ++i) {
-        const auto& task = tasks[i]; 
-
-        // Start of the JSON object for the task
-        outputFile << " {" << std::endl;
-
-        // Write key-value pairs for each field
-        outputFile << "   \"id\": " << task.id << "," << std::endl;
-        outputFile << "   \"description\": \"" << escapeJsonString(task.description) << "\"," << std::endl; 
-        outputFile << "   \"status\": \"" << statusToString(task.status) << "\"," << std::endl;
-        outputFile << "   \"createdAt\": \"" << formatTimestamp(task.createdAt) << "\"," << std::endl;
-        outputFile << "   \"updatedAt\": \"" << formatTimestamp(task.updatedAt) << "\"" << std::endl;
-
-        // End of the JSON object for the task 
-        outputFile << " }";
-
-        // Add a comma after the object if it's not the last task in the vector
-        if (i < tasks.size() - 1) {
-            outputFile << ",";
-        }
-        outputFile << std::endl;
-    }
-
-    // Write the closing bracket for the JSON array 
-    outputFile << "]" << std::endl;
-
-    // The ofstream destructor will automatically close the file when outputFile goes out of scope
-    std::cout << "Saved " << tasks.size() << " task(s) to " << filename << "." << std::endl;
-}
\ No newline at end of file
+#include "storage.h"
+#include "task.h" // For Task struct, statusToString, stringToStatus
+#include "utils.h" // For formatTimestamp, getCurrentTimestamp 
+#include "binary_store.h" // For the optional binary backend (tasks.bin)
+#include "btree_store.h" // For the optional paged B+tree backend (tasks.db)
+#include "lsm_store.h" // For the optional log-structured backend (tasks.lsm)
+#include "stats.h" // For --stats phase timing and byte counts
+#include "json_text.h" // For escaping and decoding JSON strings
+#include <iostream>
+#include <vector>
+#include <fstream> // For file streams (ofstream, ifstream)
+#include <sstream> // For string streams (used in parsing and formatting)
+#include <string>
+#include <stdexcept> // For exception handling during parsing if needed 
+#include <algorithm> // For std::remove_if, std::find_if
+#include <cctype> // For ::isspace
+#include <cstring> // For std::memchr, std::strerror
+#include <cstdio> // For std::remove, std::rename
+#include <limits> // For std::numeric_limits
+#include <unordered_map> // For the id lookup used while replaying the log
+#include <sys/stat.h> // For stat (file sizes)
+#include <unistd.h> // For truncate
+#include <cstdlib> // For std::getenv
+#include <cerrno>
+#include <chrono> // For timing lock waits
+#include <thread> // For std::this_thread::sleep_for, and the parse threads
+#include <atomic> // For handing out parse chunks
+#include <iterator> // For std::back_inserter
+#include <system_error> // For std::system_error (thread creation failure)
+#include <fcntl.h> // For open
+#include <sys/file.h> // For flock
+
+// Snapshot of the full task list (the newest checkpoint), rewritten only on compaction
+const std::string TASKS_FILE = "tasks.json";
+// Append-only log of task mutations made since the last snapshot
+const std::string MUTATION_LOG_FILE = "tasks.log";
+// The checkpoint before the newest one and the log that led from it to the newest,
+// kept so a damaged tasks.json can be rebuilt
+const std::string PREVIOUS_TASKS_FILE = "tasks.json.prev";
+const std::string PREVIOUS_MUTATION_LOG_FILE = "tasks.log.prev";
+// The log is folded into a fresh snapshot once it grows past this many bytes...
+const long long LOG_COMPACT_MIN_BYTES = 64 * 1024;
+// ...and past this fraction of the snapshot size, so compaction cost stays amortized O(1) per change
+const long long LOG_COMPACT_SNAPSHOT_DIVISOR = 4;
+// Log records end in " #" and the CRC-32 of the rest of the line as 8 hex digits
+const size_t RECORD_CHECKSUM_LENGTH = 10;
+// A checkpoint logs tasks added in bulk in writes of about this many bytes
+const size_t BULK_LOG_WRITE_BYTES = 1 << 20;
+// Log size that triggers a checkpoint; 0 uses the two limits above
+static long long checkpointLogLimit = 0;
+// Snapshot bytes per task besides its description (keys, indentation, timestamps); sizes the save buffer
+const size_t SNAPSHOT_BYTES_PER_TASK_ESTIMATE = 192;
+// Snapshot task arrays smaller than this are parsed on the calling thread
+const size_t PARALLEL_PARSE_MIN_BYTES = 4 * 1024 * 1024;
+// Parallel parsing cuts the array into chunks of at least this size...
+const size_t PARSE_CHUNK_MIN_BYTES = 512 * 1024;
+// ...and about this many per thread, so one slow chunk does not leave the others idle
+const size_t PARSE_CHUNKS_PER_THREAD = 4;
+// Threads that may parse one snapshot; 0 means one per hardware thread
+static size_t parseThreadLimit = 0;
+
+// Lock file guarding the store; the data files themselves are replaced by rename,
+// so they cannot carry the lock
+const std::string LOCK_FILE = "tasks.lock";
+// Give up on the lock after this long, rather than hanging a CI job forever
+const std::chrono::milliseconds LOCK_TIMEOUT(10000);
+// Retry delays grow from the first to the second value while the lock is contended
+const std::chrono::microseconds LOCK_RETRY_MIN_DELAY(200);
+const std::chrono::microseconds LOCK_RETRY_MAX_DELAY(20000);
+
+// Changes made by the current command(s), waiting for commitTasks
+static std::vector<TaskChange> pendingChanges;
+// Set by recordFullRewrite: the next commit writes a snapshot instead of pendingChanges
+static bool fullRewritePending = false;
+// Set by recordTasksAddedFrom: tasks with this id or above are logged from the list
+// by the next checkpoint rather than from pendingChanges (0: none)
+static int bulkAddedFromId = 0;
+// Whether loadTasks reports what it loaded on stdout
+static bool loadMessagesEnabled = true;
+// Descriptor holding the store lock, or -1 if this process does not hold it
+static int lockFd = -1;
+// How lockFd holds the lock (meaningful only while it is held)
+static StoreLockMode lockMode = StoreLockMode::EXCLUSIVE;
+// Set when loadTasks found tasks.json damaged and fell back to the previous checkpoint
+static bool newestCheckpointDamaged = false;
+
+// --- Helper Functions for JSON Handling ---
+
+/**
+ * \@brief Parses a timestamp string (expected format: YYYY-MM-DD HH:MM:SS) 
+ * into a std::chrono::system_clock::time_point 
+ * \@param timestampStr The string representation of the timestamp
+ * \@param warnings Where a parsing failure is reported
+ * \@return The corresponding time_point. Returns epoch on parsing failure.
+ */
+std::chrono::system_clock::time_point parseTimestamp(const std::string& timestampStr, std::ostream& warnings) {
+    std::chrono::system_clock::time_point tp;
+    if (!parseTimestamp(timestampStr.data(), timestampStr.size(), tp)) {
+        warnings << "Warning: Failed to parse timestamp string: " << timestampStr << std::endl;
+        return std::chrono::system_clock::from_time_t(0); // Return epoch on failure
+    }
+    return tp;
+}
+
+/**
+ * \@brief Trims leading/trailing whitespace and double quotes from a string
+ * \@param s The string to trim
+ * \@return The trimmed string
+ */
+std::string trimQuotesAndWhitespace(const std::string& s) {
+    // Find the first non-whitespace character
+    size_t first = s.find_first_not_of(" \t\n\r\"");
+    if (std::string::npos == first) {
+        return "";
+    }
+    // Find the last non-whitespace/non-quote character
+    size_t last = s.find_last_not_of(" \t\n\r\"");
+    return s.substr(first, (last - first + 1));
+}
+
+/**
+ * \@brief Checks whether a character counts as whitespace between JSON tokens
+ * Matches the set skipped by std::ws in the default locale
+ * \@param c The character to test
+ * \@return True if the character is whitespace
+ */
+inline bool isJsonWhitespace(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v';
+}
+
+/**
+ * \@brief Advances a cursor past any whitespace
+ * \@param pos The cursor to advance (modified in place)
+ * \@param end One past the last character of the buffer
+ */
+inline void skipWhitespace(const char*& pos, const char* end) {
+    while (pos < end && isJsonWhitespace(*pos)) {
+        ++pos;
+    }
+}
+
+/**
+ * \@brief Finds the closing brace matching the '{' at objStart
+ * Braces that appear inside quoted strings are ignored
+ * \@param objStart Pointer to the opening '{'
+ * \@param end One past the last character that may belong to the object
+ * \@return Pointer to the matching '}', or nullptr if the braces are unbalanced
+ */
+const char* findObjectEnd(const char* objStart, const char* end) {
+    int braceLevel = 0;
+    bool inString = false;
+    for (const char* p = objStart; p < end; ++p) {
+        if (inString) {
+            if (*p == '\\') {
+                ++p; // Skip the escaped character
+            } else if (*p == '"') {
+                inString = false;
+            }
+        } else if (*p == '"') {
+            inString = true;
+        } else if (*p == '{') {
+            braceLevel++;
+        } else if (*p == '}') {
+            braceLevel--;
+            if (braceLevel == 0) {
+                return p; // Found the matching closing brace
+            }
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * \@brief Reads a double-quoted string starting at the cursor
+ * Escapes are decoded by readJsonStringBody (the full JSON set, including \uXXXX)
+ * \@param pos The cursor, which must point at the opening quote (advanced past the closing quote)
+ * \@param end One past the last character of the buffer
+ * \@param out Output parameter: receives the unescaped contents (reuses its capacity)
+ * \@return True if a complete quoted string was read, false otherwise
+ */
+bool readQuotedString(const char*& pos, const char* end, std::string& out) {
+    if (pos >= end || *pos != '"') {
+        return false;
+    }
+    out.clear();
+    const char* p = pos + 1;
+    if (!readJsonStringBody(p, end, out)) {
+        return false;
+    }
+    pos = p;
+    return true;
+}
+
+/**
+ * \@brief Reads a base-10 integer starting at the cursor
+ * \@param pos The cursor (advanced past the digits on success)
+ * \@param end One past the last character of the buffer
+ * \@param out Output parameter: the parsed value
+ * \@return True if at least one digit was read and the value fits in an int
+ */
+bool readInteger(const char*& pos, const char* end, int& out) {
+    const char* p = pos;
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+')) {
+        negative = (*p == '-');
+        ++p;
+    }
+    if (p >= end || *p < '0' || *p > '9') {
+        return false;
+    }
+    long long value = 0;
+    while (p < end && *p >= '0' && *p <= '9') {
+        value = value * 10 + (*p - '0');
+        if (value > 2147483648LL) {
+            return false; // Out of range for int
+        }
+        ++p;
+    }
+    if (negative) {
+        value = -value;
+    }
+    if (value > std::numeric_limits<int>::max() || value < std::numeric_limits<int>::min()) {
+        return false;
+    }
+    out = static_cast<int>(value);
+    pos = p;
+    return true;
+}
+
+/**
+ * \@brief Parses one JSON task object directly out of the file buffer
+ * This is a basic parser for the flat objects written by saveTasks
+ * It does NOT handle nested structures or arrays within the object
+ * \@param pos The cursor, which must point at the opening '{' (advanced past the closing '}' on success)
+ * \@param end One past the last character the object may extend to
+ * \@param task Output parameter: The task struct to populate
+ * \@param error Output parameter: Receives a diagnostic message if parsing fails
+ * \@param warnings Where warnings about a task that still parses are written
+ * \@param warnUnknownKeys Whether to warn about keys that are not Task fields
+ * \@return True if parsing was successful, false otherwise
+ */
+bool parseTaskObject(const char*& pos, const char* end, Task& task, std::string& error, std::ostream& warnings,
+                     bool warnUnknownKeys) {
+    // Key and value buffers are reused across objects to avoid per-field allocations
+    static thread_local std::string key;
+    static thread_local std::string valueStr;
+    const char* objStart = pos;
+    const char* p = pos;
+    int numeric_id_value = -1;
+
+    // Renders the whole object for error messages; only called on the failure path
+    auto objectText = [objStart, end]() {
+        const char* objEnd = findObjectEnd(objStart, end);
+        return std::string(objStart, objEnd ? objEnd + 1 : end);
+    };
+
+    // Consume '{' and initial whitespace
+    ++p;
+    skipWhitespace(p, end);
+
+    while (p < end && *p != '}') {
+        // 1. Extract the key (must be quoted)
+        if (!readQuotedString(p, end, key)) {
+            error = "Error: Failed to read quoted key in task object: " + objectText();
+            return false;
+        }
+
+        // 2. Consume the colon ':'
+        skipWhitespace(p, end);
+        if (p >= end || *p != ':') {
+            error = "Error: Expected ':' after key '" + key + "' in task object: " + objectText();
+            return false;
+        }
+        ++p;
+        skipWhitespace(p, end);
+
+        bool value_is_numeric = false;
+
+        // 3. Extract the value
+        if (p < end && *p == '"') { // Value is a quoted string
+            if (!readQuotedString(p, end, valueStr)) {
+                error = "Error: Failed to read quoted value for key '" + key + "' in task object: " + objectText();
+                return false;
+            }
+        } else { // Assume value is a number (only for ID in this structure)
+            if (!readInteger(p, end, numeric_id_value)) {
+                error = "Error: Failed to read numeric value for key '" + key + "' in task object: " + objectText();
+                return false;
+            }
+            value_is_numeric = true;
+        }
+
+        // 4. Assign value to the correct Task member
+        if (key == "id") {
+            if (!value_is_numeric) {
+                error = "Error: Expected numeric value for key 'id', but found: " + valueStr;
+                return false;
+            }
+            task.id = numeric_id_value;
+        } else if (key == "description") {
+            task.description = valueStr;
+        } else if (key == "status") {
+            task.status = stringToStatus(valueStr);
+        } else if (key == "createdAt") {
+            task.createdAt = parseTimestamp(valueStr, warnings);
+        } else if (key == "updatedAt") {
+            task.updatedAt = parseTimestamp(valueStr, warnings);
+        } else if (warnUnknownKeys) {
+            warnings << "Warning: Unknown key '" << key << "' in task object." << std::endl;
+        }
+
+        // 5. Check for comma or closing brace
+        skipWhitespace(p, end);
+        if (p >= end) {
+            error = "Error: Unexpected end of input after value for key '" + key + "'.";
+            return false;
+        } else if (*p == ',') {
+            ++p; // Consume comma
+            skipWhitespace(p, end); // Consume whitespace leading to the next key
+        } else if (*p != '}') {
+            error = "Error: Expected ',' or '}' after value for key '" + key + "', but found '" + std::string(1, *p) + "' in task object: " + objectText();
+            return false;
+        }
+    } // End while loop
+
+    if (p >= end) {
+        error = "Error: Unexpected end of input in task object: " + objectText();
+        return false;
+    }
+
+    // Consume the final '}'
+    pos = p + 1;
+    return true; // Parsing successful
+}
+
+
+// --- Public Interface Functions ---
+
+/**
+ * \@brief Reads a whole file into one buffer sized up front
+ * \@param filename The file to read
+ * \@param content Output parameter: receives the file contents
+ * \@return True if the file could be opened, false otherwise
+ */
+bool readWholeFile(const std::string& filename, std::string& content) {
+    PhaseTimer readTimer(StatsPhase::READ);
+    std::ifstream inputFile(filename, std::ios::binary);
+    if (!inputFile.is_open()) {
+        return false;
+    }
+    inputFile.seekg(0, std::ios::end);
+    std::streamoff fileSize = inputFile.tellg();
+    inputFile.seekg(0, std::ios::beg);
+    content.assign(fileSize > 0 ? static_cast<size_t>(fileSize) : 0, '\0');
+    if (!content.empty()) {
+        inputFile.read(&content[0], content.size());
+        content.resize(static_cast<size_t>(inputFile.gcount()));
+    }
+    addBytesRead(content.size());
+    return true;
+}
+
+/**
+ * \@brief Returns the size of a file in bytes
+ * \@param filename The file to inspect
+ * \@return The size, or 0 if the file does not exist
+ */
+long long fileSizeOf(const std::string& filename) {
+    struct stat info;
+    if (stat(filename.c_str(), &info) != 0) {
+        return 0;
+    }
+    return static_cast<long long>(info.st_size);
+}
+
+/**
+ * \@brief Formats a CRC-32 as the 8 lowercase hex digits stored in snapshots and log records
+ * \@param crc The checksum
+ * \@param text Output parameter: receives the digits and a terminating NUL
+ */
+static void formatChecksum(uint32_t crc, char (&text)[9]) {
+    std::snprintf(text, sizeof(text), "%08x", static_cast<unsigned>(crc));
+}
+
+/**
+ * \@brief Parses 8 hex digits written by formatChecksum
+ * \@param text The digits (at least 8 readable characters)
+ * \@param crc Output parameter: the checksum
+ * \@return False if any of the 8 characters is not a hex digit
+ */
+static bool parseChecksum(const char* text, uint32_t& crc) {
+    crc = 0;
+    for (int i = 0; i < 8; ++i) {
+        char c = text[i];
+        int digit = (c >= '0' && c <= '9') ? c - '0' : (c >= 'a' && c <= 'f') ? c - 'a' + 10 : -1;
+        if (digit < 0) {
+            return false;
+        }
+        crc = (crc << 4) | static_cast<uint32_t>(digit);
+    }
+    return true;
+}
+
+/**
+ * \@brief Parses the fields that precede the task array in a snapshot object
+ * Expects the cursor just inside '{' of {"nextId": N, ..., "tasks": [...]}; the
+ * "tasks" array must be the last field, which is how saveTasks writes it
+ * \@param pos The cursor (left pointing at the '[' of the task array on success)
+ * \@param end One past the last character of the object's contents
+ * \@param nextId Output parameter: the stored next-id counter (unchanged if absent)
+ * \@param checksum Output parameter: the stored checksum text (unchanged if absent)
+ * \@return True if the task array was found, false if the object is malformed
+ */
+bool parseSnapshotHeader(const char*& pos, const char* end, int& nextId, std::string& checksum) {
+    std::string key;
+    std::string ignored;
+    const char* p = pos;
+    while (true) {
+        skipWhitespace(p, end);
+        if (!readQuotedString(p, end, key)) {
+            return false;
+        }
+        skipWhitespace(p, end);
+        if (p >= end || *p != ':') {
+            return false;
+        }
+        ++p;
+        skipWhitespace(p, end);
+
+        if (key == "tasks") {
+            pos = p;
+            return p < end && *p == '[';
+        } else if (key == "nextId") {
+            if (!readInteger(p, end, nextId)) {
+                return false;
+            }
+        } else if (key == "checksum") {
+            if (!readQuotedString(p, end, checksum)) {
+                return false;
+            }
+        } else {
+            // Unknown metadata from a newer version: skip simple values
+            int number = 0;
+            if (!readQuotedString(p, end, ignored) && !readInteger(p, end, number)) {
+                return false;
+            }
+        }
+
+        skipWhitespace(p, end);
+        if (p >= end || *p != ',') {
+            return false;
+        }
+        ++p;
+    }
+}
+
+/**
+ * \@brief Sets how many threads may parse a large snapshot (0 = one per hardware thread)
+ * \@param threads The thread limit
+ */
+void setParseThreadLimit(size_t threads) {
+    parseThreadLimit = threads;
+}
+
+// The task objects parsed from one stretch of the snapshot's task array
+struct ParsedChunk {
+    std::vector<Task> tasks;
+    std::ostringstream warnings; // Diagnostics, printed in file order once the parallel pass succeeds
+    const char* stoppedAt = nullptr; // Where parsing ended
+    bool mismatchedBraces = false; // Parsing gave up: the rest of the array is unreadable
+};
+
+/**
+ * \@brief Parses the task objects that start before stop, skipping malformed ones
+ * Objects are parsed against the whole array, so one that starts before stop may
+ * end after it; chunk.stoppedAt then lies past stop
+ * \@param pos Where to start looking for the next '{'
+ * \@param stop No object starting at or after this position is parsed
+ * \@param arrayEnd Position of the array's closing ']'
+ * \@param filename The file being parsed, for diagnostics
+ * \@param chunk Output parameter: receives the tasks and where parsing stopped
+ * \@param warnings Where diagnostics go
+ */
+static void parseTaskRange(const char* pos, const char* stop, const char* arrayEnd, const std::string& filename,
+                           ParsedChunk& chunk, std::ostream& warnings) {
+    std::string error;
+    while (pos < stop) {
+        // Find the start of the next object '{'
+        const char* objStart = static_cast<const char*>(std::memchr(pos, '{', stop - pos));
+        if (objStart == nullptr) {
+            break; // No more objects found
+        }
+
+        pos = objStart;
+        Task task;
+        if (parseTaskObject(pos, arrayEnd, task, error, warnings)) {
+            chunk.tasks.push_back(std::move(task)); // Add successfully parsed task
+            continue;
+        }
+
+        // Resynchronise on the object's closing brace so the rest of the file still loads
+        const char* objEnd = findObjectEnd(objStart, arrayEnd);
+        if (objEnd == nullptr) {
+            warnings << "Warning: Malformed JSON structure in '" << filename << "'. Mismatched braces." << std::endl;
+            chunk.tasks.clear();
+            chunk.mismatchedBraces = true;
+            break;
+        }
+        warnings << error << std::endl;
+        warnings << "Warning: Skipping malformed task object in '" << filename << "'." << std::endl;
+        pos = objEnd + 1;
+    } // End while loop for finding objects
+    chunk.stoppedAt = pos;
+}
+
+/**
+ * \@brief Finds a place at or after target to split the task array: a '{' that starts a line
+ * Raw newlines cannot appear inside JSON strings, and task objects have no nested
+ * objects, so in the layout saveTasks writes this is the start of a task
+ * \@return The '{', or end if no line after target starts with one
+ */
+static const char* findChunkBoundary(const char* target, const char* end) {
+    const char* p = target;
+    while (p < end) {
+        const char* newline = static_cast<const char*>(std::memchr(p, '\n', end - p));
+        if (newline == nullptr) {
+            return end;
+        }
+        p = newline + 1;
+        while (p < end && (*p == ' ' || *p == '\t' || *p == '\r')) {
+            ++p;
+        }
+        if (p < end && *p == '{') {
+            return p;
+        }
+    }
+    return end;
+}
+
+/**
+ * \@brief Parses a large task array on several threads
+ * The array is cut into chunks at line-initial '{' and the chunks are parsed by a
+ * small pool of threads, then concatenated in file order. A chunk boundary is only
+ * trusted if the chunk before it stopped at or before it, which is exactly when a
+ * single pass would have started its next object there; anything else (an object
+ * running across the cut, unbalanced braces) makes the caller parse sequentially,
+ * so results and warnings are the same as a single pass in every case
+ * \@param begin Just past the array's opening '['
+ * \@param arrayEnd Position of the array's closing ']'
+ * \@param filename The file being parsed, for diagnostics
+ * \@param tasks Output parameter: the parsed tasks (only set on success)
+ * \@return False if the array should be parsed sequentially instead
+ */
+static bool parseTaskArrayParallel(const char* begin, const char* arrayEnd, const std::string& filename,
+                                   std::vector<Task>& tasks) {
+    size_t threads = parseThreadLimit != 0 ? parseThreadLimit : std::thread::hardware_concurrency();
+    size_t bytes = static_cast<size_t>(arrayEnd - begin);
+    if (threads <= 1 || bytes < PARALLEL_PARSE_MIN_BYTES) {
+        return false;
+    }
+
+    // Chunk starts; the last entry is arrayEnd and closes the final chunk
+    size_t chunkTarget = std::min(threads * PARSE_CHUNKS_PER_THREAD, bytes / PARSE_CHUNK_MIN_BYTES);
+    std::vector<const char*> starts;
+    starts.push_back(begin);
+    for (size_t i = 1; i < chunkTarget; ++i) {
+        const char* boundary = findChunkBoundary(begin + bytes / chunkTarget * i, arrayEnd);
+        if (boundary > starts.back() && boundary < arrayEnd) {
+            starts.push_back(boundary);
+        }
+    }
+    starts.push_back(arrayEnd);
+    size_t chunkCount = starts.size() - 1;
+    if (chunkCount < 2) {
+        return false; // No usable boundaries (e.g. everything on one line)
+    }
+
+    // Each thread claims the next unparsed chunk until none are left
+    std::vector<ParsedChunk> chunks(chunkCount);
+    std::atomic<size_t> nextChunk(0);
+    auto worker = [&]() {
+        for (size_t i = nextChunk.fetch_add(1); i < chunkCount; i = nextChunk.fetch_add(1)) {
+            parseTaskRange(starts[i], starts[i + 1], arrayEnd, filename, chunks[i], chunks[i].warnings);
+        }
+    };
+    std::vector<std::thread> pool;
+    for (size_t t = 1; t < std::min(threads, chunkCount); ++t) {
+        try {
+            pool.emplace_back(worker);
+        } catch (const std::system_error&) {
+            break; // Out of threads: the ones already running (and this one) share the work
+        }
+    }
+    worker();
+    for (auto& thread : pool) {
+        thread.join();
+    }
+
+    size_t total = 0;
+    for (size_t i = 0; i < chunkCount; ++i) {
+        if (chunks[i].mismatchedBraces || chunks[i].stoppedAt > starts[i + 1]) {
+            return false;
+        }
+        total += chunks[i].tasks.size();
+    }
+    tasks.reserve(total);
+    for (auto& chunk : chunks) {
+        std::cerr << chunk.warnings.str();
+        std::move(chunk.tasks.begin(), chunk.tasks.end(), std::back_inserter(tasks));
+    }
+    return true;
+}
+
+/**
+ * \@brief Loads a task snapshot (checkpoint) from a JSON file ("tasks.json")
+ * The file is {"nextId": N, "checksum": "...", "tasks": [...]}, where the checksum is the
+ * CRC-32 of everything from the task array's '[' to the end of the file. Snapshots
+ * without a checksum, and files written before the next-id counter existed (a bare
+ * task array), are still accepted
+ * Handles file not existing, empty file, and basic JSON array structure
+ * The file is read into a single buffer and parsed with parseTaskObject; no intermediate
+ * substrings or string streams are created per task. Large files are parsed in chunks
+ * on several threads (see parseTaskArrayParallel)
+ * \@param filename The snapshot to read
+ * \@param nextId Output parameter: the stored next-id counter, or 0 if the file has none
+ * \@param intact Output parameter: false if the file exists but fails its checksum or is
+ * malformed beyond skipping single tasks (a missing or empty file is intact)
+ * \@return A vector containing the snapshot's tasks. Returns empty vector on error or if file is empty
+ */
+std::vector<Task> loadSnapshot(const std::string& filename, int& nextId, bool& intact) {
+    std::vector<Task> tasks;
+    std::string content;
+    nextId = 0;
+    intact = true;
+
+    // Check if the file could be read
+    if (!readWholeFile(filename, content)) {
+        return tasks; // Return empty vector if file doesn't exist or can't be opened
+    }
+    PhaseTimer parseTimer(StatsPhase::PARSE);
+
+    // --- Basic JSON array validation ---
+    // Trim leading/trailing whitespace by narrowing the view, not the buffer
+    const char* begin = content.data();
+    const char* end = begin + content.size();
+    while (begin < end && isJsonWhitespace(*begin)) {
+        ++begin;
+    }
+    while (end > begin && isJsonWhitespace(*(end - 1))) {
+        --end;
+    }
+
+    // Unwrap the snapshot object down to its task array
+    if (end - begin > 1 && *begin == '{' && *(end - 1) == '}') {
+        const char* arrayStart = begin + 1;
+        std::string checksum;
+        if (!parseSnapshotHeader(arrayStart, end - 1, nextId, checksum)) {
+            std::cerr << "Warning: '" << filename << "' is malformed or empty. Starting with empty task list." << std::endl;
+            intact = false;
+            return tasks;
+        }
+        const char* fileEnd = content.data() + content.size();
+        uint32_t stored = 0;
+        if (!checksum.empty() && (checksum.size() != 8 || !parseChecksum(checksum.data(), stored) ||
+                                  crc32(arrayStart, fileEnd - arrayStart) != stored)) {
+            std::cerr << "Warning: '" << filename << "' fails its checksum (it is damaged or was not written completely)." << std::endl;
+            intact = false;
+            nextId = 0;
+            return tasks;
+        }
+        begin = arrayStart;
+        --end; // Drop the object's closing '}'
+        while (end > begin && isJsonWhitespace(*(end - 1))) {
+            --end;
+        }
+    }
+
+    // Check if content is empty or doesn't look like a JSON array
+    if (end - begin <= 1 || *begin != '[' || *(end - 1) != ']') {
+        if (begin != end) {
+            std::cerr << "Warning: '" << filename << "' is malformed or empty. Starting with empty task list." << std::endl;
+            intact = false;
+        }
+        // Otherwise, return empty vector
+        return tasks;
+    }
+
+    // --- Parse task objects within the array ---
+    const char* arrayEnd = end - 1; // Position of the closing ']'
+    if (parseTaskArrayParallel(begin + 1, arrayEnd, filename, tasks)) {
+        return tasks;
+    }
+    ParsedChunk whole;
+    parseTaskRange(begin + 1, arrayEnd, arrayEnd, filename, whole, std::cerr);
+    if (whole.mismatchedBraces) {
+        intact = false;
+        return tasks;
+    }
+    return std::move(whole.tasks);
+}
+
+/**
+ * \@brief Formats a task as a single-line JSON object (used for log records)
+ * \@param task The task to format
+ * \@return The JSON text, without a trailing newline
+ */
+std::string taskToJsonLine(const Task& task) {
+    char stamp[TIMESTAMP_BUFFER_SIZE];
+    std::string line = "{\"id\": " + std::to_string(task.id);
+    line += ", \"description\": \"";
+    appendJsonEscaped(line, task.description.data(), task.description.size());
+    line += "\", \"status\": \"" + statusToString(task.status);
+    line += "\", \"createdAt\": \"";
+    line.append(stamp, formatTimestamp(task.createdAt, stamp));
+    line += "\", \"updatedAt\": \"";
+    line.append(stamp, formatTimestamp(task.updatedAt, stamp));
+    line += "\"}";
+    return line;
+}
+
+/**
+ * \@brief Applies a mutation log ("tasks.log") on top of a loaded snapshot
+ * Each line is either "U <task object>" (add/update) or "D <id>" (delete), followed
+ * by " #" and the line's CRC-32; a record that fails its checksum is skipped, and
+ * records written before checksums existed are taken as they are
+ * Records are idempotent, so replaying a log that was already folded into
+ * the snapshot (e.g. after a crash during compaction) gives the same result
+ * \@param filename The log to replay
+ * \@param tasks The snapshot tasks (will be modified)
+ * \@param nextId The next-id counter (raised past every id the log ever added, even if later deleted)
+ * \@return The number of records applied
+ */
+size_t replayMutationLog(const std::string& filename, std::vector<Task>& tasks, int& nextId) {
+    std::string content;
+    if (!readWholeFile(filename, content) || content.empty()) {
+        return 0;
+    }
+    PhaseTimer parseTimer(StatsPhase::PARSE);
+
+    // Position of each live task, so a record touches only its own task
+    std::unordered_map<int, size_t> positions;
+    positions.reserve(tasks.size());
+    for (size_t i = 0; i < tasks.size(); ++i) {
+        positions[tasks[i].id] = i;
+    }
+    std::vector<bool> deleted(tasks.size(), false);
+
+    const char* pos = content.data();
+    const char* end = pos + content.size();
+    size_t applied = 0;
+    std::string error;
+
+    while (pos < end) {
+        const char* lineEnd = static_cast<const char*>(std::memchr(pos, '\n', end - pos));
+        if (lineEnd == nullptr) {
+            // A crash mid-append leaves a partial last line; the change it described was never committed.
+            // Cut it off so the next append starts on a fresh line (left to the next writer under a shared lock)
+            std::cerr << "Warning: Ignoring incomplete record at the end of '" << filename << "'." << std::endl;
+            if (storeRepairAllowed() && truncate(filename.c_str(), static_cast<off_t>(pos - content.data())) != 0) {
+                std::cerr << "Warning: Could not truncate '" << filename << "'." << std::endl;
+            }
+            break;
+        }
+
+        // Check and strip the record's checksum, if it has one
+        const char* recordEnd = lineEnd;
+        if (static_cast<size_t>(lineEnd - pos) > RECORD_CHECKSUM_LENGTH &&
+            lineEnd[-10] == ' ' && lineEnd[-9] == '#') {
+            recordEnd = lineEnd - RECORD_CHECKSUM_LENGTH;
+            uint32_t stored = 0;
+            if (!parseChecksum(recordEnd + 2, stored) || crc32(pos, recordEnd - pos) != stored) {
+                std::cerr << "Warning: Skipping damaged record (checksum mismatch) in '" << filename << "'." << std::endl;
+                pos = lineEnd + 1;
+                continue;
+            }
+        }
+
+        bool ok = false;
+        const char* p = pos + 2;
+        if (recordEnd - pos > 2 && pos[0] == 'U' && pos[1] == ' ' && *p == '{') {
+            Task task;
+            ok = parseTaskObject(p, recordEnd, task, error, std::cerr);
+            if (ok) {
+                nextId = std::max(nextId, task.id + 1);
+                auto it = positions.find(task.id);
+                if (it != positions.end()) {
+                    tasks[it->second] = std::move(task);
+                } else {
+                    positions[task.id] = tasks.size();
+                    tasks.push_back(std::move(task));
+                    deleted.push_back(false);
+                }
+            }
+        } else if (recordEnd - pos > 2 && pos[0] == 'D' && pos[1] == ' ') {
+            int id = 0;
+            ok = readInteger(p, recordEnd, id);
+            if (ok) {
+                auto it = positions.find(id);
+                if (it != positions.end()) {
+                    deleted[it->second] = true;
+                    positions.erase(it);
+                }
+            }
+        }
+
+        if (ok) {
+            ++applied;
+        } else {
+            std::cerr << "Warning: Skipping malformed record in '" << filename << "'." << std::endl;
+        }
+        pos = lineEnd + 1;
+    }
+
+    // Drop deleted tasks in a single pass, keeping the order of the rest
+    size_t kept = 0;
+    for (size_t i = 0; i < tasks.size(); ++i) {
+        if (!deleted[i]) {
+            if (kept != i) {
+                tasks[kept] = std::move(tasks[i]);
+            }
+            ++kept;
+        }
+    }
+    tasks.resize(kept);
+    return applied;
+}
+
+/**
+ * \@brief Determines which storage backend this process uses
+ * The TASK_STORE environment variable ("json", "binary", "btree" or "lsm") selects it
+ * explicitly; otherwise the lsm store is used if tasks.lsm exists, the btree store if
+ * tasks.db exists, the binary store if tasks.bin exists, and JSON if none does
+ * \@return The active backend (decided once per process)
+ */
+StorageBackend activeStorageBackend() {
+    static const StorageBackend backend = []() {
+        const char* setting = std::getenv("TASK_STORE");
+        if (setting != nullptr && *setting != '\0') {
+            std::string name = setting;
+            if (name == "binary") {
+                return StorageBackend::BINARY;
+            } else if (name == "btree") {
+                return StorageBackend::PAGED;
+            } else if (name == "lsm") {
+                return StorageBackend::LSM;
+            } else if (name != "json") {
+                std::cerr << "Warning: Unknown TASK_STORE '" << name << "'. Using json." << std::endl;
+            }
+            return StorageBackend::JSON;
+        }
+        if (lsmStoreExists()) {
+            return StorageBackend::LSM;
+        } else if (pagedStoreExists()) {
+            return StorageBackend::PAGED;
+        }
+        return binaryStoreExists() ? StorageBackend::BINARY : StorageBackend::JSON;
+    }();
+    return backend;
+}
+
+/**
+ * \@brief Rebuilds the task list from the newest intact checkpoint and the log records after it
+ * Normally that is tasks.json plus tasks.log. If tasks.json is damaged (cut short by a
+ * crash before it reached the disk, say), the previous checkpoint is loaded instead,
+ * followed by the log that led from it to the damaged one and then the current log.
+ * Each log is bounded by the checkpoint threshold, so recovery reads at most one
+ * checkpoint and two logs' worth of records
+ * \@param nextId Output parameter: the recovered next-id counter
+ * \@param source Output parameter: the files the tasks were actually read from, for the
+ * "Loaded" message (a checkpoint, the logs replayed on top of it, or both)
+ * \@return The recovered tasks
+ */
+static std::vector<Task> recoverTasks(int& nextId, std::string& source) {
+    bool intact = true;
+    std::vector<Task> tasks = loadSnapshot(TASKS_FILE, nextId, intact);
+    if (intact) {
+        bool fromSnapshot = !tasks.empty();
+        bool fromLog = replayMutationLog(MUTATION_LOG_FILE, tasks, nextId) > 0;
+        source = fromSnapshot && fromLog ? TASKS_FILE + " and " + MUTATION_LOG_FILE
+               : fromLog ? MUTATION_LOG_FILE : TASKS_FILE;
+        return tasks;
+    }
+
+    newestCheckpointDamaged = true;
+    tasks = loadSnapshot(PREVIOUS_TASKS_FILE, nextId, intact);
+    if (!intact || fileSizeOf(PREVIOUS_TASKS_FILE) == 0) {
+        std::cerr << "Warning: No intact checkpoint. Rebuilding from the mutation logs alone." << std::endl;
+        tasks.clear();
+        nextId = 0;
+        source = "the mutation logs";
+    } else {
+        std::cerr << "Warning: Recovering from '" << PREVIOUS_TASKS_FILE << "' and the mutation logs." << std::endl;
+        source = PREVIOUS_TASKS_FILE;
+    }
+    size_t applied = replayMutationLog(PREVIOUS_MUTATION_LOG_FILE, tasks, nextId);
+    applied += replayMutationLog(MUTATION_LOG_FILE, tasks, nextId);
+    if (applied > 0 && source == PREVIOUS_TASKS_FILE) {
+        source += " and the mutation logs";
+    }
+    std::cerr << "Recovered " << tasks.size() << " task(s) (" << applied << " log record(s) replayed)." << std::endl;
+    return tasks;
+}
+
+/**
+ * \@brief Loads tasks from the active backend
+ * JSON: the newest intact checkpoint ("tasks.json", else "tasks.json.prev") plus the mutation log
+ * Binary: tasks.bin, memory-mapped. Btree: every leaf of tasks.db, in id order.
+ * Lsm: the runs named by tasks.lsm merged with the memtable rebuilt from its log.
+ * If the backend's file does not exist yet, the JSON files are read instead and
+ * the first save migrates them
+ * \@return The loaded tasks with their next-id counter. Files without a stored counter
+ * get one derived from the highest id (and store it from the next save on)
+ */
+TaskList loadTasks() {
+    std::vector<Task> tasks;
+    int nextId = 0;
+    std::string source = TASKS_FILE;
+    if (activeStorageBackend() == StorageBackend::BINARY && binaryStoreExists()) {
+        tasks = loadBinaryTasks(nextId);
+        source = "tasks.bin";
+    } else if (activeStorageBackend() == StorageBackend::PAGED && pagedStoreExists()) {
+        tasks = loadPagedTasks(nextId);
+        source = "tasks.db";
+    } else if (activeStorageBackend() == StorageBackend::LSM && lsmStoreExists()) {
+        tasks = loadLsmTasks(nextId);
+        source = "tasks.lsm";
+    } else {
+        tasks = recoverTasks(nextId, source);
+    }
+
+    // --- Final Output ---
+    // Only print the "Loaded..." message if tasks were actually parsed
+    if (!tasks.empty() && loadMessagesEnabled) {
+        std::cout << "Loaded " << tasks.size() << " task(s) from " << source << "." << std::endl;
+    }
+    return TaskList(std::move(tasks), nextId);
+}
+
+/**
+ * \@brief Records that a task was added or changed
+ * The change is buffered until commitTasks persists it
+ * \@param task The task in its new state
+ */
+void recordTaskChange(const Task& task) {
+    TaskChange change;
+    change.id = task.id;
+    change.deleted = false;
+    change.task = task;
+    pendingChanges.push_back(std::move(change));
+}
+
+/**
+ * \@brief Records that a task was deleted
+ * The change is buffered until commitTasks persists it
+ * \@param id The ID of the deleted task
+ */
+void recordTaskDeletion(int id) {
+    TaskChange change;
+    change.id = id;
+    change.deleted = true;
+    pendingChanges.push_back(std::move(change));
+}
+
+/**
+ * \@brief Records that the next commit should rewrite everything (take a checkpoint)
+ * The changes recorded so far are kept: the JSON checkpoint logs them before it
+ * replaces tasks.json, so the previous checkpoint plus its log still lead to the new one
+ */
+void recordFullRewrite() {
+    fullRewritePending = true;
+}
+
+/**
+ * \@brief Records that every task with an id at or above firstId was added in bulk
+ * Commands then stop recording those tasks one by one, so a large import does not
+ * hold a second copy of every task it added. The next commit takes a checkpoint,
+ * which logs them from the list itself, after the changes recorded one by one
+ * \@param firstId The id of the first task not recorded individually
+ */
+void recordTasksAddedFrom(int firstId) {
+    fullRewritePending = true;
+    if (bulkAddedFromId == 0 || firstId < bulkAddedFromId) {
+        bulkAddedFromId = firstId;
+    }
+}
+
+/**
+ * \@brief Drops the changes recorded since the last commit without persisting them
+ * Used after a failed commit by callers that keep running, before they load the
+ * tasks again. The lsm store is closed, so that load reads it back from disk
+ */
+void discardTaskChanges() {
+    std::vector<TaskChange>().swap(pendingChanges);
+    fullRewritePending = false;
+    bulkAddedFromId = 0;
+    closeLsmStore();
+}
+
+/**
+ * \@brief Controls the "Loaded N task(s)" message of loadTasks
+ * \@param enabled False for commands whose stdout is data, such as export
+ */
+void setLoadMessages(bool enabled) {
+    loadMessagesEnabled = enabled;
+}
+
+/**
+ * \@brief Sets the log size that makes commitTasks take a checkpoint
+ * \@param bytes The limit in bytes; 0 restores the default
+ */
+void setCheckpointLogLimit(long long bytes) {
+    checkpointLogLimit = bytes;
+}
+
+/**
+ * \@brief Appends one mutation log record, ending in the line's checksum
+ * \@param records The buffer to append to
+ * \@param id The ID of the affected task
+ * \@param task The task's new state, or null for a deletion
+ */
+static void appendLogRecord(std::string& records, int id, const Task* task) {
+    char checksum[9];
+    size_t start = records.size();
+    if (task == nullptr) {
+        records += "D " + std::to_string(id);
+    } else {
+        records += "U " + taskToJsonLine(*task);
+    }
+    formatChecksum(crc32(records.data() + start, records.size() - start), checksum);
+    records += " #";
+    records += checksum;
+    records += '\n';
+}
+
+/**
+ * \@brief Formats changes as mutation log records, one line each
+ * \@param changes The changes to format
+ * \@return The records, each terminated by a newline
+ */
+static std::string formatLogRecords(const std::vector<TaskChange>& changes) {
+    std::string records;
+    for (const auto& change : changes) {
+        appendLogRecord(records, change.id, change.deleted ? nullptr : &change.task);
+    }
+    return records;
+}
+
+/**
+ * \@brief Appends records to the mutation log in a single write
+ * \@param records Formatted records (see formatLogRecords)
+ * \@return True if all of them were written
+ */
+static bool appendLogRecords(const std::string& records) {
+    PhaseTimer writeTimer(StatsPhase::WRITE);
+    std::ofstream logFile(MUTATION_LOG_FILE, std::ios::binary | std::ios::app);
+    if (!logFile.is_open()) {
+        std::cerr << "Error: Could not open '" << MUTATION_LOG_FILE << "' for writing." << std::endl;
+        return false;
+    }
+    logFile.write(records.data(), records.size());
+    logFile.flush();
+    if (!logFile) {
+        std::cerr << "Error: Failed to write to '" << MUTATION_LOG_FILE << "'." << std::endl;
+        return false;
+    }
+    addBytesWritten(records.size());
+    return true;
+}
+
+/**
+ * \@brief Flushes a file's contents to disk
+ * \@return True once the data is durable
+ */
+static bool syncFile(const std::string& filename) {
+    int fd = open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    bool ok = fsync(fd) == 0;
+    close(fd);
+    return ok;
+}
+
+/**
+ * \@brief Makes renames and new links in the working directory durable
+ */
+static void syncWorkingDirectory() {
+    int dirFd = open(".", O_RDONLY | O_CLOEXEC);
+    if (dirFd >= 0) {
+        fsync(dirFd);
+        close(dirFd);
+    }
+}
+
+/**
+ * \@brief Keeps the checkpoint about to be replaced as tasks.json.prev
+ * Hard-linked under a temporary name and renamed over the old tasks.json.prev, so
+ * neither file is ever missing. A damaged tasks.json (the one loadTasks recovered
+ * from) is not kept; the older checkpoint stays instead
+ * \@return True if tasks.json.prev now holds the checkpoint being replaced
+ */
+static bool keepPreviousCheckpoint() {
+    if (newestCheckpointDamaged || fileSizeOf(TASKS_FILE) == 0) {
+        return false;
+    }
+    const std::string tempLink = PREVIOUS_TASKS_FILE + ".tmp";
+    std::remove(tempLink.c_str());
+    if (link(TASKS_FILE.c_str(), tempLink.c_str()) != 0 || std::rename(tempLink.c_str(), PREVIOUS_TASKS_FILE.c_str()) != 0) {
+        std::remove(tempLink.c_str());
+        return false;
+    }
+    return true;
+}
+
+/**
+ * \@brief Retires the mutation log once a new checkpoint is in place
+ * The log led from the replaced checkpoint to the new one, so it becomes tasks.log.prev
+ * when that checkpoint was kept. Otherwise tasks.json.prev is still the older one, and
+ * the log is appended to its log, which then leads up to the new checkpoint as well
+ * Replaying records twice is harmless, so a crash in between loses nothing
+ * \@param previousKept What keepPreviousCheckpoint returned
+ */
+static void retireMutationLog(bool previousKept) {
+    if (previousKept) {
+        std::remove(PREVIOUS_MUTATION_LOG_FILE.c_str());
+        if (std::rename(MUTATION_LOG_FILE.c_str(), PREVIOUS_MUTATION_LOG_FILE.c_str()) == 0 || errno == ENOENT) {
+            return;
+        }
+    } else {
+        std::string log;
+        if (!readWholeFile(MUTATION_LOG_FILE, log) || log.empty()) {
+            return;
+        }
+        std::ofstream previousLog(PREVIOUS_MUTATION_LOG_FILE, std::ios::binary | std::ios::app);
+        previousLog.write(log.data(), log.size());
+        previousLog.flush();
+        if (previousLog) {
+            addBytesWritten(log.size());
+        }
+    }
+    std::remove(MUTATION_LOG_FILE.c_str());
+}
+
+/**
+ * \@brief Persists the changes recorded since the last commit
+ * JSON: appends them to the mutation log in a single write, each record with its
+ * checksum. Once the log outgrows its threshold, a checkpoint is taken instead: a
+ * fresh snapshot of all tasks, after which a new log is started
+ * Binary: rewrites only the affected slots of tasks.bin, falling back to a full
+ * rewrite when the slot region is full or the heap is mostly garbage
+ * Btree: puts and erases each change in the tree of tasks.db and commits the
+ * touched pages through its journal, falling back to a full rewrite if it fails
+ * Lsm: appends them to the log and the memtable, which is flushed to a new run
+ * once its log is full; a full rewrite only happens if that fails
+ * The next-id counter needs no record of its own: every "U" record of a new
+ * task carries its id, and replay raises the counter past it
+ * \@param tasks The full, current task list (only used when rewriting everything)
+ */
+bool commitTasks(const TaskList& tasks) {
+    if (fullRewritePending) {
+        return saveTasks(tasks); // Cheaper than one record per task, and holds no copies
+    }
+    if (pendingChanges.empty()) {
+        return true; // Nothing changed
+    }
+    size_t changeCount = pendingChanges.size();
+
+    if (activeStorageBackend() == StorageBackend::BINARY) {
+        if (!applyBinaryChanges(pendingChanges, tasks.nextId())) {
+            return saveTasks(tasks);
+        }
+        std::cout << "Saved " << changeCount << " change(s) to tasks.bin." << std::endl;
+        pendingChanges.clear();
+        return true;
+    }
+
+    if (activeStorageBackend() == StorageBackend::PAGED) {
+        if (!applyPagedChanges(pendingChanges, tasks.nextId())) {
+            return saveTasks(tasks);
+        }
+        std::cout << "Saved " << changeCount << " change(s) to tasks.db." << std::endl;
+        pendingChanges.clear();
+        return true;
+    }
+
+    if (activeStorageBackend() == StorageBackend::LSM) {
+        if (!applyLsmChanges(pendingChanges, tasks.nextId())) {
+            return saveTasks(tasks);
+        }
+        std::cout << "Saved " << changeCount << " change(s) to tasks.lsm." << std::endl;
+        pendingChanges.clear();
+        return true;
+    }
+
+    auto serializeStart = std::chrono::steady_clock::now();
+    std::string records = formatLogRecords(pendingChanges);
+    addPhaseTime(StatsPhase::SERIALIZE, std::chrono::steady_clock::now() - serializeStart);
+
+    long long logSize = fileSizeOf(MUTATION_LOG_FILE) + static_cast<long long>(records.size());
+    long long threshold = checkpointLogLimit > 0 ? checkpointLogLimit
+                        : std::max(LOG_COMPACT_MIN_BYTES, fileSizeOf(TASKS_FILE) / LOG_COMPACT_SNAPSHOT_DIVISOR);
+    if (logSize > threshold) {
+        return saveTasks(tasks); // Checkpoint: the snapshot supersedes the log and the pending changes
+    }
+
+    if (!appendLogRecords(records)) {
+        return false;
+    }
+    std::cout << "Saved " << changeCount << " change(s) to " << MUTATION_LOG_FILE << "." << std::endl;
+    pendingChanges.clear();
+    return true;
+}
+
+/**
+ * \@brief Saves the provided vector of tasks to the specified JSON file ("tasks.json")
+ * (or to tasks.bin, tasks.db or tasks.lsm when another backend is active)
+ * Overwrites the file if it exists. Creates it if it doesn't
+ * Formats the output as a JSON array of task objects, preceded by its checksum
+ * This is a checkpoint: the pending changes (and tasks added in bulk) are logged first, the snapshot is synced
+ * to disk before it replaces tasks.json, and the checkpoint it replaces is kept as
+ * tasks.json.prev together with its log (tasks.log.prev), so a damaged tasks.json can
+ * be rebuilt. The new snapshot then starts an empty mutation log
+ * \@param tasks The list of tasks to save, including its next-id counter
+ * \@return True if the snapshot was written, false otherwise
+ */
+bool saveTasks(const TaskList& tasks) {
+    if (activeStorageBackend() != StorageBackend::JSON) {
+        std::vector<const Task*> live;
+        live.reserve(tasks.size());
+        for (size_t row : tasks.liveRows()) {
+            live.push_back(&tasks.taskAt(row));
+        }
+        StorageBackend backend = activeStorageBackend();
+        bool saved = backend == StorageBackend::PAGED ? savePagedTasks(std::move(live), tasks.nextId())
+                   : backend == StorageBackend::LSM ? saveLsmTasks(std::move(live), tasks.nextId())
+                   : saveBinaryTasks(std::move(live), tasks.nextId());
+        if (saved) {
+            pendingChanges.clear();
+            fullRewritePending = false;
+            bulkAddedFromId = 0;
+            const char* filename = backend == StorageBackend::PAGED ? "tasks.db"
+                                 : backend == StorageBackend::LSM ? "tasks.lsm" : "tasks.bin";
+            std::cout << "Saved " << tasks.size() << " task(s) to " << filename << "." << std::endl;
+        }
+        return saved;
+    }
+
+    const std::string& filename = TASKS_FILE;
+
+    // Log the pending changes first, so the checkpoint being replaced plus its log
+    // still lead to this one; without them it could not be rebuilt, so no checkpoint
+    if (!pendingChanges.empty() && !appendLogRecords(formatLogRecords(pendingChanges))) {
+        return false;
+    }
+    // Then the tasks added in bulk, in their current state (later than any recorded
+    // change), a bounded number of records per write
+    if (bulkAddedFromId != 0) {
+        std::string records;
+        for (size_t row = 0; row < tasks.slotCount(); ++row) {
+            if (tasks.isLive(row) && tasks.idAt(row) >= bulkAddedFromId) {
+                appendLogRecord(records, tasks.idAt(row), &tasks.taskAt(row));
+            }
+            if ((records.size() >= BULK_LOG_WRITE_BYTES || row + 1 == tasks.slotCount()) && !records.empty()) {
+                if (!appendLogRecords(records)) {
+                    return false;
+                }
+                records.clear();
+            }
+        }
+    }
+
+    // Format the whole snapshot into one buffer, then write it with a single call
+    auto serializeStart = std::chrono::steady_clock::now();
+    std::string snapshot;
+    snapshot.reserve(tasks.size() * SNAPSHOT_BYTES_PER_TASK_ESTIMATE + 96);
+
+    // The snapshot object: the counter and the checksum (filled in last) first,
+    // then the opening bracket for the JSON array
+    snapshot += "{\n\"nextId\": ";
+    snapshot += std::to_string(tasks.nextId());
+    snapshot += ",\n\"checksum\": \"";
+    size_t checksumAt = snapshot.size();
+    snapshot += "00000000\",\n\"tasks\": ";
+    size_t arrayStart = snapshot.size();
+    snapshot += "[\n";
+
+    // Append each task as a JSON object
+    char createdStamp[TIMESTAMP_BUFFER_SIZE];
+    char updatedStamp[TIMESTAMP_BUFFER_SIZE];
+    bool first = true;
+    for (size_t row = 0; row < tasks.slotCount(); ++row) {
+        if (!tasks.isLive(row)) {
+            continue; // Tombstones of deleted tasks are not saved
+        }
+        const Task& task = tasks.taskAt(row);
+
+        // Separate the objects with commas
+        if (!first) {
+            snapshot += ",\n";
+        }
+        first = false;
+        snapshot += " {\n   \"id\": ";
+        snapshot += std::to_string(task.id);
+        snapshot += ",\n   \"description\": \"";
+        appendJsonEscaped(snapshot, task.description.data(), task.description.size());
+        snapshot += "\",\n   \"status\": \"";
+        snapshot += statusToString(task.status);
+        snapshot += "\",\n   \"createdAt\": \"";
+        snapshot.append(createdStamp, formatTimestamp(task.createdAt, createdStamp));
+        snapshot += "\",\n   \"updatedAt\": \"";
+        snapshot.append(updatedStamp, formatTimestamp(task.updatedAt, updatedStamp));
+        snapshot += "\"\n }";
+    }
+    if (!first) {
+        snapshot += '\n';
+    }
+
+    // The closing bracket for the JSON array and the snapshot object
+    snapshot += "]\n}\n";
+    char checksum[9];
+    formatChecksum(crc32(snapshot.data() + arrayStart, snapshot.size() - arrayStart), checksum);
+    snapshot.replace(checksumAt, 8, checksum, 8);
+    addPhaseTime(StatsPhase::SERIALIZE, std::chrono::steady_clock::now() - serializeStart);
+
+    // Write and sync a temporary file and rename it over the snapshot, so readers
+    // (and a crash mid-write) only ever see the old or the new snapshot
+    {
+        PhaseTimer writeTimer(StatsPhase::WRITE);
+        const std::string tempFile = filename + ".tmp";
+        std::ofstream outputFile(tempFile, std::ios::binary);
+
+        // Check if the file stream was opened successfully
+        if (!outputFile.is_open()) {
+            std::cerr << "Error: Could not open '" << tempFile << "' for writing." << std::endl;
+            return false; // Exit if file can't be opened
+        }
+        outputFile.write(snapshot.data(), snapshot.size());
+        outputFile.close();
+        if (!outputFile || !syncFile(tempFile)) {
+            std::cerr << "Error: Failed to write '" << filename << "'." << std::endl;
+            std::remove(tempFile.c_str());
+            return false; // Keep the log: it is still needed on top of the old snapshot
+        }
+        bool previousKept = keepPreviousCheckpoint();
+        if (std::rename(tempFile.c_str(), filename.c_str()) != 0) {
+            std::cerr << "Error: Failed to write '" << filename << "'." << std::endl;
+            std::remove(tempFile.c_str());
+            return false;
+        }
+        addBytesWritten(snapshot.size());
+        syncWorkingDirectory();
+
+        // The snapshot now contains every change, so the log only serves the previous checkpoint
+        retireMutationLog(previousKept);
+    }
+
+    newestCheckpointDamaged = false;
+    pendingChanges.clear();
+    fullRewritePending = false;
+    bulkAddedFromId = 0;
+
+    std::cout << "Saved " << tasks.size() << " task(s) to " << filename << "." << std::endl;
+    return true;
+}
+
+bool lockTaskStore(StoreLockMode mode) {
+    if (lockFd >= 0) {
+        return true; // Already held
+    }
+    int fd = open(LOCK_FILE.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        std::cerr << "Error: Could not open '" << LOCK_FILE << "': " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    int operation = (mode == StoreLockMode::EXCLUSIVE ? LOCK_EX : LOCK_SH) | LOCK_NB;
+    auto start = std::chrono::steady_clock::now();
+    std::chrono::microseconds delay = LOCK_RETRY_MIN_DELAY;
+    size_t attempts = 1;
+    while (flock(fd, operation) != 0) {
+        if (errno != EWOULDBLOCK && errno != EINTR) {
+            std::cerr << "Error: Could not lock '" << LOCK_FILE << "': " << std::strerror(errno) << std::endl;
+            close(fd);
+            return false;
+        }
+        if (std::chrono::steady_clock::now() - start >= LOCK_TIMEOUT) {
+            std::cerr << "Error: Timed out after " << LOCK_TIMEOUT.count() << " ms waiting for '" << LOCK_FILE
+                      << "' (another task-cli process, or a daemon, holds it)." << std::endl;
+            close(fd);
+            return false;
+        }
+        std::this_thread::sleep_for(delay);
+        delay = std::min(delay * 2, LOCK_RETRY_MAX_DELAY);
+        ++attempts;
+    }
+    addPhaseTime(StatsPhase::LOCK, std::chrono::steady_clock::now() - start);
+
+    // Report contention so slow CI runs can be attributed to it
+    if (attempts > 1) {
+        std::chrono::duration<double, std::milli> waited = std::chrono::steady_clock::now() - start;
+        std::cerr << "Waited " << waited.count() << " ms for '" << LOCK_FILE << "' (" << attempts << " attempts)." << std::endl;
+    }
+    lockFd = fd;
+    lockMode = mode;
+    return true;
+}
+
+bool storeRepairAllowed() {
+    return lockFd < 0 || lockMode == StoreLockMode::EXCLUSIVE;
+}
+
+void unlockTaskStore() {
+    closeLsmStore(); // A merge still running must finish while the lock is held
+    if (lockFd >= 0) {
+        close(lockFd); // Closing the descriptor releases the flock
+        lockFd = -1;
+    }
+}
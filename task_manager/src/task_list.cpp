@@ -0,0 +1,400 @@
+#include "task_list.h"
+#include <vector>
+#include <utility> // For std::move
+#include <algorithm> // For std::max
+
+/**
+ * \@brief Takes ownership of loaded tasks and builds the id index
+ * \@param tasks The tasks, in the order they were loaded
+ * \@param nextId The persisted next-id counter (0 if the file had none)
+ */
+TaskList::TaskList(std::vector<Task> tasks, int nextId)
+    : items(std::move(tasks)), nextIdCounter(std::max(nextId, 1)) {
+    positions.reserve(items.size());
+    for (size_t i = 0; i < items.size(); ++i) {
+        positions[items[i].id] = i;
+        addStatusBit(i, items[i].status);
+        nextIdCounter = std::max(nextIdCounter, items[i].id + 1);
+    }
+}
+
+/**
+ * \@brief Looks up a task by id
+ * \@param id The ID of the task to find
+ * \@return Pointer to the task, or nullptr if there is none with this id
+ */
+Task* TaskList::find(int id) {
+    auto it = positions.find(id);
+    return it != positions.end() ? &items[it->second] : nullptr;
+}
+
+const Task* TaskList::find(int id) const {
+    auto it = positions.find(id);
+    return it != positions.end() ? &items[it->second] : nullptr;
+}
+
+/**
+ * \@brief Appends a task and indexes it, advancing the next-id counter past its id
+ * \@param task The task to add (its id must not be in the list yet)
+ * \@return Reference to the stored task
+ */
+Task& TaskList::add(Task task) {
+    nextIdCounter = std::max(nextIdCounter, task.id + 1);
+    positions[task.id] = items.size();
+    addStatusBit(items.size(), task.status);
+    if (searchIndexBuilt) {
+        searchIndex.add(task.id, task.description);
+    }
+    if (timeIndexesBuilt) {
+        createdIndex.add(TimeIndex::keyOf(task.createdAt), task.id);
+        updatedIndex.add(TimeIndex::keyOf(task.updatedAt), task.id);
+    }
+    items.push_back(std::move(task));
+    return items.back();
+}
+
+/**
+ * \@brief Removes a task by id, leaving a tombstone in its row
+ * Nothing after the row moves, so a delete is O(1) apart from the occasional
+ * compaction, whose cost is spread over the deletes that triggered it
+ * \@param id The ID of the task to remove
+ * \@return True if the task was found and removed, false otherwise
+ */
+bool TaskList::remove(int id) {
+    auto it = positions.find(id);
+    if (it == positions.end()) {
+        return false;
+    }
+    size_t position = it->second;
+    positions.erase(it);
+    if (searchIndexBuilt) {
+        searchIndex.remove(id, items[position].description);
+    }
+    retireTimeEntries();
+    markDeleted(position);
+    compactIfWorthIt();
+    return true;
+}
+
+/**
+ * \@brief Removes many tasks, leaving a tombstone in each of their rows
+ * \@param rows The rows to remove (live), ascending and without duplicates
+ */
+void TaskList::removeRows(const std::vector<size_t>& rows) {
+    for (size_t row : rows) {
+        positions.erase(items[row].id);
+        if (searchIndexBuilt) {
+            searchIndex.remove(items[row].id, items[row].description);
+        }
+        retireTimeEntries();
+        markDeleted(row);
+    }
+    compactIfWorthIt();
+}
+
+/**
+ * \@brief The rows of every live task, in insertion order
+ * Walks the union of the status bitmaps, so tombstones cost one bit each
+ * \@return Row numbers (valid until the list is next modified)
+ */
+std::vector<size_t> TaskList::liveRows() const {
+    std::vector<size_t> rows;
+    rows.reserve(size());
+    for (size_t word = 0; word < statusBits[0].size(); ++word) {
+        uint64_t remaining = 0;
+        for (const auto& bits : statusBits) {
+            remaining |= bits[word];
+        }
+        while (remaining != 0) {
+            rows.push_back(word * 64 + static_cast<size_t>(__builtin_ctzll(remaining)));
+            remaining &= remaining - 1; // Clear the lowest set bit
+        }
+    }
+    return rows;
+}
+
+/**
+ * \@brief Drops the tombstones, moving the live tasks down and renumbering their rows
+ * Every live task after the first tombstone moves once, so the pass is O(n)
+ * \@return Number of tombstones removed
+ */
+size_t TaskList::compact() {
+    if (tombstones == 0) {
+        return 0;
+    }
+    size_t kept = 0;
+    for (size_t i = 0; i < items.size(); ++i) {
+        if (!isLive(i)) {
+            continue;
+        }
+        if (kept != i) {
+            items[kept] = std::move(items[i]);
+            positions[items[kept].id] = kept;
+        }
+        ++kept;
+    }
+    items.resize(kept);
+    size_t removed = tombstones;
+    tombstones = 0;
+    rebuildStatusBits();
+    return removed;
+}
+
+/**
+ * \@brief Replaces a task's description, keeping the search index in sync
+ * \@param id The ID of the task to change
+ * \@param description The new description
+ * \@param updatedAt The new last-update time
+ * \@return True if the task was found and changed, false otherwise
+ */
+bool TaskList::updateDescription(int id, const std::string& description, std::chrono::system_clock::time_point updatedAt) {
+    Task* task = find(id);
+    if (task == nullptr) {
+        return false;
+    }
+    if (searchIndexBuilt) {
+        searchIndex.remove(id, task->description);
+        searchIndex.add(id, description);
+    }
+    noteUpdated(*task, updatedAt);
+    task->description = description;
+    task->updatedAt = updatedAt;
+    return true;
+}
+
+/**
+ * \@brief Finds the tasks whose descriptions contain every term of the query
+ * The first call indexes every description; later calls only query the index
+ * \@param query The search text; words are matched whole and case-insensitively
+ * \@return Matching task ids in ascending order
+ */
+std::vector<int> TaskList::search(const std::string& query) {
+    buildSearchIndex();
+    return searchIndex.search(query);
+}
+
+/**
+ * \@brief Upper bound on the number of tasks search(query) returns, without running it
+ * \@param query The search text
+ * \@return Length of the shortest posting list among the query's terms
+ */
+size_t TaskList::searchEstimate(const std::string& query) {
+    buildSearchIndex();
+    return searchIndex.estimate(query);
+}
+
+/**
+ * \@brief Indexes every live description, the first time something searches
+ */
+void TaskList::buildSearchIndex() {
+    if (searchIndexBuilt) {
+        return;
+    }
+    for (size_t i = 0; i < items.size(); ++i) {
+        if (isLive(i)) {
+            searchIndex.add(items[i].id, items[i].description);
+        }
+    }
+    searchIndexBuilt = true;
+}
+
+/**
+ * \@brief The rows of the live tasks whose created or updated time is in [low, high)
+ * Walks the index entries in range and skips the stale ones (deleted tasks, or
+ * an updatedAt that has moved on), which stay a minority thanks to rebuilds
+ * \@param field The timestamp to range over
+ * \@param low Inclusive lower bound (a TimeIndex::keyOf key)
+ * \@param high Exclusive upper bound
+ * \@return Row numbers in time order (valid until the list is next modified)
+ */
+std::vector<size_t> TaskList::rowsInTimeRange(TimeField field, long long low, long long high) {
+    const TimeEntry* first;
+    const TimeEntry* last;
+    timeIndex(field).range(low, high, first, last);
+    std::vector<size_t> rows;
+    rows.reserve(static_cast<size_t>(last - first));
+    for (const TimeEntry* entry = first; entry != last; ++entry) {
+        auto it = positions.find(entry->id);
+        if (it == positions.end()) {
+            continue; // Deleted
+        }
+        const Task& task = items[it->second];
+        if (TimeIndex::keyOf(field == TimeField::CREATED ? task.createdAt : task.updatedAt) == entry->key) {
+            rows.push_back(it->second);
+        }
+    }
+    return rows;
+}
+
+/**
+ * \@brief Upper bound on the number of rows rowsInTimeRange returns, in O(log N)
+ * \@return Index entries in range, stale ones included
+ */
+size_t TaskList::timeRangeEstimate(TimeField field, long long low, long long high) {
+    const TimeEntry* first;
+    const TimeEntry* last;
+    timeIndex(field).range(low, high, first, last);
+    return static_cast<size_t>(last - first);
+}
+
+/**
+ * \@brief The index for a field, built on first use and rebuilt once mostly stale
+ */
+TimeIndex& TaskList::timeIndex(TimeField field) {
+    if (!timeIndexesBuilt) {
+        rebuildTimeIndex(TimeField::CREATED);
+        rebuildTimeIndex(TimeField::UPDATED);
+        timeIndexesBuilt = true;
+    }
+    TimeIndex& index = field == TimeField::CREATED ? createdIndex : updatedIndex;
+    if (index.needsRebuild()) {
+        rebuildTimeIndex(field);
+    }
+    return index;
+}
+
+/**
+ * \@brief Re-indexes one timestamp of every live task
+ * Rows are usually in creation order already, so the created index comes out sorted
+ */
+void TaskList::rebuildTimeIndex(TimeField field) {
+    TimeIndex& index = field == TimeField::CREATED ? createdIndex : updatedIndex;
+    index.reset(size());
+    for (size_t i = 0; i < items.size(); ++i) {
+        if (isLive(i)) {
+            index.add(TimeIndex::keyOf(field == TimeField::CREATED ? items[i].createdAt : items[i].updatedAt), items[i].id);
+        }
+    }
+}
+
+/**
+ * \@brief Notes that a deleted task's entries in both time indexes are now stale
+ */
+void TaskList::retireTimeEntries() {
+    if (timeIndexesBuilt) {
+        createdIndex.markStale();
+        updatedIndex.markStale();
+    }
+}
+
+/**
+ * \@brief Moves a task's updated-index entry to its new time (call before storing it)
+ */
+void TaskList::noteUpdated(const Task& task, std::chrono::system_clock::time_point updatedAt) {
+    if (timeIndexesBuilt && updatedAt != task.updatedAt) {
+        updatedIndex.markStale();
+        updatedIndex.add(TimeIndex::keyOf(updatedAt), task.id);
+    }
+}
+
+/**
+ * \@brief Changes a task's status, keeping the status bitmaps and counts in sync
+ * \@param id The ID of the task to change
+ * \@param status The new status
+ * \@param updatedAt The new last-update time
+ * \@return True if the task was found and changed, false otherwise
+ */
+bool TaskList::updateStatus(int id, TaskStatus status, std::chrono::system_clock::time_point updatedAt) {
+    auto it = positions.find(id);
+    if (it == positions.end()) {
+        return false;
+    }
+    size_t position = it->second;
+    Task& task = items[position];
+    size_t from = static_cast<size_t>(task.status);
+    size_t to = static_cast<size_t>(status);
+    uint64_t bit = uint64_t(1) << (position % 64);
+    statusBits[from][position / 64] &= ~bit;
+    statusBits[to][position / 64] |= bit;
+    --statusCounts[from];
+    ++statusCounts[to];
+    noteUpdated(task, updatedAt);
+    task.status = status;
+    task.updatedAt = updatedAt;
+    return true;
+}
+
+/**
+ * \@brief The rows of the tasks with the given status, in insertion order
+ * \@param status The status to select
+ * \@return Row numbers (valid until the list is next modified)
+ */
+std::vector<size_t> TaskList::rowsWithStatus(TaskStatus status) const {
+    const std::vector<uint64_t>& bits = statusBits[static_cast<size_t>(status)];
+    std::vector<size_t> rows;
+    rows.reserve(countWithStatus(status));
+    for (size_t word = 0; word < bits.size(); ++word) {
+        uint64_t remaining = bits[word];
+        while (remaining != 0) {
+            rows.push_back(word * 64 + static_cast<size_t>(__builtin_ctzll(remaining)));
+            remaining &= remaining - 1; // Clear the lowest set bit
+        }
+    }
+    return rows;
+}
+
+/**
+ * \@brief Looks up the row of a task by id
+ * \@param id The ID of the task to find
+ * \@param row Output parameter: the task's row, if found
+ * \@return True if there is a task with this id
+ */
+bool TaskList::findRow(int id, size_t& row) const {
+    auto it = positions.find(id);
+    if (it == positions.end()) {
+        return false;
+    }
+    row = it->second;
+    return true;
+}
+
+/**
+ * \@brief Sets the bit for the task at a position at or past the end of the bitmaps' used range
+ * Positions are added in increasing order (on load and on append)
+ */
+void TaskList::addStatusBit(size_t position, TaskStatus status) {
+    if (position / 64 >= statusBits[0].size()) {
+        for (auto& bits : statusBits) {
+            bits.push_back(0);
+        }
+    }
+    statusBits[static_cast<size_t>(status)][position / 64] |= uint64_t(1) << (position % 64);
+    ++statusCounts[static_cast<size_t>(status)];
+}
+
+/**
+ * \@brief Recomputes the status bitmaps and counts from the tasks (after a compaction,
+ * when every row is live)
+ */
+void TaskList::rebuildStatusBits() {
+    for (size_t status = 0; status < TASK_STATUS_COUNT; ++status) {
+        statusBits[status].assign((items.size() + 63) / 64, 0);
+        statusCounts[status] = 0;
+    }
+    for (size_t i = 0; i < items.size(); ++i) {
+        size_t status = static_cast<size_t>(items[i].status);
+        statusBits[status][i / 64] |= uint64_t(1) << (i % 64);
+        ++statusCounts[status];
+    }
+}
+
+/**
+ * \@brief Turns a live row into a tombstone (its id and search entries must already be gone)
+ * Clears the row's status bit and frees its description; the slot stays in place
+ */
+void TaskList::markDeleted(size_t position) {
+    size_t status = static_cast<size_t>(items[position].status);
+    statusBits[status][position / 64] &= ~(uint64_t(1) << (position % 64));
+    --statusCounts[status];
+    std::string().swap(items[position].description);
+    ++tombstones;
+}
+
+/**
+ * \@brief Compacts once the tombstones pass the TOMBSTONE_COMPACT_* threshold
+ */
+void TaskList::compactIfWorthIt() {
+    if (tombstones >= TOMBSTONE_COMPACT_MIN && tombstones * TOMBSTONE_COMPACT_DIVISOR > items.size()) {
+        compact();
+    }
+}
@@ -0,0 +1,428 @@
+#include "task_table.h"
+#include <vector>
+#include <string>
+#include <algorithm> // For std::max
+
+// The arena is compacted once this much of it, and at least half of it, is unreferenced
+const size_t ARENA_COMPACT_MIN_GARBAGE = 64 * 1024;
+
+/**
+ * \@brief Copies tasks into the table's columns and arena
+ * \@param tasks The tasks, in the order they were loaded
+ * \@param nextId The persisted next-id counter; raised past the highest id if needed
+ */
+TaskTable::TaskTable(const std::vector<Task>& tasks, int nextId) : nextIdCounter(std::max(nextId, 1)) {
+    size_t textBytes = 0;
+    for (const auto& task : tasks) {
+        textBytes += task.description.size();
+    }
+    ids.reserve(tasks.size());
+    statuses.reserve(tasks.size());
+    createdTimes.reserve(tasks.size());
+    updatedTimes.reserve(tasks.size());
+    descriptionOffsets.reserve(tasks.size());
+    descriptionLengths.reserve(tasks.size());
+    arena.reserve(textBytes);
+    rowsById.reserve(tasks.size());
+    for (const auto& task : tasks) {
+        add(task);
+    }
+}
+
+/**
+ * \@brief Rebuilds the live tasks as Task records (for saving)
+ * \@return The tasks, in insertion order
+ */
+std::vector<Task> TaskTable::toTasks() const {
+    std::vector<Task> tasks;
+    tasks.reserve(size());
+    for (size_t row = 0; row < ids.size(); ++row) {
+        if (isLive(row)) {
+            tasks.push_back(taskAt(row));
+        }
+    }
+    return tasks;
+}
+
+/**
+ * \@brief Materializes one row as a Task record
+ * \@param row The row (must be < size())
+ * \@return A copy of the task
+ */
+Task TaskTable::taskAt(size_t row) const {
+    TextRef description = descriptionAt(row);
+    return Task(ids[row], std::string(description.data, description.size), statusAt(row),
+                createdTimes[row], updatedTimes[row]);
+}
+
+/**
+ * \@brief Appends a task, advancing the next-id counter past its id
+ * \@param task The task to add (its id must not be in the table yet)
+ */
+void TaskTable::add(const Task& task) {
+    nextIdCounter = std::max(nextIdCounter, task.id + 1);
+    rowsById[task.id] = ids.size();
+    ids.push_back(task.id);
+    statuses.push_back(static_cast<uint8_t>(task.status));
+    createdTimes.push_back(task.createdAt);
+    updatedTimes.push_back(task.updatedAt);
+    appendDescription(task.description);
+    ++statusCounts[static_cast<size_t>(task.status)];
+    if (searchIndexBuilt) {
+        searchIndex.add(task.id, task.description);
+    }
+    if (timeIndexesBuilt) {
+        createdIndex.add(TimeIndex::keyOf(task.createdAt), task.id);
+        updatedIndex.add(TimeIndex::keyOf(task.updatedAt), task.id);
+    }
+}
+
+/**
+ * \@brief Removes a task by id, leaving a tombstone in its row
+ * No column shifts; the description's arena bytes become garbage
+ * \@param id The ID of the task to remove
+ * \@return True if the task was found and removed, false otherwise
+ */
+bool TaskTable::remove(int id) {
+    auto it = rowsById.find(id);
+    if (it == rowsById.end()) {
+        return false;
+    }
+    size_t row = it->second;
+    rowsById.erase(it);
+    if (searchIndexBuilt) {
+        TextRef description = descriptionAt(row);
+        searchIndex.remove(id, std::string(description.data, description.size));
+    }
+    retireTimeEntries();
+    markDeleted(row);
+    compactIfWorthIt();
+    compactArena();
+    return true;
+}
+
+/**
+ * \@brief Removes many tasks, leaving a tombstone in each of their rows
+ * \@param rows The rows to remove (live), ascending and without duplicates
+ */
+void TaskTable::removeRows(const std::vector<size_t>& rows) {
+    for (size_t row : rows) {
+        rowsById.erase(ids[row]);
+        if (searchIndexBuilt) {
+            TextRef description = descriptionAt(row);
+            searchIndex.remove(ids[row], std::string(description.data, description.size));
+        }
+        retireTimeEntries();
+        markDeleted(row);
+    }
+    compactIfWorthIt();
+    compactArena();
+}
+
+/**
+ * \@brief The rows of every live task, in insertion order
+ * \@return Row numbers (valid until the table is next modified)
+ */
+std::vector<size_t> TaskTable::liveRows() const {
+    // Branch-free, like rowsWithStatus
+    std::vector<size_t> rows(size() + 1);
+    size_t matched = 0;
+    for (size_t row = 0; row < statuses.size(); ++row) {
+        rows[matched] = row;
+        matched += statuses[row] != DELETED_STATUS;
+    }
+    rows.resize(matched);
+    return rows;
+}
+
+/**
+ * \@brief Drops the tombstones, moving the live rows down and renumbering them
+ * Each column is compacted once
+ * \@return Number of tombstones removed
+ */
+size_t TaskTable::compact() {
+    if (tombstones == 0) {
+        return 0;
+    }
+    size_t kept = 0;
+    for (size_t i = 0; i < ids.size(); ++i) {
+        if (statuses[i] == DELETED_STATUS) {
+            continue;
+        }
+        if (kept != i) {
+            ids[kept] = ids[i];
+            statuses[kept] = statuses[i];
+            createdTimes[kept] = createdTimes[i];
+            updatedTimes[kept] = updatedTimes[i];
+            descriptionOffsets[kept] = descriptionOffsets[i];
+            descriptionLengths[kept] = descriptionLengths[i];
+            rowsById[ids[kept]] = kept;
+        }
+        ++kept;
+    }
+    ids.resize(kept);
+    statuses.resize(kept);
+    createdTimes.resize(kept);
+    updatedTimes.resize(kept);
+    descriptionOffsets.resize(kept);
+    descriptionLengths.resize(kept);
+    size_t removed = tombstones;
+    tombstones = 0;
+    return removed;
+}
+
+/**
+ * \@brief Replaces a task's description; the new text is appended to the arena
+ * \@param id The ID of the task to change
+ * \@param description The new description
+ * \@param updatedAt The new last-update time
+ * \@return True if the task was found and changed, false otherwise
+ */
+bool TaskTable::updateDescription(int id, const std::string& description, std::chrono::system_clock::time_point updatedAt) {
+    size_t row = 0;
+    if (!findRow(id, row)) {
+        return false;
+    }
+    if (searchIndexBuilt) {
+        TextRef old = descriptionAt(row);
+        searchIndex.remove(id, std::string(old.data, old.size));
+        searchIndex.add(id, description);
+    }
+    arenaGarbage += descriptionLengths[row];
+    descriptionOffsets[row] = arena.size();
+    descriptionLengths[row] = static_cast<uint32_t>(description.size());
+    arena += description;
+    noteUpdated(row, updatedAt);
+    updatedTimes[row] = updatedAt;
+    compactArena();
+    return true;
+}
+
+/**
+ * \@brief Changes a task's status, keeping the status counts in sync
+ * \@param id The ID of the task to change
+ * \@param status The new status
+ * \@param updatedAt The new last-update time
+ * \@return True if the task was found and changed, false otherwise
+ */
+bool TaskTable::updateStatus(int id, TaskStatus status, std::chrono::system_clock::time_point updatedAt) {
+    size_t row = 0;
+    if (!findRow(id, row)) {
+        return false;
+    }
+    --statusCounts[statuses[row]];
+    ++statusCounts[static_cast<size_t>(status)];
+    statuses[row] = static_cast<uint8_t>(status);
+    noteUpdated(row, updatedAt);
+    updatedTimes[row] = updatedAt;
+    return true;
+}
+
+/**
+ * \@brief The rows of the tasks with the given status, in insertion order
+ * \@param status The status to select
+ * \@return Row numbers (valid until the table is next modified)
+ */
+std::vector<size_t> TaskTable::rowsWithStatus(TaskStatus status) const {
+    // Branch-free: every row is written, but the cursor only advances on a match
+    // (one spare slot absorbs the writes after the last match)
+    std::vector<size_t> rows(countWithStatus(status) + 1);
+    uint8_t wanted = static_cast<uint8_t>(status);
+    size_t matched = 0;
+    for (size_t row = 0; row < statuses.size(); ++row) {
+        rows[matched] = row;
+        matched += statuses[row] == wanted;
+    }
+    rows.resize(matched);
+    return rows;
+}
+
+/**
+ * \@brief Looks up the row of a task by id
+ * \@param id The ID of the task to find
+ * \@param row Output parameter: the task's row, if found
+ * \@return True if there is a task with this id
+ */
+bool TaskTable::findRow(int id, size_t& row) const {
+    auto it = rowsById.find(id);
+    if (it == rowsById.end()) {
+        return false;
+    }
+    row = it->second;
+    return true;
+}
+
+/**
+ * \@brief Finds the tasks whose descriptions contain every term of the query
+ * \@param query The search text; words are matched whole and case-insensitively
+ * \@return Matching task ids in ascending order
+ */
+std::vector<int> TaskTable::search(const std::string& query) {
+    buildSearchIndex();
+    return searchIndex.search(query);
+}
+
+/**
+ * \@brief Upper bound on the number of tasks search(query) returns, without running it
+ * \@param query The search text
+ * \@return Length of the shortest posting list among the query's terms
+ */
+size_t TaskTable::searchEstimate(const std::string& query) {
+    buildSearchIndex();
+    return searchIndex.estimate(query);
+}
+
+/**
+ * \@brief The rows of the live tasks whose created or updated time is in [low, high)
+ * Walks the index entries in range and skips the stale ones (deleted tasks, or
+ * an updatedAt that has moved on)
+ * \@param field The timestamp to range over
+ * \@param low Inclusive lower bound (a TimeIndex::keyOf key)
+ * \@param high Exclusive upper bound
+ * \@return Row numbers in time order (valid until the table is next modified)
+ */
+std::vector<size_t> TaskTable::rowsInTimeRange(TimeField field, long long low, long long high) {
+    const TimeEntry* first;
+    const TimeEntry* last;
+    timeIndex(field).range(low, high, first, last);
+    const std::vector<std::chrono::system_clock::time_point>& times = field == TimeField::CREATED ? createdTimes : updatedTimes;
+    std::vector<size_t> rows;
+    rows.reserve(static_cast<size_t>(last - first));
+    for (const TimeEntry* entry = first; entry != last; ++entry) {
+        auto it = rowsById.find(entry->id);
+        if (it != rowsById.end() && TimeIndex::keyOf(times[it->second]) == entry->key) {
+            rows.push_back(it->second);
+        }
+    }
+    return rows;
+}
+
+/**
+ * \@brief Upper bound on the number of rows rowsInTimeRange returns, in O(log N)
+ * \@return Index entries in range, stale ones included
+ */
+size_t TaskTable::timeRangeEstimate(TimeField field, long long low, long long high) {
+    const TimeEntry* first;
+    const TimeEntry* last;
+    timeIndex(field).range(low, high, first, last);
+    return static_cast<size_t>(last - first);
+}
+
+/**
+ * \@brief The index for a field, built on first use and rebuilt once mostly stale
+ */
+TimeIndex& TaskTable::timeIndex(TimeField field) {
+    if (!timeIndexesBuilt) {
+        rebuildTimeIndex(TimeField::CREATED);
+        rebuildTimeIndex(TimeField::UPDATED);
+        timeIndexesBuilt = true;
+    }
+    TimeIndex& index = field == TimeField::CREATED ? createdIndex : updatedIndex;
+    if (index.needsRebuild()) {
+        rebuildTimeIndex(field);
+    }
+    return index;
+}
+
+/**
+ * \@brief Re-indexes one timestamp column over the live rows
+ */
+void TaskTable::rebuildTimeIndex(TimeField field) {
+    TimeIndex& index = field == TimeField::CREATED ? createdIndex : updatedIndex;
+    const std::vector<std::chrono::system_clock::time_point>& times = field == TimeField::CREATED ? createdTimes : updatedTimes;
+    index.reset(size());
+    for (size_t row = 0; row < ids.size(); ++row) {
+        if (isLive(row)) {
+            index.add(TimeIndex::keyOf(times[row]), ids[row]);
+        }
+    }
+}
+
+/**
+ * \@brief Notes that a deleted task's entries in both time indexes are now stale
+ */
+void TaskTable::retireTimeEntries() {
+    if (timeIndexesBuilt) {
+        createdIndex.markStale();
+        updatedIndex.markStale();
+    }
+}
+
+/**
+ * \@brief Moves a row's updated-index entry to its new time (call before storing it)
+ */
+void TaskTable::noteUpdated(size_t row, std::chrono::system_clock::time_point updatedAt) {
+    if (timeIndexesBuilt && updatedAt != updatedTimes[row]) {
+        updatedIndex.markStale();
+        updatedIndex.add(TimeIndex::keyOf(updatedAt), ids[row]);
+    }
+}
+
+/**
+ * \@brief Indexes every live description, the first time something searches
+ */
+void TaskTable::buildSearchIndex() {
+    if (searchIndexBuilt) {
+        return;
+    }
+    std::string description;
+    for (size_t row = 0; row < ids.size(); ++row) {
+        if (!isLive(row)) {
+            continue;
+        }
+        TextRef text = descriptionAt(row);
+        description.assign(text.data, text.size);
+        searchIndex.add(ids[row], description);
+    }
+    searchIndexBuilt = true;
+}
+
+/**
+ * \@brief Appends a description to the arena and records its slice for the newest row
+ */
+void TaskTable::appendDescription(const std::string& description) {
+    descriptionOffsets.push_back(arena.size());
+    descriptionLengths.push_back(static_cast<uint32_t>(description.size()));
+    arena += description;
+}
+
+/**
+ * \@brief Rewrites the arena without unreferenced text once enough has piled up
+ * Copies the live descriptions in row order, so the cost is amortized over
+ * the updates and deletes that produced the garbage
+ */
+void TaskTable::compactArena() {
+    if (arenaGarbage < ARENA_COMPACT_MIN_GARBAGE || arenaGarbage * 2 < arena.size()) {
+        return;
+    }
+    std::string compacted;
+    compacted.reserve(arena.size() - arenaGarbage);
+    for (size_t row = 0; row < ids.size(); ++row) {
+        uint64_t offset = compacted.size(); // Tombstones have length 0 and copy nothing
+        compacted.append(arena, descriptionOffsets[row], descriptionLengths[row]);
+        descriptionOffsets[row] = offset;
+    }
+    arena.swap(compacted);
+    arenaGarbage = 0;
+}
+
+/**
+ * \@brief Turns a live row into a tombstone (its id and search entries must already be gone)
+ * The description's arena bytes become garbage
+ */
+void TaskTable::markDeleted(size_t row) {
+    --statusCounts[statuses[row]];
+    arenaGarbage += descriptionLengths[row];
+    descriptionLengths[row] = 0;
+    statuses[row] = DELETED_STATUS;
+    ++tombstones;
+}
+
+/**
+ * \@brief Compacts once the tombstones pass the TOMBSTONE_COMPACT_* threshold
+ */
+void TaskTable::compactIfWorthIt() {
+    if (tombstones >= TOMBSTONE_COMPACT_MIN && tombstones * TOMBSTONE_COMPACT_DIVISOR > ids.size()) {
+        compact();
+    }
+}
@@ -0,0 +1,67 @@
+#include "time_index.h"
+#include <vector>
+#include <algorithm> // For std::sort, std::inplace_merge, std::lower_bound
+
+/**
+ * \@brief Orders entries by time, then by id
+ */
+static bool entryLess(const TimeEntry& a, const TimeEntry& b) {
+    return a.key != b.key ? a.key < b.key : a.id < b.id;
+}
+
+/**
+ * \@brief Adds an entry
+ * An entry at or after the newest one keeps the array sorted; an older one
+ * (an imported task, or a clock step back) waits to be sorted in by the next lookup
+ */
+void TimeIndex::add(long long key, int id) {
+    TimeEntry entry = { key, id };
+    bool inOrder = sortedCount == entries.size() && (entries.empty() || !entryLess(entry, entries.back()));
+    entries.push_back(entry);
+    if (inOrder) {
+        sortedCount = entries.size();
+    }
+}
+
+/**
+ * \@brief Drops every entry (before a rebuild)
+ * \@param capacity Entries to reserve room for
+ */
+void TimeIndex::reset(size_t capacity) {
+    entries.clear();
+    entries.reserve(capacity);
+    sortedCount = 0;
+    stale = 0;
+}
+
+/**
+ * \@brief Sorts the out-of-order tail and merges it into the sorted part
+ * Costs O(t log t + N) for t pending entries; a freshly rebuilt index in
+ * insertion order is usually sorted already and costs one pass
+ */
+void TimeIndex::sortPending() {
+    if (sortedCount == entries.size()) {
+        return;
+    }
+    auto middle = entries.begin() + static_cast<std::ptrdiff_t>(sortedCount);
+    std::sort(middle, entries.end(), entryLess);
+    std::inplace_merge(entries.begin(), middle, entries.end(), entryLess);
+    sortedCount = entries.size();
+}
+
+/**
+ * \@brief The entries with low <= key < high, in time order, stale ones included
+ * Two binary searches, so the cost is O(log N) plus whatever the caller walks
+ * \@param low Inclusive lower bound
+ * \@param high Exclusive upper bound
+ * \@param first Output parameter: the first entry in range
+ * \@param last Output parameter: one past the last entry in range
+ */
+void TimeIndex::range(long long low, long long high, const TimeEntry*& first, const TimeEntry*& last) {
+    sortPending();
+    auto byKey = [](const TimeEntry& entry, long long key) { return entry.key < key; };
+    auto begin = std::lower_bound(entries.begin(), entries.end(), low, byKey);
+    auto end = high > low ? std::lower_bound(begin, entries.end(), high, byKey) : begin;
+    first = entries.data() + (begin - entries.begin());
+    last = entries.data() + (end - entries.begin());
+}
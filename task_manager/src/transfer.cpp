@@ -0,0 +1,478 @@
+#include "transfer.h"
+#include "task.h" // For Task, statusToString, stringToStatus
+#include "utils.h" // For generateNextId, getCurrentTimestamp, formatTimestamp, parseTimestamp
+#include "storage.h" // For parseTaskObject, recordTaskChange, recordTasksAddedFrom
+#include "json_text.h" // For appendJsonEscaped
+#include "stats.h" // For addBytesRead, addBytesWritten
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cstring> // For std::memchr
+#include <utility> // For std::move
+
+// Import reads the file this many bytes at a time; only the current chunk and
+// the unfinished record at its end are held in memory
+const size_t IMPORT_CHUNK_BYTES = 1 << 20;
+// Imported tasks are recorded one by one up to this many; past it, the rest are
+// recorded as one range of ids and the commit takes a checkpoint, which logs them
+// straight from the list (recorded changes would be a second copy of the tasks)
+const size_t IMPORT_RECORD_LIMIT = 4096;
+// Export output is written whenever the buffer grows past this size
+const size_t EXPORT_FLUSH_BYTES = 1 << 20;
+// Columns of an exported CSV file, in order
+const char* const CSV_HEADER = "id,description,status,createdAt,updatedAt\n";
+
+bool parseTransferFormat(const std::string& name, TransferFormat& format) {
+    if (name == "ndjson") {
+        format = TransferFormat::NDJSON;
+    } else if (name == "csv") {
+        format = TransferFormat::CSV;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+TransferFormat transferFormatForFile(const std::string& path) {
+    const std::string extension = ".csv";
+    bool isCsv = path.size() >= extension.size() &&
+                 path.compare(path.size() - extension.size(), extension.size(), extension) == 0;
+    return isCsv ? TransferFormat::CSV : TransferFormat::NDJSON;
+}
+
+// --- Import ---
+
+/**
+ * \@brief Finds the newline that ends the current record
+ * NDJSON records are single lines. A CSV record may continue across newlines
+ * inside a quoted field, so the quote state is carried from one call to the next
+ * \@param p Where to continue scanning
+ * \@param end One past the last byte read so far
+ * \@param format The record format
+ * \@param inQuotes In/out: whether p lies inside a quoted CSV field
+ * \@return The newline, or nullptr if the record is not complete yet
+ */
+static const char* findRecordEnd(const char* p, const char* end, TransferFormat format, bool& inQuotes) {
+    if (format == TransferFormat::NDJSON) {
+        return static_cast<const char*>(std::memchr(p, '\n', end - p));
+    }
+    for (; p < end; ++p) {
+        if (*p == '"') {
+            inQuotes = !inQuotes; // An escaped quote ("") toggles twice
+        } else if (*p == '\n' && !inQuotes) {
+            return p;
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * \@brief Splits one CSV record into its fields (RFC 4180 quoting)
+ * \@param data The record, without its line ending
+ * \@param size Length of the record
+ * \@param fields Output parameter: the unquoted fields (reuses its strings)
+ * \@return False if a quoted field is malformed
+ */
+static bool splitCsvRecord(const char* data, size_t size, std::vector<std::string>& fields) {
+    size_t count = 0;
+    const char* p = data;
+    const char* end = data + size;
+    while (true) {
+        if (fields.size() <= count) {
+            fields.emplace_back();
+        }
+        std::string& field = fields[count++];
+        field.clear();
+        if (p < end && *p == '"') {
+            ++p;
+            while (true) {
+                const char* quote = static_cast<const char*>(std::memchr(p, '"', end - p));
+                if (quote == nullptr) {
+                    return false; // Unterminated quoted field
+                }
+                field.append(p, quote - p);
+                p = quote + 1;
+                if (p < end && *p == '"') {
+                    field += '"'; // Doubled quote
+                    ++p;
+                } else {
+                    break;
+                }
+            }
+            if (p < end && *p != ',') {
+                return false; // Text after the closing quote
+            }
+        } else {
+            const char* comma = static_cast<const char*>(std::memchr(p, ',', end - p));
+            const char* fieldEnd = comma != nullptr ? comma : end;
+            field.assign(p, fieldEnd - p);
+            p = fieldEnd;
+        }
+        if (p >= end) {
+            break;
+        }
+        ++p; // Consume the comma
+    }
+    fields.resize(count);
+    return true;
+}
+
+/**
+ * \@brief Checks whether some text is empty or only whitespace
+ */
+static bool isBlank(const char* data, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+        if (data[i] != ' ' && data[i] != '\t' && data[i] != '\r' && data[i] != '\f' && data[i] != '\v') {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * \@brief Turns records into new tasks as the reader completes them
+ */
+template <typename Tasks>
+class RecordImporter {
+public:
+    RecordImporter(Tasks& tasks, TransferFormat format, const std::string& path, ImportResult& result)
+        : tasks(tasks), format(format), path(path), result(result), now(getCurrentTimestamp()) {}
+
+    /**
+     * \@brief Handles one record (without its newline)
+     * \@return False if reading should stop (a CSV file without a description column)
+     */
+    bool handle(const char* data, size_t size) {
+        ++recordNumber;
+        if (size > 0 && data[size - 1] == '\r') {
+            --size; // CRLF line ending
+        }
+        if (isBlank(data, size)) {
+            return true;
+        }
+        if (format == TransferFormat::CSV && !headerRead) {
+            return readHeader(data, size);
+        }
+
+        Task task;
+        bool parsed = format == TransferFormat::NDJSON ? parseJson(data, size, task) : parseCsv(data, size, task);
+        if (!parsed) {
+            return true; // Already reported
+        }
+        if (isBlank(task.description.data(), task.description.size())) {
+            skip("no description");
+            return true;
+        }
+        add(task);
+        return true;
+    }
+
+private:
+    /**
+     * \@brief Maps the CSV header's column names to the Task fields
+     */
+    bool readHeader(const char* data, size_t size) {
+        headerRead = true;
+        if (!splitCsvRecord(data, size, fields)) {
+            std::cerr << "Error: Malformed CSV header in '" << path << "'." << std::endl;
+            return false;
+        }
+        for (size_t i = 0; i < fields.size(); ++i) {
+            const std::string& name = fields[i];
+            if (name == "description") {
+                descriptionColumn = i;
+            } else if (name == "status") {
+                statusColumn = i;
+            } else if (name == "createdAt") {
+                createdColumn = i;
+            } else if (name == "updatedAt") {
+                updatedColumn = i;
+            } // Other columns (including id) are ignored
+        }
+        if (descriptionColumn == NO_COLUMN) {
+            std::cerr << "Error: '" << path << "' has no 'description' column in its header." << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * \@brief Parses an NDJSON record with the snapshot's object parser
+     * Missing timestamps are marked with time_point::min() and filled in by add
+     */
+    bool parseJson(const char* data, size_t size, Task& task) {
+        const char* pos = data;
+        const char* end = data + size;
+        while (pos < end && (*pos == ' ' || *pos == '\t')) {
+            ++pos;
+        }
+        if (pos >= end || *pos != '{') {
+            skip("not a JSON object");
+            return false;
+        }
+        task.createdAt = std::chrono::system_clock::time_point::min();
+        task.updatedAt = std::chrono::system_clock::time_point::min();
+        if (!parseTaskObject(pos, end, task, error, std::cerr, false)) {
+            skip(error.compare(0, 7, "Error: ") == 0 ? error.substr(7) : error);
+            return false;
+        }
+        if (!isBlank(pos, end - pos)) {
+            skip("text after the task object");
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * \@brief Parses a CSV record using the columns found in the header
+     */
+    bool parseCsv(const char* data, size_t size, Task& task) {
+        if (!splitCsvRecord(data, size, fields)) {
+            skip("malformed quoted field");
+            return false;
+        }
+        task.createdAt = std::chrono::system_clock::time_point::min();
+        task.updatedAt = std::chrono::system_clock::time_point::min();
+        if (descriptionColumn < fields.size()) {
+            task.description = std::move(fields[descriptionColumn]);
+        }
+        if (statusColumn < fields.size() && !fields[statusColumn].empty()) {
+            task.status = stringToStatus(fields[statusColumn]);
+        }
+        if (!readTimestamp(createdColumn, task.createdAt) || !readTimestamp(updatedColumn, task.updatedAt)) {
+            skip("invalid timestamp (expected YYYY-MM-DD HH:MM:SS)");
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * \@brief Reads an optional timestamp column; an absent or empty field leaves tp alone
+     */
+    bool readTimestamp(size_t column, std::chrono::system_clock::time_point& tp) const {
+        if (column >= fields.size() || fields[column].empty()) {
+            return true;
+        }
+        return parseTimestamp(fields[column].data(), fields[column].size(), tp);
+    }
+
+    /**
+     * \@brief Gives the task the next id and adds it, recording the change for the commit
+     */
+    void add(Task& task) {
+        if (task.createdAt == std::chrono::system_clock::time_point::min()) {
+            task.createdAt = now;
+        }
+        if (task.updatedAt == std::chrono::system_clock::time_point::min()) {
+            task.updatedAt = task.createdAt; // Never updated since it was created
+        }
+        task.id = generateNextId(tasks); // Ids from the other tracker are not kept
+        if (result.imported < IMPORT_RECORD_LIMIT) {
+            recordTaskChange(task);
+        } else if (result.imported == IMPORT_RECORD_LIMIT) {
+            recordTasksAddedFrom(task.id);
+        }
+        tasks.add(std::move(task));
+        ++result.imported;
+    }
+
+    /**
+     * \@brief Counts the current record as skipped and says why
+     */
+    void skip(const std::string& reason) {
+        ++result.skipped;
+        std::cerr << "Warning: Skipping record " << recordNumber << " of '" << path << "': " << reason << std::endl;
+    }
+
+    static const size_t NO_COLUMN = static_cast<size_t>(-1);
+
+    Tasks& tasks;
+    TransferFormat format;
+    const std::string& path;
+    ImportResult& result;
+    std::chrono::system_clock::time_point now; // Timestamp for records without one
+    size_t recordNumber = 0; // 1-based number of the current record, for warnings
+    std::string error; // Reused by parseTaskObject
+    std::vector<std::string> fields; // Reused CSV fields
+    bool headerRead = false;
+    size_t descriptionColumn = NO_COLUMN;
+    size_t statusColumn = NO_COLUMN;
+    size_t createdColumn = NO_COLUMN;
+    size_t updatedColumn = NO_COLUMN;
+};
+
+/**
+ * \@brief Adds every record of a file as a new task
+ * The file is read IMPORT_CHUNK_BYTES at a time into one buffer; complete records
+ * are handed to the importer in place and dropped from the buffer, so memory is
+ * bounded by the chunk size plus the longest record
+ * \@param tasks The list of tasks (will be modified)
+ * \@param path The file to read
+ * \@param format The file's record format
+ * \@param result Output parameter: how many records were imported and skipped
+ * \@return False if the file could not be read, or a CSV header has no description column
+ */
+template <typename Tasks>
+bool importTasks(Tasks& tasks, const std::string& path, TransferFormat format, ImportResult& result) {
+    std::ifstream input(path, std::ios::binary);
+    if (!input.is_open()) {
+        std::cerr << "Error: Could not open '" << path << "' for reading." << std::endl;
+        return false;
+    }
+
+    RecordImporter<Tasks> importer(tasks, format, path, result);
+    std::string buffer;
+    size_t scanned = 0; // Bytes of the unfinished record already searched for its end
+    bool inQuotes = false;
+    while (input) {
+        size_t kept = buffer.size();
+        buffer.resize(kept + IMPORT_CHUNK_BYTES);
+        input.read(&buffer[kept], static_cast<std::streamsize>(IMPORT_CHUNK_BYTES));
+        size_t got = static_cast<size_t>(input.gcount());
+        buffer.resize(kept + got);
+        addBytesRead(got);
+
+        const char* base = buffer.data();
+        const char* end = base + buffer.size();
+        const char* recordStart = base;
+        const char* newline = nullptr;
+        while ((newline = findRecordEnd(base + scanned, end, format, inQuotes)) != nullptr) {
+            if (!importer.handle(recordStart, static_cast<size_t>(newline - recordStart))) {
+                return false;
+            }
+            recordStart = newline + 1;
+            scanned = static_cast<size_t>(recordStart - base);
+        }
+        // Keep only the unfinished record; it has been searched to the end already
+        buffer.erase(0, static_cast<size_t>(recordStart - base));
+        scanned = buffer.size();
+    }
+    if (input.bad()) {
+        std::cerr << "Error: Failed to read '" << path << "'." << std::endl;
+        return false;
+    }
+    // The last record need not end with a newline
+    if (!buffer.empty() && !importer.handle(buffer.data(), buffer.size())) {
+        return false;
+    }
+    return true;
+}
+
+// --- Export ---
+
+/**
+ * \@brief Appends a CSV field, quoting it if it holds a comma, quote or line break
+ */
+static void appendCsvField(std::string& buffer, TextRef text) {
+    bool needsQuotes = false;
+    for (size_t i = 0; i < text.size && !needsQuotes; ++i) {
+        char c = text.data[i];
+        needsQuotes = c == ',' || c == '"' || c == '\n' || c == '\r';
+    }
+    if (!needsQuotes) {
+        buffer.append(text.data, text.size);
+        return;
+    }
+    buffer += '"';
+    const char* p = text.data;
+    const char* end = text.data + text.size;
+    while (const char* quote = static_cast<const char*>(std::memchr(p, '"', end - p))) {
+        buffer.append(p, quote + 1 - p);
+        buffer += '"'; // Double the quote
+        p = quote + 1;
+    }
+    buffer.append(p, end - p);
+    buffer += '"';
+}
+
+/**
+ * \@brief Appends one task as an NDJSON line (the format of tasks.log's "U" records)
+ */
+template <typename Tasks>
+static void appendJsonRecord(std::string& buffer, const Tasks& tasks, size_t row) {
+    char stamp[TIMESTAMP_BUFFER_SIZE];
+    buffer += "{\"id\": ";
+    buffer += std::to_string(tasks.idAt(row));
+    buffer += ", \"description\": \"";
+    TextRef description = tasks.descriptionAt(row);
+    appendJsonEscaped(buffer, description.data, description.size);
+    buffer += "\", \"status\": \"";
+    buffer += statusToString(tasks.statusAt(row));
+    buffer += "\", \"createdAt\": \"";
+    buffer.append(stamp, formatTimestamp(tasks.createdAtRow(row), stamp));
+    buffer += "\", \"updatedAt\": \"";
+    buffer.append(stamp, formatTimestamp(tasks.updatedAtRow(row), stamp));
+    buffer += "\"}\n";
+}
+
+/**
+ * \@brief Appends one task as a CSV record, in CSV_HEADER's column order
+ */
+template <typename Tasks>
+static void appendCsvRecord(std::string& buffer, const Tasks& tasks, size_t row) {
+    char stamp[TIMESTAMP_BUFFER_SIZE];
+    buffer += std::to_string(tasks.idAt(row));
+    buffer += ',';
+    appendCsvField(buffer, tasks.descriptionAt(row));
+    buffer += ',';
+    buffer += statusToString(tasks.statusAt(row));
+    buffer += ',';
+    buffer.append(stamp, formatTimestamp(tasks.createdAtRow(row), stamp));
+    buffer += ',';
+    buffer.append(stamp, formatTimestamp(tasks.updatedAtRow(row), stamp));
+    buffer += '\n';
+}
+
+/**
+ * \@brief Writes the buffer to the stream and empties it
+ */
+static void flushExport(std::string& buffer, std::ostream& out) {
+    out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    addBytesWritten(buffer.size());
+    buffer.clear();
+}
+
+/**
+ * \@brief Writes every live task to a stream, in insertion order
+ * Rows are formatted straight from the container's fields into one buffer, which
+ * is written out in EXPORT_FLUSH_BYTES pieces
+ * \@param tasks The list of tasks
+ * \@param format The record format
+ * \@param out Where to write (std::cout, or a file)
+ * \@return The number of tasks written
+ */
+template <typename Tasks>
+size_t exportTasks(const Tasks& tasks, TransferFormat format, std::ostream& out) {
+    std::string buffer;
+    buffer.reserve(EXPORT_FLUSH_BYTES + 4096);
+    if (format == TransferFormat::CSV) {
+        buffer += CSV_HEADER;
+    }
+    size_t written = 0;
+    for (size_t row = 0; row < tasks.slotCount(); ++row) {
+        if (!tasks.isLive(row)) {
+            continue; // Tombstone of a deleted task
+        }
+        if (format == TransferFormat::CSV) {
+            appendCsvRecord(buffer, tasks, row);
+        } else {
+            appendJsonRecord(buffer, tasks, row);
+        }
+        ++written;
+        if (buffer.size() >= EXPORT_FLUSH_BYTES) {
+            flushExport(buffer, out);
+        }
+    }
+    flushExport(buffer, out);
+    out.flush();
+    return written;
+}
+
+// --- Instantiations for both task representations ---
+template bool importTasks<TaskList>(TaskList&, const std::string&, TransferFormat, ImportResult&);
+template size_t exportTasks<TaskList>(const TaskList&, TransferFormat, std::ostream&);
+
+template bool importTasks<TaskTable>(TaskTable&, const std::string&, TransferFormat, ImportResult&);
+template size_t exportTasks<TaskTable>(const TaskTable&, TransferFormat, std::ostream&);
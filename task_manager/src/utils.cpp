@@ -1,54 +1,314 @@
-#include "utils.h"
-#include <vector>
-#include <algorithm> // For std::max_element
-#include <chrono> 
-#include <ctime> // For std::time_t, std::localtime, std::strftime 
-#include <iomanip> // For std::put_time (alternative formmating)
-#include <sstream> // For string stream formatting
-
-
-/**
- * \@brief Generates the next unique task ID
- * Finds the maximum existing ID and returns max + 1
- * Returns 1 if the task list is empty
- * \@param tasks The vector of existing tasks 
- * \@return The next available integer ID
- */
-int generateNextId(const std::vector<Task>& tasks) {
-    if (tasks.empty()) {
-        return 1; // Start IDs from 1 if the list is empty
-    }
-    // Find the task with the maximum ID 
-    auto maxIt = std::max_element(tasks.begin(), tasks.end(), 
-                                  [](const Task& a, const Task& b) {
-                                        return a.id < b.id;
-                                  });
-    return maxIt->id + 1; // Return the next ID
-}
-
-/**
- * \@brief Gets the current system time point
- * \@return A std::chrono::system_clock::time_point representing the current time
- */
-std::chrono::system_clock::time_point getCurrentTimestamp() {
-    return std::chrono::system_clock::now();
-}
-
-/**
- * \@brief Formats a time point into a string (YYYY-MM-DD HH:MM:SS)
- * \@param tp The time point to format 
- * \@return A formatted string representation of the timestamp
- */
-std::string formatTimestamp(const std::chrono::system_clock::time_point& tp) {
-    // Convert time_point to time_t 
-    std::time_t time = std::chrono::system_clock::to_time_t(tp);
-    // Convert time_t to tm (local time)
-    std::tm local_tm = *std::localtime(&time);
-
-    // Use stringstream and put_time for safer formatting
-    std::stringstream ss; 
-    // Format: YYYY-MM-DD HH:MM:SS
-    ss << std::put_time(&local_tm, "%Y-%m-%d %H:%M:%S");
-    return ss.str();
-
-}
+#include "utils.h"
+#include <vector>
+#include <chrono> 
+#include <ctime> // For std::time_t, localtime_r (offset lookups only)
+#include <string>
+
+
+/**
+ * \@brief Generates the next unique task ID
+ * Reads the list's persisted high-water mark in O(1); IDs of deleted
+ * tasks are never handed out again
+ * Returns 1 if no task was ever created
+ * \@param tasks The list of existing tasks 
+ * \@return The next available integer ID
+ */
+int generateNextId(const TaskList& tasks) {
+    return tasks.nextId(); // The counter starts at 1 and only grows
+}
+
+int generateNextId(const TaskTable& tasks) {
+    return tasks.nextId();
+}
+
+/**
+ * \@brief Gets the current system time point
+ * \@return A std::chrono::system_clock::time_point representing the current time
+ */
+std::chrono::system_clock::time_point getCurrentTimestamp() {
+    return std::chrono::system_clock::now();
+}
+
+// --- Fixed-format timestamp codec ---
+// "YYYY-MM-DD HH:MM:SS" in local time, converted by hand instead of through
+// iostreams/localtime/mktime. The UTC offset is looked up once per stretch of
+// time between two timezone transitions and cached.
+
+// Cached offset ranges are grown outwards in steps of this size until a transition is met.
+// Timezone transitions are months apart, so two of them cannot hide inside one step
+const std::time_t OFFSET_PROBE_STEP = 7 * 24 * 3600;
+// Limit on the steps per side, so a timezone without transitions (e.g. UTC) stops after about a year
+const int OFFSET_PROBE_MAX_STEPS = 53;
+
+/**
+ * \@brief Asks the C library for the UTC offset in effect at an instant
+ * \@param t Seconds since the epoch
+ * \@return Offset in seconds east of UTC
+ */
+static long systemUtcOffset(std::time_t t) {
+    std::tm local_tm;
+    if (localtime_r(&t, &local_tm) == nullptr) {
+        return 0;
+    }
+    return local_tm.tm_gmtoff;
+}
+
+/**
+ * \@brief Finds the exact second at which the offset changes between two instants
+ * \@param from An instant with offset fromOffset
+ * \@param to A later instant with a different offset
+ * \@param fromOffset The offset at from
+ * \@return The first second whose offset differs from fromOffset
+ */
+static std::time_t findTransition(std::time_t from, std::time_t to, long fromOffset) {
+    while (to - from > 1) {
+        std::time_t mid = from + (to - from) / 2;
+        if (systemUtcOffset(mid) == fromOffset) {
+            from = mid;
+        } else {
+            to = mid;
+        }
+    }
+    return to;
+}
+
+/**
+ * \@brief Per-thread cache of [begin, end) ranges of UTC time sharing one offset
+ * A handful of entries covers both standard and daylight time for timestamps
+ * spread over a few years
+ */
+struct UtcOffsetCache {
+    struct Range {
+        std::time_t begin;
+        std::time_t end;
+        long offset;
+    };
+    static const int SIZE = 8;
+    Range ranges[SIZE];
+    int count = 0;
+    int next = 0; // Round-robin replacement slot
+    int last = 0; // Most recent hit, checked first
+
+    /**
+     * \@brief Returns the UTC offset at an instant, consulting the system only on a miss
+     */
+    long offsetAt(std::time_t t) {
+        if (count > 0 && t >= ranges[last].begin && t < ranges[last].end) {
+            return ranges[last].offset;
+        }
+        for (int i = 0; i < count; ++i) {
+            if (t >= ranges[i].begin && t < ranges[i].end) {
+                last = i;
+                return ranges[i].offset;
+            }
+        }
+
+        // Miss: step outwards from t on each side and narrow down to the transition, if any
+        long offset = systemUtcOffset(t);
+        Range range;
+        range.offset = offset;
+        range.begin = t;
+        for (int step = 0; step < OFFSET_PROBE_MAX_STEPS; ++step) {
+            std::time_t probe = range.begin - OFFSET_PROBE_STEP;
+            if (systemUtcOffset(probe) != offset) {
+                range.begin = findTransitionBackward(range.begin, probe, offset);
+                break;
+            }
+            range.begin = probe;
+        }
+        range.end = t + 1;
+        for (int step = 0; step < OFFSET_PROBE_MAX_STEPS; ++step) {
+            std::time_t probe = range.end + OFFSET_PROBE_STEP;
+            if (systemUtcOffset(probe) != offset) {
+                range.end = findTransition(range.end - 1, probe, offset);
+                break;
+            }
+            range.end = probe;
+        }
+
+        last = next;
+        ranges[next] = range;
+        next = (next + 1) % SIZE;
+        if (count < SIZE) {
+            ++count;
+        }
+        return offset;
+    }
+
+private:
+    /**
+     * \@brief Finds the first second of the range that ends at later, searching back to earlier
+     * \@param later An instant with offset laterOffset
+     * \@param earlier An earlier instant with a different offset
+     * \@param laterOffset The offset at later
+     * \@return The earliest second after earlier from which the offset is laterOffset up to later
+     */
+    static std::time_t findTransitionBackward(std::time_t later, std::time_t earlier, long laterOffset) {
+        while (later - earlier > 1) {
+            std::time_t mid = earlier + (later - earlier) / 2;
+            if (systemUtcOffset(mid) == laterOffset) {
+                later = mid;
+            } else {
+                earlier = mid;
+            }
+        }
+        return later;
+    }
+};
+
+static thread_local UtcOffsetCache offsetCache;
+
+/**
+ * \@brief Days since 1970-01-01 for a proleptic Gregorian date (Howard Hinnant's algorithm)
+ */
+static long long daysFromCivil(long long y, unsigned m, unsigned d) {
+    y -= m <= 2;
+    const long long era = (y >= 0 ? y : y - 399) / 400;
+    const unsigned yoe = static_cast<unsigned>(y - era * 400);
+    const unsigned doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + static_cast<long long>(doe) - 719468;
+}
+
+/**
+ * \@brief Calendar date for a day count since 1970-01-01 (inverse of daysFromCivil)
+ */
+static void civilFromDays(long long z, long long& y, unsigned& m, unsigned& d) {
+    z += 719468;
+    const long long era = (z >= 0 ? z : z - 146096) / 146097;
+    const unsigned doe = static_cast<unsigned>(z - era * 146097);
+    const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const unsigned mp = (5 * doy + 2) / 153;
+    d = doy - (153 * mp + 2) / 5 + 1;
+    m = mp < 10 ? mp + 3 : mp - 9;
+    y = static_cast<long long>(yoe) + era * 400 + (m <= 2);
+}
+
+/**
+ * \@brief Writes a zero-padded two-digit number
+ */
+static inline void writeTwoDigits(char* out, unsigned value) {
+    out[0] = static_cast<char>('0' + value / 10);
+    out[1] = static_cast<char>('0' + value % 10);
+}
+
+/**
+ * \@brief Reads a fixed number of decimal digits
+ * \@return False if any character is not a digit
+ */
+static inline bool readDigits(const char* text, int digits, unsigned& value) {
+    value = 0;
+    for (int i = 0; i < digits; ++i) {
+        unsigned digit = static_cast<unsigned>(text[i] - '0');
+        if (digit > 9) {
+            return false;
+        }
+        value = value * 10 + digit;
+    }
+    return true;
+}
+
+/**
+ * \@brief Formats a time point into a caller-provided buffer (YYYY-MM-DD HH:MM:SS)
+ * \@param tp The time point to format
+ * \@param buffer Output buffer of at least TIMESTAMP_BUFFER_SIZE bytes; receives a NUL-terminated string
+ * \@return The number of characters written, excluding the NUL (TIMESTAMP_LENGTH)
+ */
+size_t formatTimestamp(const std::chrono::system_clock::time_point& tp, char* buffer) {
+    std::time_t time = std::chrono::system_clock::to_time_t(tp);
+    long long local = static_cast<long long>(time) + offsetCache.offsetAt(time);
+    long long days = local >= 0 ? local / 86400 : (local - 86399) / 86400;
+    unsigned secondsOfDay = static_cast<unsigned>(local - days * 86400);
+
+    long long year;
+    unsigned month, day;
+    civilFromDays(days, year, month, day);
+    if (year < 0 || year > 9999) {
+        year = year < 0 ? 0 : 9999; // Out of the format's range; clamp rather than overflow the buffer
+    }
+    unsigned y = static_cast<unsigned>(year);
+    buffer[0] = static_cast<char>('0' + y / 1000);
+    buffer[1] = static_cast<char>('0' + y / 100 % 10);
+    writeTwoDigits(buffer + 2, y % 100);
+    buffer[4] = '-';
+    writeTwoDigits(buffer + 5, month);
+    buffer[7] = '-';
+    writeTwoDigits(buffer + 8, day);
+    buffer[10] = ' ';
+    writeTwoDigits(buffer + 11, secondsOfDay / 3600);
+    buffer[13] = ':';
+    writeTwoDigits(buffer + 14, secondsOfDay / 60 % 60);
+    buffer[16] = ':';
+    writeTwoDigits(buffer + 17, secondsOfDay % 60);
+    buffer[TIMESTAMP_LENGTH] = '\0';
+    return TIMESTAMP_LENGTH;
+}
+
+/**
+ * \@brief Formats a time point into a string (YYYY-MM-DD HH:MM:SS)
+ * \@param tp The time point to format 
+ * \@return A formatted string representation of the timestamp
+ */
+std::string formatTimestamp(const std::chrono::system_clock::time_point& tp) {
+    char buffer[TIMESTAMP_BUFFER_SIZE];
+    return std::string(buffer, formatTimestamp(tp, buffer));
+}
+
+/**
+ * \@brief Parses a local "YYYY-MM-DD HH:MM:SS" timestamp without iostreams or mktime
+ * Characters after the 19th are ignored
+ * \@param text The characters to parse (need not be NUL-terminated)
+ * \@param length Number of characters available
+ * \@param tp Output parameter: the parsed time point
+ * \@return True on success, false if the text does not match the format
+ */
+bool parseTimestamp(const char* text, size_t length, std::chrono::system_clock::time_point& tp) {
+    unsigned year, month, day, hour, minute, second;
+    if (length < TIMESTAMP_LENGTH
+        || text[4] != '-' || text[7] != '-' || text[10] != ' ' || text[13] != ':' || text[16] != ':'
+        || !readDigits(text, 4, year) || !readDigits(text + 5, 2, month) || !readDigits(text + 8, 2, day)
+        || !readDigits(text + 11, 2, hour) || !readDigits(text + 14, 2, minute) || !readDigits(text + 17, 2, second)
+        || month < 1 || month > 12 || day < 1 || day > 31 || hour > 23 || minute > 59 || second > 60) {
+        return false;
+    }
+
+    // Seconds since the epoch as if the local time were UTC, then find the offset
+    // that maps back onto it (two rounds settle any DST boundary)
+    long long local = daysFromCivil(year, month, day) * 86400 + hour * 3600 + minute * 60 + second;
+    std::time_t time = static_cast<std::time_t>(local - offsetCache.offsetAt(static_cast<std::time_t>(local)));
+    long long offset = offsetCache.offsetAt(time);
+    if (static_cast<long long>(time) + offset != local) {
+        time = static_cast<std::time_t>(local - offset);
+    }
+    tp = std::chrono::system_clock::from_time_t(time);
+    return true;
+}
+
+/**
+ * \@brief Computes a CRC-32 (IEEE 802.3, as in zlib) over a buffer
+ * Table-driven, one byte at a time; the table is built on first use
+ * \@param data The bytes to checksum
+ * \@param length Number of bytes
+ * \@param crc The CRC of the bytes before these (0 to start)
+ * \@return The CRC of everything so far
+ */
+uint32_t crc32(const void* data, size_t length, uint32_t crc) {
+    static const std::vector<uint32_t> table = []() {
+        std::vector<uint32_t> entries(256);
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t value = i;
+            for (int bit = 0; bit < 8; ++bit) {
+                value = (value & 1) ? (value >> 1) ^ 0xEDB88320u : value >> 1;
+            }
+            entries[i] = value;
+        }
+        return entries;
+    }();
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    crc = ~crc;
+    for (size_t i = 0; i < length; ++i) {
+        crc = table[(crc ^ bytes[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}